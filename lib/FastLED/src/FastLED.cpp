@@ -1,5 +1,7 @@
 #define FASTLED_INTERNAL
 #include "FastLED.h"
+#include <stdlib.h>
+#include <string.h>
 
 /// @file FastLED.cpp
 /// Central source file for FastLED, implements the CFastLED class/object
@@ -8,6 +10,20 @@
 volatile uint32_t fuckit;
 #endif
 
+#if defined(FASTLED_ESP32) && !defined(FASTLED_NO_ASYNC_SHOW)
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+/// showAsync() hands frames to a FreeRTOS task
+#define FASTLED_ASYNC_SHOW_TASK
+#elif defined(FASTLED_HOST) && !defined(FASTLED_NO_ASYNC_SHOW)
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+/// showAsync() hands frames to a std::thread
+#define FASTLED_ASYNC_SHOW_THREAD
+#endif
+
 FASTLED_NAMESPACE_BEGIN
 
 /// Pointer to the matrix object when using the Smart Matrix Library
@@ -20,6 +36,19 @@ CLEDController *CLEDController::m_pHead = NULL;
 CLEDController *CLEDController::m_pTail = NULL;
 static uint32_t lastshow = 0;
 
+#if (FASTLED_FRAME_STATS == 1)
+/// Start timing a phase of show(), into a local named `t`
+#define FRAME_STATS_BEGIN(t) uint32_t t = micros()
+/// Add the time since FRAME_STATS_BEGIN(t) to a CTimingStats
+#define FRAME_STATS_END(stats, t) (stats).add(micros() - (t))
+/// Add the time since the end of the wait in beginFrame() to the frame statistics
+#define FRAME_STATS_SHOWN() m_FrameStats.show.add(micros() - lastshow)
+#else
+#define FRAME_STATS_BEGIN(t)
+#define FRAME_STATS_END(stats, t)
+#define FRAME_STATS_SHOWN()
+#endif
+
 /// Global frame counter, used for debugging ESP implementations
 /// @todo Include in FASTLED_DEBUG_COUNT_FRAME_RETRIES block?
 uint32_t _frame_cnt=0;
@@ -35,8 +64,14 @@ CFastLED::CFastLED() {
 	// m_nControllers = 0;
 	m_Scale = 255;
 	m_nFPS = 0;
+	m_nFrameMicros = 0;
+	m_bDithering = false;
 	m_pPowerFunc = NULL;
 	m_nPowerData = 0xFFFFFFFF;
+	m_bSkipUnchanged = false;
+	m_nRefreshMs = 0;
+	m_pShowCallback = NULL;
+	m_pShowCallbackArg = NULL;
 }
 
 CLEDController &CFastLED::addLeds(CLEDController *pLed,
@@ -52,26 +87,329 @@ CLEDController &CFastLED::addLeds(CLEDController *pLed,
 }
 
 void CFastLED::show(uint8_t scale) {
-	// guard against showing too rapidly
-	while(m_nMinMicros && ((micros()-lastshow) < m_nMinMicros));
-	lastshow = micros();
+	waitForShow();
+	beginFrame();
 
 	// If we have a function for computing power, use it!
 	if(m_pPowerFunc) {
+		FRAME_STATS_BEGIN(tPower);
 		scale = (*m_pPowerFunc)(scale, m_nPowerData);
+		FRAME_STATS_END(m_FrameStats.power, tPower);
+	}
+
+	uint32_t now = m_bSkipUnchanged ? millis() : 0;
+	CLEDController *pCur = CLEDController::head();
+	while(pCur) {
+		uint8_t d = pCur->getDither();
+		if(d == BINARY_DITHER && !m_bDithering) { pCur->setDither(DISABLE_DITHER); }
+		CLEDPowerAccount *pAccount = pCur->getPowerAccount();
+		uint8_t s = pAccount ? pAccount->limit_brightness(scale) : scale;
+		if(!m_bSkipUnchanged || pCur->frameChanged(s, now, m_nRefreshMs)) {
+			FRAME_STATS_BEGIN(tShow);
+			pCur->showLeds(s);
+			FRAME_STATS_END(pCur->m_ShowStats, tShow);
+		}
+		pCur->setDither(d);
+		pCur = pCur->next();
+	}
+	FRAME_STATS_SHOWN();
+	countFPS();
+}
+
+#if defined(FASTLED_ASYNC_SHOW_TASK) || defined(FASTLED_ASYNC_SHOW_THREAD)
+
+// The back buffer holds a copy of every controller's LED data, one after the
+// other, and gShowScale holds the brightness to show each controller at, or
+// -1 to skip it.
+static CRGB *gShowBuffer = NULL;
+static int gShowBufferLeds = 0;
+static int16_t *gShowScale = NULL;
+static int gShowControllers = 0;
+
+/// Make sure the back buffer has room for the current controllers
+static bool reserveShowBuffer(int nLeds, int nControllers) {
+	if(nLeds > gShowBufferLeds) {
+		CRGB *pBuffer = (CRGB*)realloc(gShowBuffer, nLeds * sizeof(CRGB));
+		if(pBuffer == NULL) { return false; }
+		gShowBuffer = pBuffer;
+		gShowBufferLeds = nLeds;
+	}
+	if(nControllers > gShowControllers) {
+		int16_t *pScale = (int16_t*)realloc(gShowScale, nControllers * sizeof(int16_t));
+		if(pScale == NULL) { return false; }
+		gShowScale = pScale;
+		gShowControllers = nControllers;
+	}
+	return true;
+}
+
+/// Background show task: waits for showAsync() to hand over a frame, writes it out
+struct CFastLEDShowTask {
+#if defined(FASTLED_ASYNC_SHOW_TASK)
+	static TaskHandle_t sTask;
+	static SemaphoreHandle_t sIdle;  // given while no frame is in flight
+
+	static void run(void *pArg) {
+		CFastLED *pFastLED = (CFastLED*)pArg;
+		for(;;) {
+			ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+			pFastLED->showBackBuffer();
+			if(pFastLED->m_pShowCallback) { (*pFastLED->m_pShowCallback)(pFastLED->m_pShowCallbackArg); }
+			xSemaphoreGive(sIdle);
+		}
+	}
+
+	// Start the task if needed, then wait until no frame is in flight
+	static bool begin(CFastLED *pFastLED) {
+		if(sTask == NULL) {
+			sIdle = xSemaphoreCreateBinary();
+			if(sIdle == NULL) { return false; }
+			// run on whichever core the caller isn't on, if there are two
+#if portNUM_PROCESSORS > 1
+			BaseType_t core = xPortGetCoreID() ^ 1;
+#else
+			BaseType_t core = tskNO_AFFINITY;
+#endif
+			if(xTaskCreatePinnedToCore(run, "FastLEDShow", 4096, pFastLED, configMAX_PRIORITIES - 2, &sTask, core) != pdPASS) {
+				vSemaphoreDelete(sIdle);
+				sIdle = NULL;
+				sTask = NULL;
+				return false;
+			}
+		} else {
+			xSemaphoreTake(sIdle, portMAX_DELAY);
+		}
+		return true;
+	}
+
+	static void start() { xTaskNotifyGive(sTask); }
+
+	static void cancel() { xSemaphoreGive(sIdle); }
+
+	static void wait() {
+		if(sTask != NULL) {
+			xSemaphoreTake(sIdle, portMAX_DELAY);
+			xSemaphoreGive(sIdle);
+		}
+	}
+#else
+	static std::thread sThread;
+	static std::mutex sLock;
+	static std::condition_variable sChanged;
+	static bool sBusy;  // a frame is in flight
+	static bool sStop;  // the thread should exit once it is idle
+
+	static void run(CFastLED *pFastLED) {
+		CHostClock::setBackgroundThread();
+		for(;;) {
+			{
+				std::unique_lock<std::mutex> lock(sLock);
+				sChanged.wait(lock, [] { return sBusy || sStop; });
+				if(!sBusy) { return; }
+			}
+			pFastLED->showBackBuffer();
+			if(pFastLED->m_pShowCallback) { (*pFastLED->m_pShowCallback)(pFastLED->m_pShowCallbackArg); }
+			{
+				std::lock_guard<std::mutex> lock(sLock);
+				sBusy = false;
+			}
+			sChanged.notify_all();
+		}
+	}
+
+	// Start the thread if needed, then wait until no frame is in flight
+	static bool begin(CFastLED *pFastLED) {
+		if(!sThread.joinable()) {
+			sThread = std::thread(run, pFastLED);
+		}
+		wait();
+		return true;
+	}
+
+	static void start() {
+		CHostClock::syncBackground();
+		{
+			std::lock_guard<std::mutex> lock(sLock);
+			sBusy = true;
+		}
+		sChanged.notify_all();
+	}
+
+	static void cancel() {}
+
+	static void wait() {
+		std::unique_lock<std::mutex> lock(sLock);
+		sChanged.wait(lock, [] { return !sBusy; });
+		CHostClock::joinBackground();
+	}
+
+	// Let the frame in flight finish, then end the thread
+	static void stop() {
+		if(sThread.joinable()) {
+			{
+				std::lock_guard<std::mutex> lock(sLock);
+				sStop = true;
+			}
+			sChanged.notify_all();
+			sThread.join();
+		}
+	}
+#endif
+};
+
+#if defined(FASTLED_ASYNC_SHOW_TASK)
+TaskHandle_t CFastLEDShowTask::sTask = NULL;
+SemaphoreHandle_t CFastLEDShowTask::sIdle = NULL;
+#else
+std::thread CFastLEDShowTask::sThread;
+std::mutex CFastLEDShowTask::sLock;
+std::condition_variable CFastLEDShowTask::sChanged;
+bool CFastLEDShowTask::sBusy = false;
+bool CFastLEDShowTask::sStop = false;
+
+/// Joins the show thread at exit. Defined after the statics the thread uses,
+/// so it is destroyed before them.
+static struct CFastLEDShowTaskStop {
+	~CFastLEDShowTaskStop() { CFastLEDShowTask::stop(); }
+} gShowTaskStop;
+#endif
+
+void CFastLED::showAsync(uint8_t scale) {
+	// begin() also waits for the previous frame, which still owns the back buffer
+	if(!CFastLEDShowTask::begin(this)) {
+		show(scale);
+		return;
 	}
 
+	int nLeds = 0, nControllers = 0;
 	CLEDController *pCur = CLEDController::head();
 	while(pCur) {
+		nLeds += pCur->size();
+		++nControllers;
+		pCur = pCur->next();
+	}
+	if(!reserveShowBuffer(nLeds, nControllers)) {
+		// out of memory: fall back to a synchronous show
+		CFastLEDShowTask::cancel();
+		show(scale);
+		return;
+	}
+
+	if(m_pPowerFunc) {
+		FRAME_STATS_BEGIN(tPower);
+		scale = (*m_pPowerFunc)(scale, m_nPowerData);
+		FRAME_STATS_END(m_FrameStats.power, tPower);
+	}
+
+	uint32_t now = m_bSkipUnchanged ? millis() : 0;
+	CRGB *pBack = gShowBuffer;
+	int16_t *pScale = gShowScale;
+	pCur = CLEDController::head();
+	while(pCur) {
+		// gate binary dithering as show() does, or it would defeat the skip check
 		uint8_t d = pCur->getDither();
-		if(m_nFPS < 100) { pCur->setDither(0); }
-		pCur->showLeds(scale);
+		if(d == BINARY_DITHER && !m_bDithering) { pCur->setDither(DISABLE_DITHER); }
+		CLEDPowerAccount *pAccount = pCur->getPowerAccount();
+		uint8_t s = pAccount ? pAccount->limit_brightness(scale) : scale;
+		*pScale++ = (!m_bSkipUnchanged || pCur->frameChanged(s, now, m_nRefreshMs)) ? s : -1;
 		pCur->setDither(d);
+		if(pCur->leds()) {
+			memcpy((void*)pBack, pCur->leds(), pCur->size() * sizeof(CRGB));
+		}
+		pBack += pCur->size();
 		pCur = pCur->next();
 	}
+
+	CFastLEDShowTask::start();
+}
+
+void CFastLED::showBackBuffer() {
+	// this spins the show task, not loop()
+	beginFrame();
+
+	const CRGB *pBack = gShowBuffer;
+	const int16_t *pScale = gShowScale;
+	CLEDController *pCur = CLEDController::head();
+	while(pCur) {
+		int16_t s = *pScale++;
+		if(s >= 0) {
+			uint8_t d = pCur->getDither();
+			if(d == BINARY_DITHER && !m_bDithering) { pCur->setDither(DISABLE_DITHER); }
+			FRAME_STATS_BEGIN(tShow);
+			pCur->show(pBack, pCur->size(), pCur->getAdjustment(s));
+			FRAME_STATS_END(pCur->m_ShowStats, tShow);
+			pCur->setDither(d);
+		}
+		pBack += pCur->size();
+		pCur = pCur->next();
+	}
+	FRAME_STATS_SHOWN();
 	countFPS();
 }
 
+void CFastLED::waitForShow() {
+	CFastLEDShowTask::wait();
+}
+
+#else
+
+void CFastLED::showAsync(uint8_t scale) {
+	show(scale);
+	if(m_pShowCallback) { (*m_pShowCallback)(m_pShowCallbackArg); }
+}
+
+void CFastLED::showBackBuffer() {
+}
+
+void CFastLED::waitForShow() {
+}
+
+#endif
+
+void CFastLED::setSkipUnchanged(bool skip, uint16_t refreshMs) {
+	m_bSkipUnchanged = skip;
+	m_nRefreshMs = refreshMs;
+	CLEDController *pCur = CLEDController::head();
+	while(pCur) {
+		pCur->invalidateFrame();
+		pCur = pCur->next();
+	}
+}
+
+bool CLEDController::frameChanged(uint8_t brightness, uint32_t now, uint16_t refreshMs) {
+	CRGB adj = getAdjustment(brightness);
+	if(m_DitherMode != DISABLE_DITHER && (adj.r != 255 || adj.g != 255 || adj.b != 255)) {
+		m_bFrameKnown = false;
+		return true;
+	}
+
+	// FNV-1a over the LED data, a word at a time, then the adjustment and dither mode
+	uint32_t hash = 2166136261UL;
+	const uint8_t *p = (const uint8_t*)m_Data;
+	uint32_t n = (uint32_t)m_nLeds * sizeof(CRGB);
+	for(; n >= 4; n -= 4, p += 4) {
+		uint32_t w;
+		memcpy(&w, p, sizeof(w));
+		hash = (hash ^ w) * 16777619UL;
+	}
+	for(; n; --n, ++p) {
+		hash = (hash ^ *p) * 16777619UL;
+	}
+	hash = (hash ^ ((uint32_t)adj.r | ((uint32_t)adj.g << 8) | ((uint32_t)adj.b << 16))) * 16777619UL;
+	hash = (hash ^ m_DitherMode) * 16777619UL;
+
+	if(m_bFrameKnown && hash == m_nFrameSignature &&
+	   !(refreshMs && (now - m_nLastShowMs) >= refreshMs)) {
+		++m_nSkipCount;
+		return false;
+	}
+
+	m_nFrameSignature = hash;
+	m_nLastShowMs = now;
+	m_bFrameKnown = true;
+	return true;
+}
+
 int CFastLED::count() {
     int x = 0;
 	CLEDController *pCur = CLEDController::head();
@@ -95,22 +433,27 @@ CLEDController & CFastLED::operator[](int x) {
 }
 
 void CFastLED::showColor(const struct CRGB & color, uint8_t scale) {
-	while(m_nMinMicros && ((micros()-lastshow) < m_nMinMicros));
-	lastshow = micros();
+	waitForShow();
+	beginFrame();
 
 	// If we have a function for computing power, use it!
 	if(m_pPowerFunc) {
+		FRAME_STATS_BEGIN(tPower);
 		scale = (*m_pPowerFunc)(scale, m_nPowerData);
+		FRAME_STATS_END(m_FrameStats.power, tPower);
 	}
 
 	CLEDController *pCur = CLEDController::head();
 	while(pCur) {
 		uint8_t d = pCur->getDither();
-		if(m_nFPS < 100) { pCur->setDither(0); }
+		if(d == BINARY_DITHER && !m_bDithering) { pCur->setDither(DISABLE_DITHER); }
+		FRAME_STATS_BEGIN(tShow);
 		pCur->showColor(color, scale);
+		FRAME_STATS_END(pCur->m_ShowStats, tShow);
 		pCur->setDither(d);
 		pCur = pCur->next();
 	}
+	FRAME_STATS_SHOWN();
 	countFPS();
 }
 
@@ -218,6 +561,73 @@ extern int noise_min;
 /// @todo Remove?
 extern int noise_max;
 
+void CFastLED::beginFrame() {
+	FRAME_STATS_BEGIN(tWait);
+	// guard against showing too rapidly
+#if defined(FASTLED_HOST)
+	// nothing moves virtual time on while spinning, so skip to the end of the wait
+	if(CHostClock::isVirtual() && m_nMinMicros && ((micros()-lastshow) < m_nMinMicros)) {
+		CHostClock::advanceMicros(m_nMinMicros - (micros()-lastshow));
+	}
+#endif
+	while(m_nMinMicros && ((micros()-lastshow) < m_nMinMicros));
+	uint32_t now = micros();
+	uint32_t interval = now - lastshow;
+	lastshow = now;
+#if (FASTLED_FRAME_STATS == 1)
+	m_FrameStats.wait.add(now - tWait);
+	m_FrameStats.addFrame(now);
+#endif
+
+	// Smooth the frame time with a 1/8 weight moving average, so that one slow
+	// frame doesn't switch dithering off. Long pauses between frames are clamped
+	// (to 10fps) so the average recovers quickly once frames come steadily again.
+	if(interval > 100000) { interval = 100000; }
+	if(m_nFrameMicros == 0) {
+		m_nFrameMicros = interval;
+	} else {
+		m_nFrameMicros = m_nFrameMicros - (m_nFrameMicros >> 3) + (interval >> 3);
+	}
+
+	if(m_bDithering) {
+		if(m_nFrameMicros > (1000000UL / FASTLED_DITHER_OFF_FPS)) { m_bDithering = false; }
+	} else {
+		if(m_nFrameMicros < (1000000UL / FASTLED_DITHER_ON_FPS)) { m_bDithering = true; }
+	}
+}
+
+#if (FASTLED_FRAME_STATS == 1)
+void CFastLED::resetFrameStats() {
+	m_FrameStats.reset();
+	CLEDController *pCur = CLEDController::head();
+	while(pCur) {
+		pCur->m_ShowStats.reset();
+		pCur = pCur->next();
+	}
+}
+
+/// Where the text written so far ends, or NULL once the buffer is full, so
+/// that the rest is only measured
+static char *frameStatsEnd(char *buf, int size, int len) { return len < size ? buf + len : NULL; }
+/// Room left in the buffer after the text written so far
+static int frameStatsRoom(int size, int len) { return len < size ? size - len : 0; }
+
+int CFastLED::formatFrameStats(char *buf, int size) {
+	int len = snprintf(buf, size, "frames: %lu\n", (unsigned long)m_FrameStats.getFrames());
+	len += m_FrameStats.interval.format(frameStatsEnd(buf, size, len), frameStatsRoom(size, len), "interval");
+	len += m_FrameStats.wait.format(frameStatsEnd(buf, size, len), frameStatsRoom(size, len), "wait");
+	len += m_FrameStats.power.format(frameStatsEnd(buf, size, len), frameStatsRoom(size, len), "power");
+	len += m_FrameStats.show.format(frameStatsEnd(buf, size, len), frameStatsRoom(size, len), "show");
+	int n = 0;
+	for(CLEDController *pCur = CLEDController::head(); pCur; pCur = pCur->next()) {
+		char label[16];
+		snprintf(label, sizeof(label), "controller %d", n++);
+		len += pCur->m_ShowStats.format(frameStatsEnd(buf, size, len), frameStatsRoom(size, len), label);
+	}
+	return len;
+}
+#endif
+
 void CFastLED::countFPS(int nFrames) {
 	static int br = 0;
 	static uint32_t lastframe = 0; // millis();
@@ -248,10 +658,13 @@ void CFastLED::setMaxRefreshRate(uint16_t refresh, bool constrain) {
 	}
 }
 
+#if !defined(FASTLED_HOST)
 /// Called at program exit when run in a desktop environment. 
 /// Extra C definition that some environments may need. 
 /// @returns 0 to indicate success
+/// @note Not on the host, where the C library's atexit() has to run the handlers
 extern "C" int atexit(void (* /*func*/ )()) { return 0; }
+#endif
 
 #ifdef FASTLED_NEEDS_YIELD
 extern "C" void yield(void) { }
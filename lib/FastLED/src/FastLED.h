@@ -216,6 +216,13 @@ enum EBlockChipsets {
 /// @returns the brightness scale, limited to max power
 typedef uint8_t (*power_func)(uint8_t scale, uint32_t data);
 
+/// Typedef for a function called when a frame started by CFastLED::showAsync()
+/// has been written out. On ESP32 this runs in the background show task, not
+/// in loop(), so keep it short. It runs before waitForShow() returns, so it
+/// must not call show() or showAsync() itself.
+/// @param pArg the argument passed to CFastLED::setShowCallback()
+typedef void (*show_callback)(void *pArg);
+
 /// High level controller interface for FastLED.
 /// This class manages controllers, global settings, and trackings such as brightness
 /// and refresh rates, and provides access functions for driving led data to controllers
@@ -226,9 +233,26 @@ class CFastLED {
 	// int m_nControllers;
 	uint8_t  m_Scale;         ///< the current global brightness scale setting
 	uint16_t m_nFPS;          ///< tracking for current frames per second (FPS) value
+	uint32_t m_nFrameMicros;  ///< smoothed time between frames, used to gate BINARY_DITHER
+	bool     m_bDithering;    ///< whether BINARY_DITHER is currently in effect @see isDithering()
 	uint32_t m_nMinMicros;    ///< minimum µs between frames, used for capping frame rates
 	uint32_t m_nPowerData;    ///< max power use parameter
 	power_func m_pPowerFunc;  ///< function for overriding brightness when using FastLED.show();
+	bool     m_bSkipUnchanged;  ///< skip controllers whose frame has not changed @see setSkipUnchanged()
+	uint16_t m_nRefreshMs;      ///< when skipping unchanged frames, write them out anyway after this many ms
+	show_callback m_pShowCallback;  ///< called when an asynchronous frame has been written out
+	void *m_pShowCallbackArg;       ///< argument for m_pShowCallback
+#if (FASTLED_FRAME_STATS == 1)
+	CFrameStats m_FrameStats;       ///< timings of recent frames @see getFrameStats()
+#endif
+
+	/// Write out the frame snapshotted by showAsync(). Runs in the background show task.
+	void showBackBuffer();
+	friend struct CFastLEDShowTask;
+
+	/// Wait out the minimum frame time, then update the smoothed frame time and
+	/// the BINARY_DITHER on/off state for the frame about to be written out.
+	void beginFrame();
 
 public:
 	CFastLED();
@@ -569,6 +593,17 @@ public:
 	/// @param milliwatts the max power draw desired, in milliwatts
 	inline void setMaxPowerInMilliWatts(uint32_t milliwatts) { m_pPowerFunc = &calculate_max_brightness_for_power_mW; m_nPowerData = milliwatts; }
 
+	/// Only write out controllers whose frame has changed since they were last shown.
+	/// A controller's frame is its LED data plus brightness, color correction,
+	/// color temperature and dither mode. Controllers that are dithering below
+	/// full scale (brightness, correction and temperature not all 255) are always
+	/// written out, since dithering changes the output from frame to frame.
+	/// @param skip true to skip unchanged controllers in show()
+	/// @param refreshMs write out unchanged frames anyway once this many ms have passed,
+	/// so that a glitched pixel does not stay wrong forever. 0 means never.
+	/// @see CLEDController::getSkipCount()
+	void setSkipUnchanged(bool skip, uint16_t refreshMs = 1000);
+
 	/// Update all our controllers with the current led colors, using the passed in brightness
 	/// @param scale the brightness value to use in place of the stored value
 	void show(uint8_t scale);
@@ -576,6 +611,28 @@ public:
 	/// Update all our controllers with the current led colors
 	void show() { show(m_Scale); }
 
+	/// Start writing out the current led colors, using the passed in brightness, and
+	/// return without waiting for it to finish. The LED data is copied to a back
+	/// buffer first, so the next frame can be drawn into the leds arrays while this
+	/// one is encoded and sent from a background task, on the other core on ESP32.
+	/// Waits for the previous asynchronous frame first if it is still being sent.
+	/// On platforms without a background task this is the same as show().
+	/// @param scale the brightness value to use in place of the stored value
+	/// @note Don't change controller settings (correction, dither, ...) while a frame is in flight
+	void showAsync(uint8_t scale);
+
+	/// Start writing out the current led colors in the background
+	/// @see showAsync(uint8_t)
+	void showAsync() { showAsync(m_Scale); }
+
+	/// Wait until the frame started by showAsync(), if any, has been written out
+	void waitForShow();
+
+	/// Set a function to call each time a frame started by showAsync() has been written out
+	/// @param callback the function to call, or NULL for none
+	/// @param pArg an argument to pass to the function
+	void setShowCallback(show_callback callback, void *pArg = NULL) { m_pShowCallback = callback; m_pShowCallbackArg = pArg; }
+
 	/// Clear the leds, wiping the local array of data. Optionally you can also
 	/// send the cleared data to the LEDs.
 	/// @param writeData whether or not to write out to the leds as well
@@ -611,9 +668,16 @@ public:
 
 	/// Set the dithering mode.  Sets the dithering mode for all added led strips, overriding
 	/// whatever previous dithering option those controllers may have had.
-	/// @param ditherMode what type of dithering to use, either BINARY_DITHER or DISABLE_DITHER
+	/// @param ditherMode what type of dithering to use: BINARY_DITHER, TEMPORAL_DITHER or DISABLE_DITHER
 	void setDither(uint8_t ditherMode = BINARY_DITHER);
 
+	/// Is BINARY_DITHER currently being applied? Dithering at a low frame rate shows up
+	/// as flicker, so controllers set to BINARY_DITHER are only dithered while show() is
+	/// being called faster than FASTLED_DITHER_ON_FPS, until it drops below
+	/// FASTLED_DITHER_OFF_FPS. Controllers set to TEMPORAL_DITHER are always dithered.
+	/// @returns true if BINARY_DITHER controllers are being dithered
+	bool isDithering() { return m_bDithering; }
+
 	/// Set the maximum refresh rate.  This is global for all leds.  Attempts to
 	/// call show() faster than this rate will simply wait.
 	/// @note The refresh rate defaults to the slowest refresh rate of all the leds added through addLeds().
@@ -633,6 +697,26 @@ public:
 	/// @returns the most recently computed FPS value
 	uint16_t getFPS() { return m_nFPS; }
 
+#if (FASTLED_FRAME_STATS == 1)
+	/// Get timings for the frames written out so far: time spent waiting for the
+	/// maximum refresh rate, computing power limits and writing out controllers, the
+	/// time between frames, and the start times of recent frames. The time for each
+	/// controller is in CLEDController::getShowStats(). Only with FASTLED_FRAME_STATS.
+	/// @returns the frame statistics
+	CFrameStats & getFrameStats() { return m_FrameStats; }
+
+	/// Clear the frame statistics, and those of every controller
+	void resetFrameStats();
+
+	/// Write the frame statistics as text, e.g. for Serial.print(): the frame
+	/// count, then one line per phase of show() and one per controller, in the
+	/// order they were added. See CTimingStats::format() for the line format.
+	/// @param buf the buffer to write to; 64 bytes per line is enough
+	/// @param size the size of the buffer; the text is cut short to fit
+	/// @returns the length of the whole text, as snprintf() does
+	int formatFrameStats(char *buf, int size);
+#endif
+
 	/// Get how many controllers have been registered
 	/// @returns the number of controllers (strips) that have been added with addLeds()
 	int count();
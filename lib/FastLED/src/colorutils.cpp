@@ -6,12 +6,139 @@
 
 #include <stdint.h>
 #include <math.h>
+#include <string.h>
 
 #include "FastLED.h"
 
 FASTLED_NAMESPACE_BEGIN
 
 
+#if !defined(__AVR__)
+// Packed-lane helpers.  Two 8-bit values are kept in the low bytes of the
+// two 16-bit lanes of a uint32_t (0x00AA00BB), so that one 32-bit multiply
+// or add works on both at once, with the same rounding as the lib8tion
+// scalar functions.  Not used on AVR, where 32-bit multiplies are slow.
+
+/// Turn a scale8() scale into the lane multiplier that gives the same result
+static inline uint16_t lane_scale8_factor( uint8_t scale)
+{
+#if (FASTLED_SCALE8_FIXED == 1)
+    return (uint16_t)scale + 1;
+#else
+    return scale;
+#endif
+}
+
+/// scale8() of both lanes, given a factor from lane_scale8_factor()
+static inline uint32_t lanes_scale8( uint32_t lanes, uint16_t factor)
+{
+    return ((lanes * factor) >> 8) & 0x00FF00FFUL;
+}
+
+/// qadd8() of both lanes
+static inline uint32_t lanes_qadd8( uint32_t a, uint32_t b)
+{
+    uint32_t sum = a + b;
+    uint32_t overflow = (sum >> 8) & 0x00010001UL;
+    return (sum | (overflow * 0xFF)) & 0x00FF00FFUL;
+}
+
+/// scale8_video() of both lanes, as nscale8x3_video() computes it
+static inline uint32_t lanes_scale8_video( uint32_t lanes, uint8_t scale)
+{
+    uint32_t nonzero = ((lanes + 0x00FF00FFUL) >> 8) & 0x00010001UL;
+    uint32_t scaled = ((lanes * scale) >> 8) & 0x00FF00FFUL;
+    return scale ? (scaled + nonzero) : 0;
+}
+
+/// blend8() of both lanes
+static inline uint32_t lanes_blend8( uint32_t a, uint32_t b, uint8_t amountOfB)
+{
+#if (FASTLED_BLEND_FIXED == 1) && (FASTLED_SCALE8_FIXED == 1)
+    // A*256 + B + (B-A)*amountOfB, which never leaves 0..65535
+    return (((a * (256 - (uint16_t)amountOfB)) + (b * ((uint16_t)amountOfB + 1))) >> 8) & 0x00FF00FFUL;
+#elif (FASTLED_BLEND_FIXED == 1)
+    return (((a * (255 - (uint16_t)amountOfB)) + (b * amountOfB)) >> 8) & 0x00FF00FFUL;
+#else
+    return (lanes_scale8( a, lane_scale8_factor( 255 - amountOfB))
+          + lanes_scale8( b, lane_scale8_factor( amountOfB))) & 0x00FF00FFUL;
+#endif
+}
+
+static inline uint32_t load_bytes32( const uint8_t* p)
+{
+    uint32_t w;
+    memcpy( &w, p, sizeof( w));
+    return w;
+}
+
+static inline void store_bytes32( uint8_t* p, uint32_t w)
+{
+    memcpy( p, &w, sizeof( w));
+}
+
+// Byte-stream kernels.  A CRGB array is just 3*N bytes that all get the
+// same treatment, so these walk it four bytes at a time, as the even and
+// the odd bytes of a 32-bit word, with a byte-wise tail.  Where the
+// compiler has SSE2 or NEON to vectorize the byte-wise loop on its own,
+// that beats the 32-bit words by about 2.5x, so the words are skipped
+// (see tests/bench_lanes.cpp).  The byte-wise loops use the lane helpers
+// on a single lane, so both ways give the same results.
+#if defined(__SSE2__) || defined(__ARM_NEON)
+#define BYTES_AUTO_VECTORIZE 1
+#else
+#define BYTES_AUTO_VECTORIZE 0
+#endif
+
+static void bytes_nscale8( uint8_t* p, uint32_t n, uint8_t scale)
+{
+    const uint16_t factor = lane_scale8_factor( scale);
+#if !BYTES_AUTO_VECTORIZE
+    for( ; n >= 4; n -= 4, p += 4) {
+        uint32_t w = load_bytes32( p);
+        uint32_t even = lanes_scale8( w & 0x00FF00FFUL, factor);
+        uint32_t odd  = lanes_scale8( (w >> 8) & 0x00FF00FFUL, factor);
+        store_bytes32( p, even | (odd << 8));
+    }
+#endif
+    for( ; n; --n, ++p) {
+        *p = (uint8_t)lanes_scale8( *p, factor);
+    }
+}
+
+static void bytes_nscale8_video( uint8_t* p, uint32_t n, uint8_t scale)
+{
+#if !BYTES_AUTO_VECTORIZE
+    for( ; n >= 4; n -= 4, p += 4) {
+        uint32_t w = load_bytes32( p);
+        uint32_t even = lanes_scale8_video( w & 0x00FF00FFUL, scale);
+        uint32_t odd  = lanes_scale8_video( (w >> 8) & 0x00FF00FFUL, scale);
+        store_bytes32( p, even | (odd << 8));
+    }
+#endif
+    for( ; n; --n, ++p) {
+        *p = (uint8_t)lanes_scale8_video( *p, scale);
+    }
+}
+
+static void bytes_blend8( uint8_t* dest, const uint8_t* a, const uint8_t* b, uint32_t n, uint8_t amountOfB)
+{
+#if !BYTES_AUTO_VECTORIZE
+    for( ; n >= 4; n -= 4, dest += 4, a += 4, b += 4) {
+        uint32_t wa = load_bytes32( a);
+        uint32_t wb = load_bytes32( b);
+        uint32_t even = lanes_blend8( wa & 0x00FF00FFUL, wb & 0x00FF00FFUL, amountOfB);
+        uint32_t odd  = lanes_blend8( (wa >> 8) & 0x00FF00FFUL, (wb >> 8) & 0x00FF00FFUL, amountOfB);
+        store_bytes32( dest, even | (odd << 8));
+    }
+#endif
+    for( ; n; --n, ++dest, ++a, ++b) {
+        *dest = (uint8_t)lanes_blend8( *a, *b, amountOfB);
+    }
+}
+#endif
+
+
 
 void fill_solid( struct CRGB * targetArray, int numToFill,
                  const struct CRGB& color)
@@ -215,9 +342,13 @@ void fill_gradient_RGB( CRGB* leds, uint16_t numLeds, const CRGB& c1, const CRGB
 
 void nscale8_video( CRGB* leds, uint16_t num_leds, uint8_t scale)
 {
+#if !defined(__AVR__)
+    bytes_nscale8_video( (uint8_t*)leds, (uint32_t)num_leds * 3, scale);
+#else
     for( uint16_t i = 0; i < num_leds; ++i) {
         leds[i].nscale8_video( scale);
     }
+#endif
 }
 
 void fade_video(CRGB* leds, uint16_t num_leds, uint8_t fadeBy)
@@ -250,9 +381,13 @@ void nscale8_raw( CRGB* leds, uint16_t num_leds, uint8_t scale)
 
 void nscale8( CRGB* leds, uint16_t num_leds, uint8_t scale)
 {
+#if !defined(__AVR__)
+    bytes_nscale8( (uint8_t*)leds, (uint32_t)num_leds * 3, scale);
+#else
     for( uint16_t i = 0; i < num_leds; ++i) {
         leds[i].nscale8( scale);
     }
+#endif
 }
 
 void fadeUsingColor( CRGB* leds, uint16_t numLeds, const CRGB& colormask)
@@ -307,11 +442,23 @@ CRGB& nblend( CRGB& existing, const CRGB& overlay, fract8 amountOfOverlay )
 
 void nblend( CRGB* existing, CRGB* overlay, uint16_t count, fract8 amountOfOverlay)
 {
+#if !defined(__AVR__)
+    if( amountOfOverlay == 0) {
+        return;
+    }
+    if( amountOfOverlay == 255) {
+        memmove8( (void *) existing, overlay, (uint32_t)count * sizeof(CRGB));
+        return;
+    }
+    bytes_blend8( (uint8_t*)existing, (const uint8_t*)existing, (const uint8_t*)overlay,
+                  (uint32_t)count * 3, amountOfOverlay);
+#else
     for( uint16_t i = count; i; --i) {
         nblend( *existing, *overlay, amountOfOverlay);
         ++existing;
         ++overlay;
     }
+#endif
 }
 
 CRGB blend( const CRGB& p1, const CRGB& p2, fract8 amountOfP2 )
@@ -323,6 +470,13 @@ CRGB blend( const CRGB& p1, const CRGB& p2, fract8 amountOfP2 )
 
 CRGB* blend( const CRGB* src1, const CRGB* src2, CRGB* dest, uint16_t count, fract8 amountOfsrc2 )
 {
+#if !defined(__AVR__)
+    if( amountOfsrc2 != 0 && amountOfsrc2 != 255) {
+        bytes_blend8( (uint8_t*)dest, (const uint8_t*)src1, (const uint8_t*)src2,
+                      (uint32_t)count * 3, amountOfsrc2);
+        return dest;
+    }
+#endif
     for( uint16_t i = 0; i < count; ++i) {
         dest[i] = blend(src1[i], src2[i], amountOfsrc2);
     }
@@ -426,22 +580,79 @@ uint16_t XY( uint8_t, uint8_t);// __attribute__ ((weak));
 //         calls to 'blur' will also result in the light fading,
 //         eventually all the way to black; this is by design so that
 //         it can be used to (slowly) clear the LEDs to black.
-void blur1d( CRGB* leds, uint16_t numLeds, fract8 blur_amount)
+
+// blur_line reaches the pixels through an index functor, so that blur1d()
+// can walk a plain array and blur2d() can walk a row through its mapping
+// table without gathering it into a scratch copy first.
+struct blur_index_linear {
+    inline uint16_t operator()( uint16_t i) const { return i; }
+};
+
+struct blur_index_mapped {
+    const uint16_t* map;
+    inline uint16_t operator()( uint16_t i) const { return map[i]; }
+};
+
+// On AVR, where 32-bit multiplies are expensive, blur_line uses the
+// CRGB math; everywhere else it uses the packed-lane helpers.
+#if !defined(__AVR__)
+/// blur1d() on a run of pixels, using the lane kernels
+template<typename INDEX>
+static void blur_line( CRGB* leds, uint16_t numLeds, uint16_t keep, uint16_t seep, INDEX index)
+{
+    if( numLeds == 0) return;
+    uint32_t carry_rb = 0, carry_g = 0;
+    uint32_t prev_rb = 0, prev_g = 0;
+    for( uint16_t i = 0; i < numLeds; ++i) {
+        const CRGB& led = leds[index( i)];
+        uint32_t cur_rb = led.r | ((uint32_t)led.b << 16);
+        uint32_t cur_g  = led.g;
+        uint32_t part_rb = lanes_scale8( cur_rb, seep);
+        uint32_t part_g  = lanes_scale8( cur_g,  seep);
+        cur_rb = lanes_qadd8( lanes_scale8( cur_rb, keep), carry_rb);
+        cur_g  = lanes_qadd8( lanes_scale8( cur_g,  keep), carry_g);
+        if( i) {
+            // the previous pixel is final once this pixel's share is added
+            prev_rb = lanes_qadd8( prev_rb, part_rb);
+            prev_g  = lanes_qadd8( prev_g,  part_g);
+            leds[index( i-1)] = CRGB( (uint8_t)prev_rb, (uint8_t)prev_g, (uint8_t)(prev_rb >> 16));
+        }
+        prev_rb = cur_rb;
+        prev_g  = cur_g;
+        carry_rb = part_rb;
+        carry_g  = part_g;
+    }
+    leds[index( numLeds-1)] = CRGB( (uint8_t)prev_rb, (uint8_t)prev_g, (uint8_t)(prev_rb >> 16));
+}
+#else
+static inline uint8_t lane_scale8_factor( uint8_t scale)
+{
+    return scale;
+}
+
+template<typename INDEX>
+static void blur_line( CRGB* leds, uint16_t numLeds, uint8_t keep, uint8_t seep, INDEX index)
 {
-    uint8_t keep = 255 - blur_amount;
-    uint8_t seep = blur_amount >> 1;
     CRGB carryover = CRGB::Black;
     for( uint16_t i = 0; i < numLeds; ++i) {
-        CRGB cur = leds[i];
+        CRGB cur = leds[index( i)];
         CRGB part = cur;
         part.nscale8( seep);
         cur.nscale8( keep);
         cur += carryover;
-        if( i) leds[i-1] += part;
-        leds[i] = cur;
+        if( i) leds[index( i-1)] += part;
+        leds[index( i)] = cur;
         carryover = part;
     }
 }
+#endif
+
+void blur1d( CRGB* leds, uint16_t numLeds, fract8 blur_amount)
+{
+    uint8_t keep = 255 - blur_amount;
+    uint8_t seep = blur_amount >> 1;
+    blur_line( leds, numLeds, lane_scale8_factor( keep), lane_scale8_factor( seep), blur_index_linear());
+}
 
 void blur2d( CRGB* leds, uint8_t width, uint8_t height, fract8 blur_amount)
 {
@@ -495,6 +706,59 @@ void blurColumns(CRGB* leds, uint8_t width, uint8_t height, fract8 blur_amount)
     }
 }
 
+void fill_xymap( uint16_t* xymap, uint8_t width, uint8_t height)
+{
+    for( uint8_t y = 0; y < height; ++y) {
+        for( uint8_t x = 0; x < width; ++x) {
+            *xymap++ = XY( x, y);
+        }
+    }
+}
+
+// Columns blurred side by side in the table-mapped blur2d; the column pass
+// keeps one carry per column, so it is done in tiles of this many columns
+#define BLUR2D_TILE 32
+
+// blur2d through a mapping table: each row is blurred in place through its
+// slice of the table, then the columns are blurred row by row, one tile of
+// BLUR2D_TILE columns at a time, so the scratch space is a fixed
+// BLUR2D_TILE carries whatever the matrix width.  The result is the same
+// as blurRows() followed by blurColumns().
+void blur2d( CRGB* leds, uint8_t width, uint8_t height, fract8 blur_amount, const uint16_t* xymap)
+{
+    if( width == 0 || height == 0) return;
+
+    uint8_t keep = 255 - blur_amount;
+    uint8_t seep = blur_amount >> 1;
+
+    for( uint8_t row = 0; row < height; ++row) {
+        blur_index_mapped rowmap = { xymap + ((uint16_t)row * width) };
+        blur_line( leds, width, lane_scale8_factor( keep), lane_scale8_factor( seep), rowmap);
+    }
+
+    CRGB carryover[BLUR2D_TILE];
+    for( uint16_t col = 0; col < width; col += BLUR2D_TILE) {
+        uint8_t tile = (width - col < BLUR2D_TILE) ? (width - col) : BLUR2D_TILE;
+        const uint16_t* above = 0;
+        const uint16_t* rowmap = xymap + col;
+        for( uint8_t row = 0; row < height; ++row, rowmap += width) {
+            for( uint8_t i = 0; i < tile; ++i) {
+                CRGB cur = leds[rowmap[i]];
+                CRGB part = cur;
+                part.nscale8( seep);
+                cur.nscale8( keep);
+                if( above) {
+                    cur += carryover[i];
+                    leds[above[i]] += part;
+                }
+                leds[rowmap[i]] = cur;
+                carryover[i] = part;
+            }
+            above = rowmap;
+        }
+    }
+}
+
 
 
 // CRGB HeatColor( uint8_t temperature)
@@ -1223,6 +1487,47 @@ void nblendPaletteTowardPalette( CRGBPalette16& current, CRGBPalette16& target,
 }
 
 
+template <typename PALETTE>
+bool CRGBPaletteCache::rebuild( const PALETTE& pal, const CRGB* src, uint8_t count,
+                                uint8_t brightness, TBlendType blendType)
+{
+    const uint8_t bytes = count * sizeof(CRGB);
+    if( m_nSourceSize == count && m_Brightness == brightness && m_BlendType == blendType
+        && memcmp( m_Source, src, bytes) == 0) {
+        return false;
+    }
+
+    for( int i = 0; i < 256; ++i) {
+        entries[i] = ColorFromPalette( pal, (uint8_t)i, brightness, blendType);
+    }
+
+    memmove8( (void *) m_Source, src, bytes);
+    m_nSourceSize = count;
+    m_Brightness = brightness;
+    m_BlendType = blendType;
+    return true;
+}
+
+bool CRGBPaletteCache::update( const CRGBPalette16& pal, uint8_t brightness, TBlendType blendType)
+{
+    return rebuild( pal, pal.entries, 16, brightness, blendType);
+}
+
+bool CRGBPaletteCache::update( const CRGBPalette32& pal, uint8_t brightness, TBlendType blendType)
+{
+    return rebuild( pal, pal.entries, 32, brightness, blendType);
+}
+
+void CRGBPaletteCache::fillFromPalette( CRGB* L, uint16_t N, uint8_t startIndex, uint8_t incIndex) const
+{
+    uint8_t colorIndex = startIndex;
+    for( uint16_t i = 0; i < N; ++i) {
+        L[i] = entries[colorIndex];
+        colorIndex += incIndex;
+    }
+}
+
+
 uint8_t applyGamma_video( uint8_t brightness, float gamma)
 {
     float orig;
@@ -1268,6 +1573,23 @@ CRGB& napplyGamma_video( CRGB& rgb, float gammaR, float gammaG, float gammaB)
 
 void napplyGamma_video( CRGB* rgbarray, uint16_t count, float gamma)
 {
+#if !defined(__AVR__)
+    // The table takes 256 pow() calls to build, the per-pixel path three
+    // per pixel, so the table wins past 256 / 3 = 85 pixels.
+    if( count > (256 / 3)) {
+        uint8_t table[256];
+        for( uint16_t i = 0; i < 256; ++i) {
+            table[i] = applyGamma_video( (uint8_t)i, gamma);
+        }
+        for( uint16_t i = 0; i < count; ++i) {
+            CRGB& rgb = rgbarray[i];
+            rgb.r = table[rgb.r];
+            rgb.g = table[rgb.g];
+            rgb.b = table[rgb.b];
+        }
+        return;
+    }
+#endif
     for( uint16_t i = 0; i < count; ++i) {
         rgbarray[i] = applyGamma_video( rgbarray[i], gamma);
     }
@@ -1275,10 +1597,79 @@ void napplyGamma_video( CRGB* rgbarray, uint16_t count, float gamma)
 
 void napplyGamma_video( CRGB* rgbarray, uint16_t count, float gammaR, float gammaG, float gammaB)
 {
+#if !defined(__AVR__)
+    // Three tables take 768 pow() calls, so here it is 256 pixels.
+    if( count > 256) {
+        CRGBGammaTable table( gammaR, gammaG, gammaB);
+        table.apply( rgbarray, count);
+        return;
+    }
+#endif
     for( uint16_t i = 0; i < count; ++i) {
         rgbarray[i] = applyGamma_video( rgbarray[i], gammaR, gammaG, gammaB);
     }
 }
 
 
+CRGBGammaTable::CRGBGammaTable()
+{
+    setGamma( 1.0f);
+}
+
+CRGBGammaTable::CRGBGammaTable( float gamma)
+{
+    setGamma( gamma);
+}
+
+CRGBGammaTable::CRGBGammaTable( float gammaR, float gammaG, float gammaB)
+{
+    setGamma( gammaR, gammaG, gammaB);
+}
+
+void CRGBGammaTable::setGamma( float gamma)
+{
+    m_GammaR = m_GammaG = m_GammaB = gamma;
+    for( uint16_t i = 0; i < 256; ++i) {
+        r[i] = applyGamma_video( (uint8_t)i, gamma);
+    }
+    memmove8( g, r, sizeof( g));
+    memmove8( b, r, sizeof( b));
+}
+
+void CRGBGammaTable::setGamma( float gammaR, float gammaG, float gammaB)
+{
+    m_GammaR = gammaR;
+    m_GammaG = gammaG;
+    m_GammaB = gammaB;
+    for( uint16_t i = 0; i < 256; ++i) {
+        r[i] = applyGamma_video( (uint8_t)i, gammaR);
+        g[i] = applyGamma_video( (uint8_t)i, gammaG);
+        b[i] = applyGamma_video( (uint8_t)i, gammaB);
+    }
+}
+
+void CRGBGammaTable::setCorrection( const CRGB& correction, const CRGB& temperature, uint8_t scale)
+{
+    // start over from the plain gamma curves, so corrections don't stack
+    setGamma( m_GammaR, m_GammaG, m_GammaB);
+
+    CRGB adj = CLEDController::computeAdjustment( scale, correction, temperature);
+    for( uint16_t i = 0; i < 256; ++i) {
+        r[i] = scale8( r[i], adj.r);
+        g[i] = scale8( g[i], adj.g);
+        b[i] = scale8( b[i], adj.b);
+    }
+}
+
+void CRGBGammaTable::apply( CRGB* rgbarray, uint16_t count) const
+{
+    for( uint16_t i = 0; i < count; ++i) {
+        CRGB& rgb = rgbarray[i];
+        rgb.r = r[rgb.r];
+        rgb.g = g[rgb.g];
+        rgb.b = b[rgb.b];
+    }
+}
+
+
 FASTLED_NAMESPACE_END
@@ -452,6 +452,27 @@ void blurRows( CRGB* leds, uint8_t width, uint8_t height, fract8 blur_amount);
 /// @copydetails blurRows()
 void blurColumns(CRGB* leds, uint8_t width, uint8_t height, fract8 blur_amount);
 
+/// Two-dimensional blur filter, using a precomputed XY mapping table. 
+/// Gives the same result as blur2d(CRGB*, uint8_t, uint8_t, fract8),
+/// but looks pixel positions up in `xymap` instead of calling XY()
+/// for every pixel.  Columns are blurred in tiles of 32, so the only
+/// scratch space is 32 carries on the stack, whatever the width.
+/// @note Every (x, y) must map to a distinct LED, i.e. XY() must not
+/// return the same index for two positions.
+/// @param leds a pointer to the LED array to blur
+/// @param width the width of the matrix
+/// @param height the height of the matrix
+/// @param blur_amount the amount of blur to apply
+/// @param xymap `width * height` LED indexes in row-major order, see fill_xymap()
+void blur2d( CRGB* leds, uint8_t width, uint8_t height, fract8 blur_amount, const uint16_t* xymap);
+
+/// Fill a mapping table for blur2d(CRGB*, uint8_t, uint8_t, fract8, const uint16_t*)
+/// by calling XY() once for every position, in row-major order
+/// @param xymap array receiving `width * height` LED indexes
+/// @param width the width of the matrix
+/// @param height the height of the matrix
+void fill_xymap( uint16_t* xymap, uint8_t width, uint8_t height);
+
 /// @} ColorBlurs
 
 
@@ -2084,6 +2105,69 @@ void nblendPaletteTowardPalette( CRGBPalette16& currentPalette,
                                 CRGBPalette16& targetPalette,
                                 uint8_t maxChanges=24);
 
+
+/// A palette expanded into a 256-entry lookup table. 
+///
+/// ColorFromPalette() re-derives the palette entries, blends them and
+/// applies brightness for every call. When the same palette, brightness
+/// and blend type are used for many LEDs per frame, it is much cheaper
+/// to expand the palette once and then just index the table.
+///
+/// The cache keeps a copy of the source palette entries, so update()
+/// only rebuilds the table when the palette actually changed (e.g. after
+/// nblendPaletteTowardPalette() or UpscalePalette() wrote into it), or
+/// when the brightness or blend type differ from the last build.
+/// Every table entry is exactly what ColorFromPalette() would return.
+///
+/// @code{.cpp}
+/// CRGBPaletteCache cache;
+/// nblendPaletteTowardPalette( currentPalette, targetPalette);
+/// cache.update( currentPalette, brightness, LINEARBLEND);
+/// cache.fillFromPalette( leds, NUM_LEDS, startIndex, 3);
+/// @endcode
+class CRGBPaletteCache {
+public:
+    CRGB entries[256];  ///< expanded palette, one color per palette index
+
+    /// Create an empty cache; the first update() will always build the table
+    CRGBPaletteCache() : m_nSourceSize(0), m_Brightness(255), m_BlendType(NOBLEND) {}
+
+    /// Expand a palette into the table, if anything changed since the last build
+    /// @param pal the palette to expand
+    /// @param brightness brightness value used to scale the resulting colors
+    /// @param blendType whether to take the palette entries directly (NOBLEND)
+    /// or blend linearly between palette entries (LINEARBLEND)
+    /// @returns true if the table was rebuilt
+    bool update( const CRGBPalette16& pal, uint8_t brightness=255, TBlendType blendType=LINEARBLEND);
+    /// @copydoc update(const CRGBPalette16&, uint8_t, TBlendType)
+    bool update( const CRGBPalette32& pal, uint8_t brightness=255, TBlendType blendType=LINEARBLEND);
+
+    /// Force the next update() to rebuild the table
+    void invalidate() { m_nSourceSize = 0; }
+
+    /// Get the cached color for a palette index
+    inline const CRGB& operator[] (uint8_t index) const __attribute__((always_inline))
+    {
+        return entries[index];
+    }
+
+    /// Fill a range of LEDs from the cached table, as fill_palette() would
+    /// @param L pointer to the LED array to fill
+    /// @param N number of LEDs to fill in the array
+    /// @param startIndex the starting color index in the palette
+    /// @param incIndex how much to increment the palette color index per LED
+    void fillFromPalette( CRGB* L, uint16_t N, uint8_t startIndex, uint8_t incIndex) const;
+
+private:
+    template <typename PALETTE>
+    bool rebuild( const PALETTE& pal, const CRGB* src, uint8_t count, uint8_t brightness, TBlendType blendType);
+
+    CRGB m_Source[32];         ///< copy of the palette entries the table was built from
+    uint8_t m_nSourceSize;     ///< number of valid entries in m_Source, 0 if invalid
+    uint8_t m_Brightness;      ///< brightness the table was built with
+    TBlendType m_BlendType;    ///< blend type the table was built with
+};
+
 /// @} PaletteColors
 
 
@@ -2222,6 +2306,65 @@ void   napplyGamma_video( CRGB* rgbarray, uint16_t count, float gamma);
 /// @param gammaB the gamma value to apply to the CRGB::blue channel
 void   napplyGamma_video( CRGB* rgbarray, uint16_t count, float gammaR, float gammaG, float gammaB);
 
+
+/// Per-channel gamma lookup tables, for gamma adjusting whole LED arrays. 
+///
+/// The tables are computed once, with applyGamma_video(), when the gamma
+/// is set; apply() is then a plain table lookup per channel, with no
+/// floating point math. Results are identical to applyGamma_video().
+///
+/// Optionally, a color correction, color temperature and brightness can
+/// be folded into the same tables with setCorrection(), so that a single
+/// pass over the array applies all of them. The folded scaling is the
+/// same per-channel scale8() that the LED controllers apply on output, so
+/// only use it if those are left at UncorrectedColor / UncorrectedTemperature
+/// on the controller, or they will be applied twice.
+///
+/// @code{.cpp}
+/// CRGBGammaTable gamma( 2.2);
+/// gamma.apply( leds, NUM_LEDS);
+/// @endcode
+class CRGBGammaTable {
+public:
+    uint8_t r[256];  ///< lookup table for the red channel
+    uint8_t g[256];  ///< lookup table for the green channel
+    uint8_t b[256];  ///< lookup table for the blue channel
+
+    /// Create identity tables (gamma 1.0, no correction)
+    CRGBGammaTable();
+    /// Create tables for the same gamma on all channels
+    CRGBGammaTable( float gamma);
+    /// Create tables for a separate gamma per channel
+    CRGBGammaTable( float gammaR, float gammaG, float gammaB);
+
+    /// Rebuild the tables for the same gamma on all channels, removing any correction
+    void setGamma( float gamma);
+    /// Rebuild the tables for a separate gamma per channel, removing any correction
+    void setGamma( float gammaR, float gammaG, float gammaB);
+
+    /// Fold a color correction, color temperature and brightness into the tables. 
+    /// The combined per-channel scale is computed the same way as
+    /// CLEDController::computeAdjustment(), and applied after the gamma.
+    /// @param correction color correction, e.g. TypicalLEDStrip
+    /// @param temperature color temperature, e.g. Tungsten100W
+    /// @param scale brightness scale
+    void setCorrection( const CRGB& correction, const CRGB& temperature=CRGB(UncorrectedTemperature), uint8_t scale=255);
+
+    /// Gamma adjust a single color
+    inline CRGB apply( const CRGB& orig) const __attribute__((always_inline))
+    {
+        return CRGB( r[orig.r], g[orig.g], b[orig.b]);
+    }
+
+    /// Gamma adjust an LED array in place
+    /// @param rgbarray pointer to an LED array to apply an adjustment to (modified in place)
+    /// @param count the number of LEDs to modify
+    void apply( CRGB* rgbarray, uint16_t count) const;
+
+private:
+    float m_GammaR, m_GammaG, m_GammaB;  ///< gammas the tables were built from
+};
+
 /// @} GammaFuncs
 
 FASTLED_NAMESPACE_END
@@ -9,6 +9,9 @@
 #include "pixeltypes.h"
 #include "color.h"
 #include <stddef.h>
+#if (FASTLED_FRAME_STATS == 1)
+#include "frame_stats.h"
+#endif
 
 FASTLED_NAMESPACE_BEGIN
 
@@ -42,9 +45,15 @@ FASTLED_NAMESPACE_BEGIN
 
 /// Disable dithering
 #define DISABLE_DITHER 0x00
-/// Enable dithering using binary dithering (only option)
+/// Enable binary (ordered temporal) dithering while CFastLED::show() is being
+/// called fast enough for it not to flicker
+/// @see CFastLED::isDithering()
 #define BINARY_DITHER 0x01
-/// The dither setting, either DISABLE_DITHER or BINARY_DITHER
+/// Enable binary (ordered temporal) dithering regardless of the refresh rate.
+/// This is the same dither as BINARY_DITHER, only without the frame-rate gate;
+/// it is not error diffusion, which would need state for every LED.
+#define TEMPORAL_DITHER 0x02
+/// The dither setting, DISABLE_DITHER, BINARY_DITHER or TEMPORAL_DITHER
 typedef uint8_t EDitherMode;
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -53,6 +62,8 @@ typedef uint8_t EDitherMode;
 //
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+class CLEDPowerAccount;
+
 /// Base definition for an LED controller.  Pretty much the methods that every LED controller object will make available.
 /// If you want to pass LED controllers around to methods, make them references to this type, keeps your code saner. However,
 /// most people won't be seeing/using these objects directly at all.
@@ -67,6 +78,15 @@ protected:
     CRGB m_ColorTemperature;   ///< CRGB object representing the color temperature to apply to the strip on show() @see setTemperature
     EDitherMode m_DitherMode;  ///< the current dither mode of the controller
     int m_nLeds;               ///< the number of LEDs in the LED data array
+    CLEDPowerAccount *m_pPowerAccount;  ///< running power sums for the LED data, if any @see CLEDPowerAccount
+    uint32_t m_nFrameSignature;  ///< signature of the last frame written out @see frameChanged()
+    uint32_t m_nLastShowMs;      ///< millis() when the last frame was written out
+    uint32_t m_nSkipCount;       ///< number of show() calls skipped because nothing changed
+    bool m_bFrameKnown;          ///< true if m_nFrameSignature describes what the strip is showing
+    uint8_t m_nDitherPhase;      ///< position in the dither cycle, advanced once per frame written out
+#if (FASTLED_FRAME_STATS == 1)
+    CTimingStats m_ShowStats;    ///< time taken by each call to show() to write this controller out
+#endif
     static CLEDController *m_pHead;  ///< pointer to the first LED controller in the linked list
     static CLEDController *m_pTail;  ///< pointer to the last LED controller in the linked list
 
@@ -84,7 +104,8 @@ protected:
 
 public:
     /// Create an led controller object, add it to the chain of controllers
-    CLEDController() : m_Data(NULL), m_ColorCorrection(UncorrectedColor), m_ColorTemperature(UncorrectedTemperature), m_DitherMode(BINARY_DITHER), m_nLeds(0) {
+    CLEDController() : m_Data(NULL), m_ColorCorrection(UncorrectedColor), m_ColorTemperature(UncorrectedTemperature), m_DitherMode(BINARY_DITHER), m_nLeds(0), m_pPowerAccount(NULL),
+                       m_nFrameSignature(0), m_nLastShowMs(0), m_nSkipCount(0), m_bFrameKnown(false), m_nDitherPhase(0) {
         m_pNext = NULL;
         if(m_pHead==NULL) { m_pHead = this; }
         if(m_pTail != NULL) { m_pTail->m_pNext = this; }
@@ -107,6 +128,7 @@ public:
     /// @see show(const struct CRGB*, int, CRGB)
     void show(const struct CRGB *data, int nLeds, uint8_t brightness) {
         show(data, nLeds, getAdjustment(brightness));
+        invalidateFrame();
     }
 
     /// @copybrief showColor(const struct CRGB&, int, CRGB)
@@ -118,6 +140,7 @@ public:
     /// @see showColor(const struct CRGB&, int, CRGB)
     void showColor(const struct CRGB &data, int nLeds, uint8_t brightness) {
         showColor(data, nLeds, getAdjustment(brightness));
+        invalidateFrame();
     }
 
     /// Write the data to the LEDs managed by this controller
@@ -134,6 +157,7 @@ public:
     /// @see showColor(const struct CRGB&, int, CRGB)
     void showColor(const struct CRGB & data, uint8_t brightness=255) {
         showColor(data, m_nLeds, getAdjustment(brightness));
+        invalidateFrame();
     }
 
     /// Get the first LED controller in the linked list of controllers
@@ -186,6 +210,12 @@ public:
     /// @return the currently set dithering option (CLEDController::m_DitherMode)
     inline uint8_t getDither() { return m_DitherMode; }
 
+    /// Advance this controller's position in the dither cycle. Called once for
+    /// each frame written out, so that every controller steps through the
+    /// cycle at its own frame rate.
+    /// @returns the position to use for this frame
+    inline uint8_t nextDitherPhase() { return ++m_nDitherPhase; }
+
     /// The color corrction to use for this controller, expressed as a CRGB object
     /// @param correction the color correction to set
     /// @returns a reference to the controller
@@ -210,6 +240,44 @@ public:
     /// @returns the current color temperature (CLEDController::m_ColorTemperature)
     CRGB getTemperature() { return m_ColorTemperature; }
 
+    /// Attach running power sums for this controller's LED data. Normally
+    /// called through CLEDPowerAccount::attach(CLEDController&).
+    /// @param pAccount the power account, or NULL to go back to summing the LED data on every show()
+    /// @returns a reference to the controller
+    CLEDController & setPowerAccount(CLEDPowerAccount *pAccount) { m_pPowerAccount = pAccount; return *this; }
+
+    /// Get the power account attached to this controller
+    /// @returns the current power account (CLEDController::m_pPowerAccount), or NULL
+    CLEDPowerAccount *getPowerAccount() { return m_pPowerAccount; }
+
+    /// Check whether showLeds(brightness) would write out anything different
+    /// from the last frame, and if not, count a skip. The frame is identified
+    /// by a hash of the LED data plus the color adjustment and dither mode.
+    /// Frames are never skipped while dithering is in effect, since dithering
+    /// changes the output every frame.
+    /// @param brightness the brightness the frame would be shown at
+    /// @param now the current time, from millis()
+    /// @param refreshMs write out unchanged frames anyway once this many ms have passed, 0 for never
+    /// @returns true if the frame should be written out
+    bool frameChanged(uint8_t brightness, uint32_t now, uint16_t refreshMs);
+
+    /// Forget the last frame, so that the next show() writes out whatever is in the LED data
+    void invalidateFrame() { m_bFrameKnown = false; }
+
+    /// Get how many show() calls this controller has skipped because its frame had not changed
+    /// @returns the skip count (CLEDController::m_nSkipCount)
+    uint32_t getSkipCount() { return m_nSkipCount; }
+
+    /// Reset the skip count to zero
+    void resetSkipCount() { m_nSkipCount = 0; }
+
+#if (FASTLED_FRAME_STATS == 1)
+    /// Get the time taken to write this controller out from FastLED.show(), covering
+    /// both encoding the pixels and sending them. Only with FASTLED_FRAME_STATS.
+    /// @see CFastLED::getFrameStats()
+    CTimingStats & getShowStats() { return m_ShowStats; }
+#endif
+
     /// Get the combined brightness/color adjustment for this controller
     /// @param scale the brightness scale to get the correction for
     /// @returns a CRGB object representing the total adjustment, including color correction and color temperature
@@ -317,6 +385,18 @@ struct PixelController {
             initOffsets(len);
         }
 
+        /// Constructor
+        /// @param d pointer to LED data
+        /// @param len length of the LED data
+        /// @param s LED scale values, as CRGB struct
+        /// @param dither dither setting for the LEDs
+        /// @param ditherPhase the point in the dither cycle for this frame
+        PixelController(const CRGB *d, int len, CRGB & s, EDitherMode dither, uint8_t ditherPhase) : mData((const uint8_t*)d), mLen(len), mLenRemaining(len), mScale(s) {
+            enable_dithering(dither, ditherPhase);
+            mAdvance = 3;
+            initOffsets(len);
+        }
+
         /// Constructor
         /// @param d pointer to LED data
         /// @param len length of the LED data
@@ -328,6 +408,18 @@ struct PixelController {
             initOffsets(len);
         }
 
+        /// Constructor
+        /// @param d pointer to LED data
+        /// @param len length of the LED data
+        /// @param s LED scale values, as CRGB struct
+        /// @param dither dither setting for the LEDs
+        /// @param ditherPhase the point in the dither cycle for this frame
+        PixelController(const CRGB &d, int len, CRGB & s, EDitherMode dither, uint8_t ditherPhase) : mData((const uint8_t*)&d), mLen(len), mLenRemaining(len), mScale(s) {
+            enable_dithering(dither, ditherPhase);
+            mAdvance = 0;
+            initOffsets(len);
+        }
+
 
 #if !defined(NO_DITHERING) || (NO_DITHERING != 1)
 
@@ -368,13 +460,24 @@ struct PixelController {
 #endif
 
 
-        /// Set up the values for binary dithering
+        /// Set up the values for binary dithering, using a dither counter
+        /// shared by every PixelController of this type
+        /// @see init_binary_dithering(uint8_t)
         void init_binary_dithering() {
 #if !defined(NO_DITHERING) || (NO_DITHERING != 1)
             // R is the digther signal 'counter'.
             static uint8_t R = 0;
             ++R;
+            init_binary_dithering(R);
+#endif
+        }
 
+        /// Set up the values for binary dithering at a given point in the
+        /// dither cycle. This is done once per frame; stepDithering() then
+        /// only has to flip between the two values for each pixel.
+        /// @param R the dither signal counter, e.g. from CLEDController::nextDitherPhase()
+        void init_binary_dithering(uint8_t R) {
+#if !defined(NO_DITHERING) || (NO_DITHERING != 1)
             // R is wrapped around at 2^ditherBits,
             // so if ditherBits is 2, R will cycle through (0,1,2,3)
             uint8_t ditherBits = VIRTUAL_BITS;
@@ -436,7 +539,19 @@ struct PixelController {
         /// @param dither the dither setting
         void enable_dithering(EDitherMode dither) {
             switch(dither) {
-                case BINARY_DITHER: init_binary_dithering(); break;
+                case BINARY_DITHER:
+                case TEMPORAL_DITHER: init_binary_dithering(); break;
+                default: d[0]=d[1]=d[2]=e[0]=e[1]=e[2]=0; break;
+            }
+        }
+
+        /// @copybrief enable_dithering(EDitherMode)
+        /// @param dither the dither setting
+        /// @param phase the point in the dither cycle for this frame
+        void enable_dithering(EDitherMode dither, uint8_t phase) {
+            switch(dither) {
+                case BINARY_DITHER:
+                case TEMPORAL_DITHER: init_binary_dithering(phase); break;
                 default: d[0]=d[1]=d[2]=e[0]=e[1]=e[2]=0; break;
             }
         }
@@ -624,7 +739,7 @@ protected:
     /// @param nLeds the number of LEDs to set to this color
     /// @param scale the RGB scaling value for outputting color
     virtual void showColor(const struct CRGB & data, int nLeds, CRGB scale) {
-        PixelController<RGB_ORDER, LANES, MASK> pixels(data, nLeds, scale, getDither());
+        PixelController<RGB_ORDER, LANES, MASK> pixels(data, nLeds, scale, getDither(), nextDitherPhase());
         showPixels(pixels);
     }
 
@@ -633,7 +748,7 @@ protected:
     /// @param nLeds the number of LEDs being written out
     /// @param scale the RGB scaling to apply to each LED before writing it out
     virtual void show(const struct CRGB *data, int nLeds, CRGB scale) {
-        PixelController<RGB_ORDER, LANES, MASK> pixels(data, nLeds < 0 ? -nLeds : nLeds, scale, getDither());
+        PixelController<RGB_ORDER, LANES, MASK> pixels(data, nLeds < 0 ? -nLeds : nLeds, scale, getDither(), nextDitherPhase());
         if(nLeds < 0) {
             // nLeds < 0 implies that we want to show them in reverse
             pixels.mAdvance = -pixels.mAdvance;
@@ -69,6 +69,30 @@
 #define FASTLED_INTERRUPT_RETRY_COUNT 2
 #endif
 
+/// @def FASTLED_DITHER_ON_FPS
+/// With BINARY_DITHER, dithering is switched on once FastLED.show() is being called at
+/// more than this many frames per second...
+#ifndef FASTLED_DITHER_ON_FPS
+#define FASTLED_DITHER_ON_FPS 110
+#endif
+
+/// @def FASTLED_DITHER_OFF_FPS
+/// ...and switched off again when the frame rate drops below this. The gap between the two
+/// keeps a frame rate hovering around the threshold from flipping dithering on and off.
+#ifndef FASTLED_DITHER_OFF_FPS
+#define FASTLED_DITHER_OFF_FPS 90
+#endif
+
+/// @def FASTLED_FRAME_STATS
+/// Use this to time the phases of every FastLED.show() and keep a history of recent frame
+/// times, for tuning frame rates. See CFastLED::getFrameStats() and
+/// CFastLED::formatFrameStats(). Costs nothing when not defined.
+/// @warning This changes the layout of CFastLED and CLEDController, so it has to be set
+/// for the whole build, library included, never with a \#define in a sketch: with
+/// PlatformIO use `build_flags = -DFASTLED_FRAME_STATS=1`, with the host CMake build
+/// `-DFASTLED_FRAME_STATS=ON`. Defining it here also works.
+//#define FASTLED_FRAME_STATS 1
+
 /// @def FASTLED_USE_GLOBAL_BRIGHTNESS
 /// Use this toggle to enable global brightness in contollers that support is (e.g. ADA102 and SK9822).
 /// It changes how color scaling works and uses global brightness before scaling down color values.
@@ -86,6 +110,9 @@
 #define FASTLED_ALLOW_INTERRUPTS
 #define FASTLED_NOISE_ALLOW_AVERAGE_TO_OVERFLOW 0
 #define FASTLED_INTERRUPT_RETRY_COUNT 2
+#define FASTLED_DITHER_ON_FPS 110
+#define FASTLED_DITHER_OFF_FPS 90
+#define FASTLED_FRAME_STATS 1
 #define FASTLED_USE_GLOBAL_BRIGHTNESS 0
 #endif
 
@@ -0,0 +1,160 @@
+#ifndef __INC_FRAME_STATS_H
+#define __INC_FRAME_STATS_H
+
+/// @file frame_stats.h
+/// Optional timing instrumentation for FastLED.show(), enabled with FASTLED_FRAME_STATS
+/// @see CFastLED::getFrameStats(), CLEDController::getShowStats()
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+FASTLED_NAMESPACE_BEGIN
+
+/// Number of histogram buckets in a CTimingStats. Bucket `n` counts times
+/// of `2^(n-1)` to `2^n - 1` µs; the last bucket also takes everything longer.
+#define FASTLED_TIMING_BUCKETS 20
+
+#ifndef FASTLED_FRAME_HISTORY
+/// Number of recent frame start times kept by CFrameStats
+#define FASTLED_FRAME_HISTORY 32
+#endif
+
+/// Min/max/average and a power-of-two histogram of a series of times, in µs.
+/// Adding a sample is a handful of integer operations and takes no locks, so
+/// it can be done on every frame.
+class CTimingStats {
+    uint32_t m_nCount;    ///< number of samples
+    uint32_t m_nMin;      ///< shortest sample
+    uint32_t m_nMax;      ///< longest sample
+    uint64_t m_nTotal;    ///< sum of all samples
+    uint32_t m_nBuckets[FASTLED_TIMING_BUCKETS];  ///< histogram, see FASTLED_TIMING_BUCKETS
+
+public:
+    CTimingStats() { reset(); }
+
+    /// Forget all samples
+    void reset() {
+        m_nCount = 0;
+        m_nMin = 0xFFFFFFFF;
+        m_nMax = 0;
+        m_nTotal = 0;
+        memset(m_nBuckets, 0, sizeof(m_nBuckets));
+    }
+
+    /// Record one sample
+    /// @param us the time in µs
+    void add(uint32_t us) {
+        ++m_nCount;
+        m_nTotal += us;
+        if(us < m_nMin) { m_nMin = us; }
+        if(us > m_nMax) { m_nMax = us; }
+        uint8_t b = 0;
+        while(b < (FASTLED_TIMING_BUCKETS - 1) && (us >> b)) { ++b; }
+        ++m_nBuckets[b];
+    }
+
+    /// @returns the number of samples recorded
+    uint32_t getCount() const { return m_nCount; }
+    /// @returns the shortest sample, or 0 if there are none
+    uint32_t getMin() const { return m_nCount ? m_nMin : 0; }
+    /// @returns the longest sample
+    uint32_t getMax() const { return m_nMax; }
+    /// @returns the mean of the samples, or 0 if there are none
+    uint32_t getAvg() const { return m_nCount ? (uint32_t)(m_nTotal / m_nCount) : 0; }
+    /// @returns the sum of all samples
+    uint64_t getTotal() const { return m_nTotal; }
+    /// @returns the number of samples in histogram bucket `n`
+    uint32_t getBucket(uint8_t n) const { return n < FASTLED_TIMING_BUCKETS ? m_nBuckets[n] : 0; }
+
+    /// Estimate a percentile from the histogram. The result is the upper edge
+    /// of the bucket the percentile falls in (clamped to the longest sample),
+    /// so it is never less than the true value and at most about twice it.
+    /// @param pct the percentile, 0-100
+    /// @returns the estimate in µs, or 0 if there are no samples
+    uint32_t getPercentile(uint8_t pct) const {
+        if(m_nCount == 0) { return 0; }
+        if(pct > 100) { pct = 100; }
+        uint32_t target = (uint32_t)(((uint64_t)m_nCount * pct + 99) / 100);
+        if(target == 0) { target = 1; }
+        uint32_t seen = 0;
+        for(uint8_t b = 0; b < FASTLED_TIMING_BUCKETS - 1; ++b) {
+            seen += m_nBuckets[b];
+            if(seen >= target) {
+                uint32_t edge = (1UL << b) - 1;
+                return edge < m_nMax ? edge : m_nMax;
+            }
+        }
+        return m_nMax;
+    }
+
+    /// @returns the 99th percentile estimate @see getPercentile()
+    uint32_t getP99() const { return getPercentile(99); }
+
+    /// Write the count, min, average, 99th percentile and max as one line of
+    /// text, e.g. "show: n=100 min=95 avg=101 p99=127 max=130 us\n"
+    /// @param buf the buffer to write to, may be NULL if size is 0
+    /// @param size the size of the buffer; the text is cut short to fit
+    /// @param label the name the line starts with
+    /// @returns the length of the whole line, as snprintf() does
+    int format(char *buf, int size, const char *label) const {
+        return snprintf(buf, size, "%s: n=%lu min=%lu avg=%lu p99=%lu max=%lu us\n", label,
+                        (unsigned long)getCount(), (unsigned long)getMin(), (unsigned long)getAvg(),
+                        (unsigned long)getP99(), (unsigned long)getMax());
+    }
+};
+
+/// Timings for the phases of FastLED.show(), and the start times of recent frames.
+/// Times spent writing out each controller are kept by the controllers themselves.
+/// @see CLEDController::getShowStats()
+class CFrameStats {
+    uint32_t m_nHistory[FASTLED_FRAME_HISTORY];  ///< ring buffer of frame start times, in µs
+    uint32_t m_nFrames;                          ///< frames recorded since the last reset
+    uint16_t m_nHead;                            ///< next slot to write in m_nHistory
+
+public:
+    CTimingStats wait;      ///< time spent holding frames back to the maximum refresh rate
+    CTimingStats power;     ///< time spent computing power limits
+    CTimingStats show;      ///< time from the end of the wait to all controllers written out
+    CTimingStats interval;  ///< time between the starts of consecutive frames
+
+    CFrameStats() { reset(); }
+
+    /// Forget all timings and frame history
+    void reset() {
+        m_nFrames = 0;
+        m_nHead = 0;
+        wait.reset();
+        power.reset();
+        show.reset();
+        interval.reset();
+    }
+
+    /// Record the start of a frame
+    /// @param start micros() when the frame started
+    void addFrame(uint32_t start) {
+        if(m_nFrames) { interval.add(start - getFrameStart(0)); }
+        m_nHistory[m_nHead] = start;
+        if(++m_nHead == FASTLED_FRAME_HISTORY) { m_nHead = 0; }
+        ++m_nFrames;
+    }
+
+    /// @returns the number of frames recorded since the last reset
+    uint32_t getFrames() const { return m_nFrames; }
+
+    /// @returns how many frame start times are available from getFrameStart()
+    uint16_t getHistory() const { return m_nFrames < FASTLED_FRAME_HISTORY ? (uint16_t)m_nFrames : FASTLED_FRAME_HISTORY; }
+
+    /// Get the start time of a recent frame
+    /// @param ago 0 for the most recent frame, 1 for the one before, and so on, up to getHistory() - 1
+    /// @returns micros() at the start of that frame, or 0 if it is no longer kept
+    uint32_t getFrameStart(uint16_t ago) const {
+        if(ago >= getHistory()) { return 0; }
+        uint16_t i = (m_nHead + FASTLED_FRAME_HISTORY - 1 - ago) % FASTLED_FRAME_HISTORY;
+        return m_nHistory[i];
+    }
+};
+
+FASTLED_NAMESPACE_END
+
+#endif
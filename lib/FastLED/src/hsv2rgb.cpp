@@ -248,6 +248,64 @@ void hsv2rgb_spectrum( const struct CHSV& hsv, CRGB& rgb)
 #define K85  85
 /// @endcond
 
+/// Apply saturation and value to a fully saturated, full brightness
+/// rainbow color.  Shared by the single-pixel hsv2rgb_rainbow() and
+/// the table-driven batch version, so both stay bit-identical.
+static inline void hsv2rgb_rainbow_sat_val( uint8_t& r, uint8_t& g, uint8_t& b,
+                                            uint8_t sat, uint8_t val)
+{
+    // Scale down colors if we're desaturated at all
+    // and add the brightness_floor to r, g, and b.
+    if( sat != 255 ) {
+        if( sat == 0) {
+            r = 255; b = 255; g = 255;
+        } else {
+            uint8_t desat = 255 - sat;
+            desat = scale8_video( desat, desat);
+
+            uint8_t satscale = 255 - desat;
+            //satscale = sat; // uncomment to revert to pre-2021 saturation behavior
+
+            //nscale8x3_video( r, g, b, sat);
+#if (FASTLED_SCALE8_FIXED==1)
+            r = scale8_LEAVING_R1_DIRTY( r, satscale);
+            g = scale8_LEAVING_R1_DIRTY( g, satscale);
+            b = scale8_LEAVING_R1_DIRTY( b, satscale);
+            cleanup_R1();
+#else
+            if( r ) r = scale8( r, satscale) + 1;
+            if( g ) g = scale8( g, satscale) + 1;
+            if( b ) b = scale8( b, satscale) + 1;
+#endif
+            uint8_t brightness_floor = desat;
+            r += brightness_floor;
+            g += brightness_floor;
+            b += brightness_floor;
+        }
+    }
+    
+    // Now scale everything down if we're at value < 255.
+    if( val != 255 ) {
+        
+        val = scale8_video_LEAVING_R1_DIRTY( val, val);
+        if( val == 0 ) {
+            r=0; g=0; b=0;
+        } else {
+            // nscale8x3_video( r, g, b, val);
+#if (FASTLED_SCALE8_FIXED==1)
+            r = scale8_LEAVING_R1_DIRTY( r, val);
+            g = scale8_LEAVING_R1_DIRTY( g, val);
+            b = scale8_LEAVING_R1_DIRTY( b, val);
+            cleanup_R1();
+#else
+            if( r ) r = scale8( r, val) + 1;
+            if( g ) g = scale8( g, val) + 1;
+            if( b ) b = scale8( b, val) + 1;
+#endif
+        }
+    }
+}
+
 void hsv2rgb_rainbow( const CHSV& hsv, CRGB& rgb)
 {
     // Yellow has a higher inherent brightness than
@@ -407,56 +465,7 @@ void hsv2rgb_rainbow( const CHSV& hsv, CRGB& rgb)
     if( G2 ) g = g >> 1;
     if( Gscale ) g = scale8_video_LEAVING_R1_DIRTY( g, Gscale);
     
-    // Scale down colors if we're desaturated at all
-    // and add the brightness_floor to r, g, and b.
-    if( sat != 255 ) {
-        if( sat == 0) {
-            r = 255; b = 255; g = 255;
-        } else {
-            uint8_t desat = 255 - sat;
-            desat = scale8_video( desat, desat);
-
-            uint8_t satscale = 255 - desat;
-            //satscale = sat; // uncomment to revert to pre-2021 saturation behavior
-
-            //nscale8x3_video( r, g, b, sat);
-#if (FASTLED_SCALE8_FIXED==1)
-            r = scale8_LEAVING_R1_DIRTY( r, satscale);
-            g = scale8_LEAVING_R1_DIRTY( g, satscale);
-            b = scale8_LEAVING_R1_DIRTY( b, satscale);
-            cleanup_R1();
-#else
-            if( r ) r = scale8( r, satscale) + 1;
-            if( g ) g = scale8( g, satscale) + 1;
-            if( b ) b = scale8( b, satscale) + 1;
-#endif
-            uint8_t brightness_floor = desat;
-            r += brightness_floor;
-            g += brightness_floor;
-            b += brightness_floor;
-        }
-    }
-    
-    // Now scale everything down if we're at value < 255.
-    if( val != 255 ) {
-        
-        val = scale8_video_LEAVING_R1_DIRTY( val, val);
-        if( val == 0 ) {
-            r=0; g=0; b=0;
-        } else {
-            // nscale8x3_video( r, g, b, val);
-#if (FASTLED_SCALE8_FIXED==1)
-            r = scale8_LEAVING_R1_DIRTY( r, val);
-            g = scale8_LEAVING_R1_DIRTY( g, val);
-            b = scale8_LEAVING_R1_DIRTY( b, val);
-            cleanup_R1();
-#else
-            if( r ) r = scale8( r, val) + 1;
-            if( g ) g = scale8( g, val) + 1;
-            if( b ) b = scale8( b, val) + 1;
-#endif
-        }
-    }
+    hsv2rgb_rainbow_sat_val( r, g, b, sat, val);
     
     // Here we have the old AVR "missing std X+n" problem again
     // It turns out that fixing it winds up costing more than
@@ -476,9 +485,96 @@ void hsv2rgb_raw(const struct CHSV * phsv, struct CRGB * prgb, int numLeds) {
     }
 }
 
+/// @cond
+// Compile-time mirror of the hue section of hsv2rgb_rainbow(), using the
+// default Y1 yellow boost and no green scaling.  If you change Y1/Y2/G2/Gscale
+// above, change these too, or the batch conversion will no longer match.
+constexpr uint8_t rainbow_scale8( uint8_t i, uint8_t scale)
+{
+#if (FASTLED_SCALE8_FIXED == 1)
+    return (((uint16_t)i) * (1 + (uint16_t)(scale))) >> 8;
+#else
+    return ((uint16_t)i * (uint16_t)(scale)) >> 8;
+#endif
+}
+
+constexpr uint8_t rainbow_third( uint8_t hue)
+{
+    return rainbow_scale8( (uint8_t)((hue & 0x1F) << 3), (256 / 3));
+}
+
+constexpr uint8_t rainbow_twothirds( uint8_t hue)
+{
+    return rainbow_scale8( (uint8_t)((hue & 0x1F) << 3), ((256 * 2) / 3));
+}
+
+constexpr uint8_t rainbow_hue_r( uint8_t hue)
+{
+    return (hue >> 5) == 0 ? K255 - rainbow_third(hue)
+         : (hue >> 5) == 1 ? K171
+         : (hue >> 5) == 2 ? K171 - rainbow_twothirds(hue)
+         : (hue >> 5) == 3 ? 0
+         : (hue >> 5) == 4 ? 0
+         : (hue >> 5) == 5 ? rainbow_third(hue)
+         : (hue >> 5) == 6 ? K85 + rainbow_third(hue)
+         :                   K170 + rainbow_third(hue);
+}
+
+constexpr uint8_t rainbow_hue_g( uint8_t hue)
+{
+    return (hue >> 5) == 0 ? rainbow_third(hue)
+         : (hue >> 5) == 1 ? K85 + rainbow_third(hue)
+         : (hue >> 5) == 2 ? K170 + rainbow_third(hue)
+         : (hue >> 5) == 3 ? K255 - rainbow_third(hue)
+         : (hue >> 5) == 4 ? K171 - rainbow_twothirds(hue)
+         :                   0;
+}
+
+constexpr uint8_t rainbow_hue_b( uint8_t hue)
+{
+    return (hue >> 5) <= 2 ? 0
+         : (hue >> 5) == 3 ? rainbow_third(hue)
+         : (hue >> 5) == 4 ? K85 + rainbow_twothirds(hue)
+         : (hue >> 5) == 5 ? K255 - rainbow_third(hue)
+         : (hue >> 5) == 6 ? K171 - rainbow_third(hue)
+         :                   K85 - rainbow_third(hue);
+}
+
+#define RAINBOW_HUE1(h)   rainbow_hue_r(h), rainbow_hue_g(h), rainbow_hue_b(h)
+#define RAINBOW_HUE4(h)   RAINBOW_HUE1(h),      RAINBOW_HUE1((h)+1),  RAINBOW_HUE1((h)+2),   RAINBOW_HUE1((h)+3)
+#define RAINBOW_HUE16(h)  RAINBOW_HUE4(h),      RAINBOW_HUE4((h)+4),  RAINBOW_HUE4((h)+8),   RAINBOW_HUE4((h)+12)
+#define RAINBOW_HUE64(h)  RAINBOW_HUE16(h),     RAINBOW_HUE16((h)+16), RAINBOW_HUE16((h)+32), RAINBOW_HUE16((h)+48)
+/// @endcond
+
+/// Fully saturated, full brightness hsv2rgb_rainbow() output for every
+/// hue, as packed r,g,b triplets.  Generated at compile time.
+FL_PROGMEM static uint8_t const rainbow_hue_table[256 * 3] = {
+    RAINBOW_HUE64(0), RAINBOW_HUE64(64), RAINBOW_HUE64(128), RAINBOW_HUE64(192)
+};
+
+#undef RAINBOW_HUE1
+#undef RAINBOW_HUE4
+#undef RAINBOW_HUE16
+#undef RAINBOW_HUE64
+
+// The batch version skips the section branching entirely: the hue is
+// looked up in rainbow_hue_table, and only saturation and value are applied.
 void hsv2rgb_rainbow( const struct CHSV* phsv, struct CRGB * prgb, int numLeds) {
     for(int i = 0; i < numLeds; ++i) {
-        hsv2rgb_rainbow(phsv[i], prgb[i]);
+        uint8_t hue = phsv[i].hue;
+        uint8_t sat = phsv[i].sat;
+        uint8_t val = phsv[i].val;
+
+        const uint8_t* entry = rainbow_hue_table + ((uint16_t)hue * 3);
+        uint8_t r = FL_PGM_READ_BYTE_NEAR( entry + 0);
+        uint8_t g = FL_PGM_READ_BYTE_NEAR( entry + 1);
+        uint8_t b = FL_PGM_READ_BYTE_NEAR( entry + 2);
+
+        hsv2rgb_rainbow_sat_val( r, g, b, sat, val);
+
+        prgb[i].r = r;
+        prgb[i].g = g;
+        prgb[i].b = b;
     }
 }
 
@@ -72,6 +72,10 @@ void hsv2rgb_rainbow( const struct CHSV& hsv, struct CRGB& rgb);
 
 /// @copybrief hsv2rgb_rainbow(const struct CHSV&, struct CRGB&)
 /// @see hsv2rgb_rainbow(const struct CHSV&, struct CRGB&)
+/// @note The array version looks hues up in a precomputed, full
+/// saturation/value table and then applies saturation and value, which
+/// avoids the per-pixel section branching. Output is bit-identical to
+/// the single pixel version.
 /// @param phsv CHSV array to convert to RGB. Max hue supported is HUE_MAX_RAINBOW
 /// @param prgb CRGB array to store the result of the conversion (will be modified)
 /// @param numLeds the number of array values to process
@@ -8,7 +8,10 @@
 /// @file led_sysdefs.h
 /// Determines which platform system definitions to include
 
-#if defined(NRF51) || defined(__RFduino__) || defined (__Simblee__)
+#if defined(FASTLED_HOST)
+// Native build on a desktop host, for tests and benchmarks
+#include "platforms/host/led_sysdefs_host.h"
+#elif defined(NRF51) || defined(__RFduino__) || defined (__Simblee__)
 #include "platforms/arm/nrf51/led_sysdefs_arm_nrf51.h"
 #elif defined(NRF52_SERIES)
 #include "platforms/arm/nrf52/led_sysdefs_arm_nrf52.h"
@@ -342,8 +342,9 @@ int16_t inoise16_raw(uint32_t x, uint32_t y, uint32_t z)
     return ans;
 }
 
-uint16_t inoise16(uint32_t x, uint32_t y, uint32_t z) {
-    int32_t ans = inoise16_raw(x,y,z);
+/// Scale a raw 3D noise value into the 0-65535 output range of inoise16()
+static uint16_t inline __attribute__((always_inline)) inoise16_scale3d(int16_t raw) {
+    int32_t ans = raw;
     ans = ans + 19052L;
     uint32_t pan = ans;
     // pan = (ans * 220L) >> 7.  That's the same as:
@@ -358,6 +359,92 @@ uint16_t inoise16(uint32_t x, uint32_t y, uint32_t z) {
     // return scale16by8(inoise16_raw(x,y,z)+19052,220)<<1;
 }
 
+uint16_t inoise16(uint32_t x, uint32_t y, uint32_t z) {
+    return inoise16_scale3d(inoise16_raw(x,y,z));
+}
+
+/// Precompute the lattice cell, gradient offset and eased fraction for
+/// one 16.16 coordinate, exactly as inoise16_raw() derives them.
+static void inline __attribute__((always_inline)) noise_axis16(NoiseAxis16& axis, uint32_t coord) {
+    uint16_t frac = coord & 0xFFFF;
+    axis.cell = (coord>>16)&0xFF;
+    axis.frac = (frac >> 1) & 0x7FFF;
+    axis.ease = EASE16(frac);
+}
+
+CNoiseField16::CNoiseField16(NoiseAxis16* xaxis, uint16_t width, NoiseAxis16* yaxis, uint16_t height)
+    : m_pXAxis(xaxis), m_pYAxis(yaxis), m_nWidth(width), m_nHeight(height)
+{
+    noise_axis16(m_ZAxis, 0);
+}
+
+void CNoiseField16::setX(uint32_t x, int32_t scalex) {
+    for(uint16_t j = 0; j < m_nWidth; ++j, x += scalex) {
+        noise_axis16(m_pXAxis[j], x);
+    }
+}
+
+void CNoiseField16::setY(uint32_t y, int32_t scaley) {
+    for(uint16_t i = 0; i < m_nHeight; ++i, y += scaley) {
+        noise_axis16(m_pYAxis[i], y);
+    }
+}
+
+void CNoiseField16::setTime(uint32_t z) {
+    noise_axis16(m_ZAxis, z);
+}
+
+void CNoiseField16::fillRow(uint16_t *pRow, uint16_t row) const {
+    const uint8_t Y = m_pYAxis[row].cell;
+    const uint8_t Z = m_ZAxis.cell;
+    const int16_t yy = m_pYAxis[row].frac;
+    const int16_t zz = m_ZAxis.frac;
+    const uint16_t v = m_pYAxis[row].ease;
+    const uint16_t w = m_ZAxis.ease;
+    const uint16_t N = 0x8000L;
+
+    // Gradient hashes of the eight cube corners; neighbouring samples
+    // usually share a cell, so these are only redone when X changes.
+    uint8_t hAA = 0, hBA = 0, hAB = 0, hBB = 0, hAA1 = 0, hBA1 = 0, hAB1 = 0, hBB1 = 0;
+    uint16_t lastX = 0x100;
+
+    for(uint16_t j = 0; j < m_nWidth; ++j) {
+        const NoiseAxis16& xaxis = m_pXAxis[j];
+        const uint8_t X = xaxis.cell;
+        if( X != lastX ) {
+            lastX = X;
+            uint8_t A = P(X)+Y;
+            uint8_t AA = P(A)+Z;
+            uint8_t AB = P(A+1)+Z;
+            uint8_t B = P(X+1)+Y;
+            uint8_t BA = P(B) + Z;
+            uint8_t BB = P(B+1)+Z;
+            hAA = P(AA); hBA = P(BA); hAB = P(AB); hBB = P(BB);
+            hAA1 = P(AA+1); hBA1 = P(BA+1); hAB1 = P(AB+1); hBB1 = P(BB+1);
+        }
+
+        const int16_t xx = xaxis.frac;
+        const uint16_t u = xaxis.ease;
+
+        int16_t X1 = LERP(grad16(hAA, xx, yy, zz), grad16(hBA, xx - N, yy, zz), u);
+        int16_t X2 = LERP(grad16(hAB, xx, yy-N, zz), grad16(hBB, xx - N, yy - N, zz), u);
+        int16_t X3 = LERP(grad16(hAA1, xx, yy, zz-N), grad16(hBA1, xx - N, yy, zz-N), u);
+        int16_t X4 = LERP(grad16(hAB1, xx, yy-N, zz-N), grad16(hBB1, xx - N, yy - N, zz - N), u);
+
+        int16_t Y1 = LERP(X1,X2,v);
+        int16_t Y2 = LERP(X3,X4,v);
+
+        pRow[j] = inoise16_scale3d(LERP(Y1,Y2,w));
+    }
+}
+
+void CNoiseField16::fillRows(uint16_t *pData, uint16_t rowBegin, uint16_t rowEnd) const {
+    if( rowEnd > m_nHeight ) { rowEnd = m_nHeight; }
+    for(uint16_t i = rowBegin; i < rowEnd; ++i) {
+        fillRow(pData + ((uint32_t)i * m_nWidth), i);
+    }
+}
+
 int16_t inoise16_raw(uint32_t x, uint32_t y)
 {
     // Find the unit cube containing the point
@@ -561,6 +648,112 @@ uint8_t inoise8(uint16_t x) {
     return ans;
 }
 
+/// Number of lanes processed together by the batch noise functions
+#define NOISE_BATCH_LANES 8
+
+// The batch functions split the work into two passes over a block of
+// lanes: first the permutation table lookups and coordinate terms, then
+// the gradient/interpolation math as per-lane arithmetic on
+// struct-of-arrays data.  GCC does not vectorize the second pass (the
+// gradient selects and the 16x16->32 bit multiplies get in the way), and
+// a hand-written vector version only pays off with AVX2; see
+// tests/bench_noise_batch.cpp.
+void inoise16_batch(const uint32_t *xs, const uint32_t *ys, const uint32_t *zs, uint16_t *out, uint16_t count) {
+    uint8_t h[8][NOISE_BATCH_LANES];
+    int16_t xx[NOISE_BATCH_LANES], yy[NOISE_BATCH_LANES], zz[NOISE_BATCH_LANES];
+    uint16_t u[NOISE_BATCH_LANES], v[NOISE_BATCH_LANES], w[NOISE_BATCH_LANES];
+    const uint16_t N = 0x8000L;
+
+    while( count ) {
+        const uint8_t lanes = count < NOISE_BATCH_LANES ? count : NOISE_BATCH_LANES;
+
+        for(uint8_t i = 0; i < lanes; ++i) {
+            NoiseAxis16 ax, ay, az;
+            noise_axis16(ax, xs[i]);
+            noise_axis16(ay, ys[i]);
+            noise_axis16(az, zs[i]);
+
+            uint8_t A = P(ax.cell)+ay.cell;
+            uint8_t AA = P(A)+az.cell;
+            uint8_t AB = P(A+1)+az.cell;
+            uint8_t B = P(ax.cell+1)+ay.cell;
+            uint8_t BA = P(B) + az.cell;
+            uint8_t BB = P(B+1)+az.cell;
+            h[0][i] = P(AA);   h[1][i] = P(BA);   h[2][i] = P(AB);   h[3][i] = P(BB);
+            h[4][i] = P(AA+1); h[5][i] = P(BA+1); h[6][i] = P(AB+1); h[7][i] = P(BB+1);
+
+            xx[i] = ax.frac; yy[i] = ay.frac; zz[i] = az.frac;
+            u[i] = ax.ease;  v[i] = ay.ease;  w[i] = az.ease;
+        }
+
+        for(uint8_t i = 0; i < lanes; ++i) {
+            int16_t X1 = LERP(grad16(h[0][i], xx[i], yy[i], zz[i]), grad16(h[1][i], xx[i] - N, yy[i], zz[i]), u[i]);
+            int16_t X2 = LERP(grad16(h[2][i], xx[i], yy[i]-N, zz[i]), grad16(h[3][i], xx[i] - N, yy[i] - N, zz[i]), u[i]);
+            int16_t X3 = LERP(grad16(h[4][i], xx[i], yy[i], zz[i]-N), grad16(h[5][i], xx[i] - N, yy[i], zz[i]-N), u[i]);
+            int16_t X4 = LERP(grad16(h[6][i], xx[i], yy[i]-N, zz[i]-N), grad16(h[7][i], xx[i] - N, yy[i] - N, zz[i] - N), u[i]);
+
+            int16_t Y1 = LERP(X1,X2,v[i]);
+            int16_t Y2 = LERP(X3,X4,v[i]);
+
+            out[i] = inoise16_scale3d(LERP(Y1,Y2,w[i]));
+        }
+
+        xs += lanes; ys += lanes; zs += lanes; out += lanes;
+        count -= lanes;
+    }
+}
+
+void inoise8_batch(const uint16_t *xs, const uint16_t *ys, const uint16_t *zs, uint8_t *out, uint16_t count) {
+    uint8_t h[8][NOISE_BATCH_LANES];
+    int8_t xx[NOISE_BATCH_LANES], yy[NOISE_BATCH_LANES], zz[NOISE_BATCH_LANES];
+    uint8_t u[NOISE_BATCH_LANES], v[NOISE_BATCH_LANES], w[NOISE_BATCH_LANES];
+    const uint8_t N = 0x80;
+
+    while( count ) {
+        const uint8_t lanes = count < NOISE_BATCH_LANES ? count : NOISE_BATCH_LANES;
+
+        for(uint8_t i = 0; i < lanes; ++i) {
+            uint16_t x = xs[i], y = ys[i], z = zs[i];
+            uint8_t X = x>>8;
+            uint8_t Y = y>>8;
+            uint8_t Z = z>>8;
+
+            uint8_t A = P(X)+Y;
+            uint8_t AA = P(A)+Z;
+            uint8_t AB = P(A+1)+Z;
+            uint8_t B = P(X+1)+Y;
+            uint8_t BA = P(B) + Z;
+            uint8_t BB = P(B+1)+Z;
+            h[0][i] = P(AA);   h[1][i] = P(BA);   h[2][i] = P(AB);   h[3][i] = P(BB);
+            h[4][i] = P(AA+1); h[5][i] = P(BA+1); h[6][i] = P(AB+1); h[7][i] = P(BB+1);
+
+            xx[i] = ((uint8_t)(x)>>1) & 0x7F;
+            yy[i] = ((uint8_t)(y)>>1) & 0x7F;
+            zz[i] = ((uint8_t)(z)>>1) & 0x7F;
+            u[i] = EASE8((uint8_t)x);
+            v[i] = EASE8((uint8_t)y);
+            w[i] = EASE8((uint8_t)z);
+        }
+
+        for(uint8_t i = 0; i < lanes; ++i) {
+            int8_t X1 = lerp7by8(grad8(h[0][i], xx[i], yy[i], zz[i]), grad8(h[1][i], xx[i] - N, yy[i], zz[i]), u[i]);
+            int8_t X2 = lerp7by8(grad8(h[2][i], xx[i], yy[i]-N, zz[i]), grad8(h[3][i], xx[i] - N, yy[i] - N, zz[i]), u[i]);
+            int8_t X3 = lerp7by8(grad8(h[4][i], xx[i], yy[i], zz[i]-N), grad8(h[5][i], xx[i] - N, yy[i], zz[i]-N), u[i]);
+            int8_t X4 = lerp7by8(grad8(h[6][i], xx[i], yy[i]-N, zz[i]-N), grad8(h[7][i], xx[i] - N, yy[i] - N, zz[i] - N), u[i]);
+
+            int8_t Y1 = lerp7by8(X1,X2,v[i]);
+            int8_t Y2 = lerp7by8(X3,X4,v[i]);
+
+            int8_t n = lerp7by8(Y1,Y2,w[i]);  // -64..+64
+            n += 64;                            //   0..128
+            out[i] = qadd8( n, n);              //   0..255
+        }
+
+        xs += lanes; ys += lanes; zs += lanes; out += lanes;
+        count -= lanes;
+    }
+}
+
 // struct q44 {
 //   uint8_t i:4;
 //   uint8_t f:4;
@@ -694,6 +887,9 @@ int32_t nmin=11111110;
 /// @todo Remove?
 int32_t nmax=0;
 
+/// Number of sample columns fill_raw_2dnoise16into8() puts through a noise field at a time
+#define NOISE_FIELD_CHUNK 32
+
 void fill_raw_2dnoise16into8(uint8_t *pData, int width, int height, uint8_t octaves, q44 freq44, fract8 amplitude, int skip, uint32_t x, int scalex, uint32_t y, int scaley, uint32_t time) {
   if(octaves > 1) {
     fill_raw_2dnoise16into8(pData, width, height, octaves-1, freq44, amplitude, skip+1, x*freq44, scalex *freq44, y*freq44, scaley * freq44, time);
@@ -704,22 +900,41 @@ void fill_raw_2dnoise16into8(uint8_t *pData, int width, int height, uint8_t octa
 
   scalex *= skip;
   scaley *= skip;
-  uint32_t xx;
   fract8 invamp = 255-amplitude;
-  for(int i = 0; i < height; i+=skip, y+=scaley) {
-    uint8_t *pRow = pData + (i*width);
-    xx = x;
-    for(int j = 0; j < width; j+=skip, xx+=scalex) {
-      uint16_t noise_base = inoise16(xx,y,time);
-      noise_base = (0x8000 & noise_base) ? noise_base - (32767) : 32767 - noise_base;
-      noise_base = scale8(noise_base>>7,amplitude);
-      if(skip==1) {
-        pRow[j] = qadd8(scale8(pRow[j],invamp),noise_base);
-      } else {
-        for(int ii = i; ii<(i+skip) && ii<height; ++ii) {
-          uint8_t *pRow = pData + (ii*width);
-          for(int jj=j; jj<(j+skip) && jj<width; ++jj) {
-            pRow[jj] = scale8(pRow[jj],invamp) + noise_base;
+
+  // Sample the octave through a noise field, so the per-column terms and
+  // the lattice hashing are shared instead of redone for every pixel. The
+  // field covers a fixed number of sample columns at a time, to keep the
+  // stack use bounded however wide the grid is.
+  const int columns = (width + skip - 1) / skip;
+  NoiseAxis16 xaxis[NOISE_FIELD_CHUNK];
+  NoiseAxis16 yaxis[1];
+  uint16_t noise_row[NOISE_FIELD_CHUNK];
+
+  for(int c = 0; c < columns; c += NOISE_FIELD_CHUNK) {
+    const int chunk = (columns - c) < NOISE_FIELD_CHUNK ? (columns - c) : NOISE_FIELD_CHUNK;
+    CNoiseField16 field(xaxis, chunk, yaxis, 1);
+    field.setX(x + (uint32_t)c * scalex, scalex);
+    field.setTime(time);
+
+    uint32_t yy = y;
+    for(int i = 0; i < height; i+=skip, yy+=scaley) {
+      uint8_t *pRow = pData + (i*width);
+      field.setY(yy, 0);
+      field.fillRow(noise_row, 0);
+      const int jEnd = (c + chunk) * skip;
+      for(int j = c * skip; j < width && j < jEnd; j+=skip) {
+        uint16_t noise_base = noise_row[j / skip - c];
+        noise_base = (0x8000 & noise_base) ? noise_base - (32767) : 32767 - noise_base;
+        noise_base = scale8(noise_base>>7,amplitude);
+        if(skip==1) {
+          pRow[j] = qadd8(scale8(pRow[j],invamp),noise_base);
+        } else {
+          for(int ii = i; ii<(i+skip) && ii<height; ++ii) {
+            uint8_t *pRow = pData + (ii*width);
+            for(int jj=j; jj<(j+skip) && jj<width; ++jj) {
+              pRow[jj] = scale8(pRow[jj],invamp) + noise_base;
+            }
           }
         }
       }
@@ -99,6 +99,106 @@ extern int8_t inoise8_raw(uint16_t x, uint16_t y);
 extern int8_t inoise8_raw(uint16_t x);
 
 /// @} 8-Bit Raw Noise Functions
+
+
+/// @name 16-Bit Noise Fields
+/// @{
+
+/// Precomputed noise terms for one sample position along one axis
+/// of a CNoiseField16
+struct NoiseAxis16 {
+    uint8_t cell;   ///< integral lattice coordinate
+    int16_t frac;   ///< fractional position within the cell, as used by the gradients
+    uint16_t ease;  ///< eased fractional position, as used by the interpolation
+};
+
+/// A regular 2D grid of 3D inoise16() samples, for animating noise over time. 
+/// Sample (row i, column j) is `inoise16(x + j*scalex, y + i*scaley, time)`,
+/// bit-identical to calling inoise16() per pixel.
+///
+/// Everything that depends only on the column, the row, or the time is
+/// computed once by setX(), setY() and setTime(). Within a row, the lattice
+/// hashes are only recomputed when a column crosses into a new cell along
+/// X. From one frame to the next usually only setTime() needs to be called
+/// again.
+///
+/// fillRows() only reads the field, so disjoint row ranges can be filled
+/// concurrently, e.g. one half of the grid from a task on each ESP32 core.
+/// @see CNoiseField16Array
+class CNoiseField16 {
+public:
+    /// Create a noise field using caller-provided axis storage
+    /// @param xaxis storage for `width` column terms
+    /// @param width the number of columns in the grid
+    /// @param yaxis storage for `height` row terms
+    /// @param height the number of rows in the grid
+    CNoiseField16(NoiseAxis16* xaxis, uint16_t width, NoiseAxis16* yaxis, uint16_t height);
+
+    /// Set the x coordinate of the first column and the distance between columns
+    void setX(uint32_t x, int32_t scalex);
+    /// Set the y coordinate of the first row and the distance between rows
+    void setY(uint32_t y, int32_t scaley);
+    /// Set the z (time) coordinate shared by all samples
+    void setTime(uint32_t z);
+
+    /// Get the number of columns in the grid
+    uint16_t width() const { return m_nWidth; }
+    /// Get the number of rows in the grid
+    uint16_t height() const { return m_nHeight; }
+
+    /// Compute one row of noise values
+    /// @param pRow buffer receiving width() values
+    /// @param row the row to compute
+    void fillRow(uint16_t *pRow, uint16_t row) const;
+
+    /// Compute a range of rows of noise values
+    /// @param pData row-major buffer for the whole grid (width() * height() values);
+    /// only rows `rowBegin` up to (but not including) `rowEnd` are written
+    /// @param rowBegin the first row to compute
+    /// @param rowEnd one past the last row to compute
+    void fillRows(uint16_t *pData, uint16_t rowBegin, uint16_t rowEnd) const;
+
+private:
+    NoiseAxis16* m_pXAxis;
+    NoiseAxis16* m_pYAxis;
+    NoiseAxis16 m_ZAxis;
+    uint16_t m_nWidth;
+    uint16_t m_nHeight;
+};
+
+/// A CNoiseField16 with its own, fixed-size axis storage
+/// @tparam WIDTH the number of columns in the grid
+/// @tparam HEIGHT the number of rows in the grid
+template<uint16_t WIDTH, uint16_t HEIGHT>
+class CNoiseField16Array : public CNoiseField16 {
+    NoiseAxis16 m_XStorage[WIDTH];
+    NoiseAxis16 m_YStorage[HEIGHT];
+public:
+    CNoiseField16Array() : CNoiseField16(m_XStorage, WIDTH, m_YStorage, HEIGHT) {}
+};
+
+/// @} 16-Bit Noise Fields
+
+
+/// @name Batch Noise Functions
+/// Compute many 3D noise values in one call, with coordinates passed as
+/// separate x, y and z arrays. Results are bit-identical to calling
+/// inoise16() / inoise8() once per point.
+/// @{
+
+/// Compute inoise16(xs[i], ys[i], zs[i]) for `count` points
+/// @param xs x-axis coordinates on the noise map
+/// @param ys y-axis coordinates on the noise map
+/// @param zs z-axis coordinates on the noise map
+/// @param out array receiving `count` noise values
+/// @param count the number of points to compute
+void inoise16_batch(const uint32_t *xs, const uint32_t *ys, const uint32_t *zs, uint16_t *out, uint16_t count);
+
+/// Compute inoise8(xs[i], ys[i], zs[i]) for `count` points
+/// @copydetails inoise16_batch()
+void inoise8_batch(const uint16_t *xs, const uint16_t *ys, const uint16_t *zs, uint8_t *out, uint16_t count);
+
+/// @} Batch Noise Functions
 /// @} NoiseGeneration
 
 
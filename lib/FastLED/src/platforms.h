@@ -8,7 +8,10 @@
 /// @file platforms.h
 /// Determines which platforms headers to include
 
-#if defined(NRF51)
+#if defined(FASTLED_HOST)
+// Native build on a desktop host, for tests and benchmarks
+#include "platforms/host/fastled_host.h"
+#elif defined(NRF51)
 #include "platforms/arm/nrf51/fastled_arm_nrf51.h"
 #elif defined(NRF52_SERIES)
 #include "platforms/arm/nrf52/fastled_arm_nrf52.h"
@@ -47,6 +47,9 @@
  *      wants the data in 32-bit chunks, so the actual form is 3 X 8 X
  *      32, with the low 8 bits unused.
  *
+ * Steps 2 and 3 live in I2SParallelEncoder (i2s_encoder_esp32.h), which
+ * does not depend on ESP-IDF and can be tested on a host.
+ *
  *   3. Take each group of 24 parallel bits and "expand" them into a
  *      pattern according to the encoding. For example, with a 8MHz
  *      data clock, each data bit turns into 10 I2s pulses, so 24
@@ -118,6 +121,8 @@ extern "C" {
 }
 #endif
 
+#include "i2s_encoder_esp32.h"
+
 __attribute__ ((always_inline)) inline static uint32_t __clock_cycles() {
     uint32_t cyc;
     __asm__ __volatile__ ("rsr %0,ccount":"=a" (cyc));
@@ -188,9 +193,8 @@ static bool gDoneFilling = false;
 static int ones_for_one;
 static int ones_for_zero;
 
-// -- Temp buffers for pixels and bits being formatted for DMA
-static uint8_t gPixelRow[NUM_COLOR_CHANNELS][32];
-static uint8_t gPixelBits[NUM_COLOR_CHANNELS][8][4];
+// -- Temp buffer for the pixels being formatted for DMA
+static uint8_t gPixelRow[NUM_COLOR_CHANNELS][I2S_MAX_LANES];
 static int CLOCK_DIVIDER_N;
 static int CLOCK_DIVIDER_A;
 static int CLOCK_DIVIDER_B;
@@ -414,8 +418,7 @@ protected:
             ++i;
         }
         
-        memset(gPixelRow, 0, NUM_COLOR_CHANNELS * 32);
-        memset(gPixelBits, 0, NUM_COLOR_CHANNELS * 32);
+        memset(gPixelRow, 0, sizeof(gPixelRow));
     }
     
     static DMABuffer * allocateDMABuffer(int bytes)
@@ -635,15 +638,11 @@ protected:
         //    data for each color channel in a separate array.
         uint32_t has_data_mask = 0;
         for (int i = 0; i < gNumControllers; ++i) {
-            // -- Store the pixels in reverse controller order starting at index 23
-            //    This causes the bits to come out in the right position after we
-            //    transpose them.
-            int bit_index = 23-i;
             ClocklessController * pController = static_cast<ClocklessController*>(gControllers[i]);
             if (pController->mPixels->has(1)) {
-                gPixelRow[0][bit_index] = pController->mPixels->loadAndScale0();
-                gPixelRow[1][bit_index] = pController->mPixels->loadAndScale1();
-                gPixelRow[2][bit_index] = pController->mPixels->loadAndScale2();
+                gPixelRow[0][i] = pController->mPixels->loadAndScale0();
+                gPixelRow[1][i] = pController->mPixels->loadAndScale1();
+                gPixelRow[2][i] = pController->mPixels->loadAndScale2();
                 pController->mPixels->advanceData();
                 pController->mPixels->stepDithering();
                 
@@ -659,65 +658,18 @@ protected:
         }
         
         // -- Transpose and encode the pixel data for the DMA buffer
-        // int buf_index = 0;
         for (int channel = 0; channel < NUM_COLOR_CHANNELS; ++channel) {
             
             // -- Tranpose each array: all the bit 7's, then all the bit 6's, ...
-            transpose32(gPixelRow[channel], gPixelBits[channel][0] );
+            uint32_t bits[8];
+            I2SParallelEncoder::transpose24(gPixelRow[channel], bits);
             
-            //Serial.print("Channel: "); Serial.print(channel); Serial.print(" ");
-            for (int bitnum = 0; bitnum < 8; ++bitnum) {
-                uint8_t * row = (uint8_t *) (gPixelBits[channel][bitnum]);
-                uint32_t bit = (row[0] << 24) | (row[1] << 16) | (row[2] << 8) | row[3];
-                
-               /* SZG: More general, but too slow:
-                    for (int pulse_num = 0; pulse_num < gPulsesPerBit; ++pulse_num) {
-                        buf[buf_index++] = has_data_mask & ( (bit & gOneBit[pulse_num]) | (~bit & gZeroBit[pulse_num]) );
-                     }
-               */
-
-                // -- Only fill in the pulses that are different between the "0" and "1" encodings
-                for(int pulse_num = ones_for_zero; pulse_num < ones_for_one; ++pulse_num) {
-                    buf[bitnum*gPulsesPerBit+channel*8*gPulsesPerBit+pulse_num] = has_data_mask & bit;
-                }
-            }
+            // -- Only fill in the pulses that are different between the "0" and "1" encodings
+            I2SParallelEncoder::encode(bits, has_data_mask, buf + channel*8*gPulsesPerBit,
+                                       gPulsesPerBit, ones_for_zero, ones_for_one);
         }
     }
     
-    static void transpose32(uint8_t * pixels, uint8_t * bits)
-    {
-        transpose8rS32(& pixels[0],  1, 4, & bits[0]);
-        transpose8rS32(& pixels[8],  1, 4, & bits[1]);
-        transpose8rS32(& pixels[16], 1, 4, & bits[2]);
-        //transpose8rS32(& pixels[24], 1, 4, & bits[3]);  Can only use 24 bits
-    }
-    
-    /** Transpose 8x8 bit matrix
-     *  From Hacker's Delight
-     */
-    static void transpose8rS32(uint8_t * A, int m, int n, uint8_t * B)
-    {
-        uint32_t x, y, t;
-        
-        // Load the array and pack it into x and y.
-        
-        x = (A[0]<<24)   | (A[m]<<16)   | (A[2*m]<<8) | A[3*m];
-        y = (A[4*m]<<24) | (A[5*m]<<16) | (A[6*m]<<8) | A[7*m];
-        
-        t = (x ^ (x >> 7)) & 0x00AA00AA;  x = x ^ t ^ (t << 7);
-        t = (y ^ (y >> 7)) & 0x00AA00AA;  y = y ^ t ^ (t << 7);
-        
-        t = (x ^ (x >>14)) & 0x0000CCCC;  x = x ^ t ^ (t <<14);
-        t = (y ^ (y >>14)) & 0x0000CCCC;  y = y ^ t ^ (t <<14);
-        
-        t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
-        y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
-        x = t;
-        
-        B[0]=x>>24;    B[n]=x>>16;    B[2*n]=x>>8;  B[3*n]=x;
-        B[4*n]=y>>24;  B[5*n]=y>>16;  B[6*n]=y>>8;  B[7*n]=y;
-    }
-    
     /** Start I2S transmission
      */
     static void i2sStart()
@@ -69,6 +69,8 @@ ESP32RMTController::ESP32RMTController(int DATA_PIN, int T1, int T2, int T3, int
     mZero.level1 = 0;
     mZero.duration1 = ESP_TO_RMT_CYCLES(T2+T3); // TO_RMT_CYCLES(T2 + T3);
 
+    mEncoder.init(mZero.val, mOne.val);
+
     gControllers[gNumControllers] = this;
     gNumControllers++;
 
@@ -257,7 +259,14 @@ void IRAM_ATTR ESP32RMTController::startOnChannel(int channel)
     if (FASTLED_RMT_BUILTIN_DRIVER) {
         // -- Use the built-in RMT driver to send all the data in one shot
         rmt_register_tx_end_callback(doneOnChannel, 0);
+#if FASTLED_RMT_LAZY_ENCODE
+        // -- Let the driver pull pulses from the pixel data as it goes
+        rmt_translator_init(mRMT_channel, translateToRMT);
+        rmt_translator_set_context(mRMT_channel, this);
+        rmt_write_sample(mRMT_channel, mPixelData, mSize, false);
+#else
         rmt_write_items(mRMT_channel, mBuffer, mBufferSize, false);
+#endif
     } else {
         // -- Use our custom driver to send the data incrementally
 
@@ -489,28 +498,16 @@ void IRAM_ATTR ESP32RMTController::fillNext(bool check_time)
     }
     mLastFill = now;
 
-    // -- Get the zero and one values into local variables
-    FASTLED_REGISTER uint32_t one_val = mOne.val;
-    FASTLED_REGISTER uint32_t zero_val = mZero.val;
-
     // -- Use locals for speed
     volatile FASTLED_REGISTER uint32_t * pItem =  mRMT_mem_ptr;
 
     for (FASTLED_REGISTER int i = 0; i < PULSES_PER_FILL/8; i++) {
         if (mCur < mSize) {
 
-            // -- Get the next four bytes of pixel data
-            FASTLED_REGISTER uint32_t pixeldata = mPixelData[mCur] << 24;
+            // -- Write the eight items for the next byte of pixel data,
+            //    MSB first, straight into RMTMEM.chan[n].data32[x]
+            pItem = mEncoder.encodeByte(mPixelData[mCur], pItem);
             mCur++;
-            
-            // Shift bits out, MSB first, setting RMTMEM.chan[n].data32[x] to the 
-            // rmt_item32_t value corresponding to the buffered bit value
-            for (FASTLED_REGISTER uint32_t j = 0; j < 8; j++) {
-                *pItem++ = (pixeldata & 0x80000000L) ? one_val : zero_val;
-                // Replaces: RMTMEM.chan[mRMT_channel].data32[mCurPulse].val = val;
-
-                pixeldata <<= 1;
-            }
         } else {
             // -- No more data; signal to the RMT we are done by filling the
             //    rest of the buffer with zeros
@@ -535,11 +532,17 @@ void IRAM_ATTR ESP32RMTController::fillNext(bool check_time)
 //    This function is only used when the built-in RMT driver is chosen
 void ESP32RMTController::initPulseBuffer(int size_in_bytes)
 {
+    // -- Each byte has 8 bits, each bit needs a 32-bit RMT item
+    int size_in_items = size_in_bytes * 8;
+    if (mBuffer != 0 && mBufferSize < size_in_items) {
+        free(mBuffer);
+        mBuffer = 0;
+    }
+
     if (mBuffer == 0) {
-        // -- Each byte has 8 bits, each bit needs a 32-bit RMT item
-        mBufferSize = size_in_bytes * 8 * 4;
-        mBuffer = (rmt_item32_t *) calloc( mBufferSize, sizeof(rmt_item32_t));
+        mBuffer = (rmt_item32_t *) calloc( size_in_items, sizeof(rmt_item32_t));
     }
+    mBufferSize = size_in_items;
     mCurPulse = 0;
 }
 
@@ -548,13 +551,24 @@ void ESP32RMTController::initPulseBuffer(int size_in_bytes)
 void ESP32RMTController::convertByte(uint32_t byteval)
 {
     // -- Write one byte's worth of RMT pulses to the big buffer
-    byteval <<= 24;
-    for (FASTLED_REGISTER uint32_t j = 0; j < 8; j++) {
-        mBuffer[mCurPulse] = (byteval & 0x80000000L) ? mOne : mZero;
-        byteval <<= 1;
-        mCurPulse++;
-    }
+    mEncoder.encodeByte((uint8_t)byteval, &(mBuffer[mCurPulse].val));
+    mCurPulse += 8;
+}
+
+#if FASTLED_RMT_LAZY_ENCODE
+// -- Translator for the built-in driver
+//    Encodes as many whole bytes as fit in the items the driver wants
+void IRAM_ATTR ESP32RMTController::translateToRMT(const void *src, rmt_item32_t *dest, size_t src_size,
+                                                  size_t wanted_num, size_t *translated_size, size_t *item_num)
+{
+    void * context = 0;
+    rmt_translator_get_context(item_num, &context);
+    ESP32RMTController * pController = (ESP32RMTController *) context;
+
+    *translated_size = pController->mEncoder.translate((const uint8_t *) src, src_size, &(dest->val),
+                                                       wanted_num, item_num);
 }
+#endif
 
 #endif // ! FASTLED_ESP32_I2S
 
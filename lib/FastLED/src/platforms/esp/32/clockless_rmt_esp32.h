@@ -80,6 +80,18 @@
  *      send the data while the program continues to prepare the next
  *      frame of data.
  *
+ * NEW: With the built-in driver, the RMT pulses no longer have to be
+ *      computed for the whole strip ahead of time. When the ESP-IDF
+ *      supports RMT translators with a context (v4.3 and later), the
+ *      driver keeps only the pixel bytes and encodes them into pulses
+ *      on demand, as the RMT needs them. This is on by default in that
+ *      case; set it to 0 to go back to the full pulse buffer:
+ *
+ * #define FASTLED_RMT_LAZY_ENCODE 0
+ *
+ *      Both drivers now encode pixel bytes using a table of pulses for
+ *      each nibble (see rmt_encoder_esp32.h), rather than bit by bit.
+ *
  * #define FASTLED_RMT_SERIAL_DEBUG 1
  *
  * NEW (Oct 2021): If set enabled (Set to 1), output errorcodes to
@@ -141,6 +153,8 @@ extern void spi_flash_op_unlock(void);
 }
 #endif
 
+#include "rmt_encoder_esp32.h"
+
 __attribute__ ((always_inline)) inline static uint32_t __clock_cycles() {
   uint32_t cyc;
 #ifdef FASTLED_XTENSA
@@ -216,6 +230,15 @@ __attribute__ ((always_inline)) inline static uint32_t __clock_cycles() {
 #define FASTLED_RMT_BUILTIN_DRIVER false
 #endif
 
+// -- Encode pulses on demand when using the built-in driver
+#ifndef FASTLED_RMT_LAZY_ENCODE
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(4, 3, 0)
+#define FASTLED_RMT_LAZY_ENCODE 1
+#else
+#define FASTLED_RMT_LAZY_ENCODE 0
+#endif
+#endif
+
 // -- Max number of controllers we can support
 #ifndef FASTLED_RMT_MAX_CONTROLLERS
 #define FASTLED_RMT_MAX_CONTROLLERS 32
@@ -249,6 +272,9 @@ private:
     rmt_item32_t   mZero;
     rmt_item32_t   mOne;
 
+    // -- Pulses for each nibble of pixel data, built from mZero and mOne
+    RMTNibbleEncoder mEncoder;
+
     // -- Total expected time to send 32 bits
     //    Each strip should get an interrupt roughly at this interval
     uint32_t       mCyclesPerFill;
@@ -269,7 +295,7 @@ private:
     // -- Buffer to hold all of the pulses. For the version that uses
     //    the RMT driver built into the ESP core.
     rmt_item32_t * mBuffer;
-    uint16_t       mBufferSize; // bytes
+    int            mBufferSize; // items
     int            mCurPulse;
 
     // -- These values need to be real variables, so we can access them
@@ -327,6 +353,14 @@ public:
     //    next half of the RMT buffer with data.
     static void IRAM_ATTR interruptHandler(void *arg);
 
+#if FASTLED_RMT_LAZY_ENCODE
+    // -- Translator for the built-in driver
+    //    Called by the RMT driver whenever it needs more pulses; encodes
+    //    them straight from the pixel data, so there is no pulse buffer.
+    static void IRAM_ATTR translateToRMT(const void *src, rmt_item32_t *dest, size_t src_size,
+                                         size_t wanted_num, size_t *translated_size, size_t *item_num);
+#endif
+
     // -- Fill RMT buffer
     //    Puts 32 bits of pixel data into the next 32 slots in the RMT memory
     //    Each data bit is represented by a 32-bit RMT item that specifies how
@@ -339,6 +373,7 @@ public:
     //    Set up the buffer that will hold all of the pulse items for this
     //    controller. 
     //    This function is only used when the built-in RMT driver is chosen
+    //    and FASTLED_RMT_LAZY_ENCODE is off
     void initPulseBuffer(int size_in_bytes);
 
     // -- Convert a byte into RMT pulses
@@ -396,7 +431,7 @@ protected:
     //    This is the main entry point for the controller.
     virtual void showPixels(PixelController<RGB_ORDER> & pixels)
     {
-        if (FASTLED_RMT_BUILTIN_DRIVER) {
+        if (FASTLED_RMT_BUILTIN_DRIVER && ! FASTLED_RMT_LAZY_ENCODE) {
             convertAllPixelData(pixels);
         } else {
             loadPixelData(pixels);
@@ -407,8 +442,8 @@ protected:
 
     // -- Convert all pixels to RMT pulses
     //    This function is only used when the user chooses to use the
-    //    built-in RMT driver, which needs all of the RMT pulses
-    //    up-front.
+    //    built-in RMT driver without FASTLED_RMT_LAZY_ENCODE, which
+    //    needs all of the RMT pulses up-front.
     void convertAllPixelData(PixelController<RGB_ORDER> & pixels)
     {
         // -- Make sure the data buffer is allocated
@@ -0,0 +1,120 @@
+/*
+ * Transpose and encode kernel for the ESP32 I2S parallel driver
+ *
+ * The I2S driver sends one bit of up to 24 strips in each 32-bit word,
+ * strip i in bit (i+8). For every pixel it takes one color byte from
+ * each strip, transposes the 24 x 8 bit matrix so that each word holds
+ * the same bit of every strip, and writes those words into the pulse
+ * pattern in the DMA buffer.
+ *
+ * The transpose works on 32-bit words (SWAR): each group of 8 strips
+ * is packed into two words and transposed with the 8x8 bit transpose
+ * from Hacker's Delight, and the three groups are merged straight into
+ * the output words, with no intermediate byte arrays. On a host with
+ * SSE2 a movemask transpose is about twice as fast again (see
+ * tests/bench_i2s_encoder.cpp), but the ESP32's Xtensa LX6 core has no
+ * vector unit, so there is only this version.
+ *
+ * This file deliberately depends on nothing from ESP-IDF, so that it
+ * can be compiled and checked on a host against a bit-serial encoding.
+ * It expects <stdint.h> to have been included already.
+ */
+
+#pragma once
+
+// -- Most strips the I2S peripheral can drive in parallel
+#define I2S_MAX_LANES 24
+
+class I2SParallelEncoder
+{
+public:
+
+    /** Transpose one color channel of up to 24 strips
+     *
+     *  lanes[i] is the byte for strip i; unused lanes may hold anything,
+     *  as long as they are masked off in encode(). On return, bits[b]
+     *  holds bit (7-b) of every strip, strip i in bit (i+8), which is
+     *  the layout the I2S peripheral wants.
+     */
+    static inline void transpose24(const uint8_t * lanes, uint32_t * bits)
+    {
+        uint32_t hi[3], lo[3];
+        for (int group = 0; group < 3; ++group) {
+            const uint8_t * A = lanes + 8*group;
+
+            // -- Pack the group in reverse order, so that strip k of the
+            //    group comes out in bit k of each transposed byte
+            uint32_t x = (A[7]<<24) | (A[6]<<16) | (A[5]<<8) | A[4];
+            uint32_t y = (A[3]<<24) | (A[2]<<16) | (A[1]<<8) | A[0];
+            transpose8x8(x, y);
+            hi[group] = x;
+            lo[group] = y;
+        }
+
+        // -- Byte b of each transposed group is bit (7-b) of its strips.
+        //    Gathering byte b of all three groups into one word is a 4x4
+        //    byte transpose, with an all-zero fourth row for bits 0-7.
+        transpose4x4(hi[2], hi[1], hi[0], bits);
+        transpose4x4(lo[2], lo[1], lo[0], bits + 4);
+    }
+
+    /** Transpose a 4x4 byte matrix whose last row is zero
+     *
+     *  out[b] = byte b of r0, r1, r2 (counting from the most significant
+     *  byte), packed into the top three bytes of the word.
+     */
+    static inline void transpose4x4(uint32_t r0, uint32_t r1, uint32_t r2, uint32_t * out)
+    {
+        uint32_t r3 = 0, t;
+
+        // -- Swap bytes within each 2x2 block
+        t = ((r0 << 8) ^ r1) & 0xFF00FF00;  r1 ^= t;  r0 ^= t >> 8;
+        t = (r2 << 8) & 0xFF00FF00;         r3 = t;   r2 ^= t >> 8;
+
+        // -- Swap the off-diagonal 2x2 blocks
+        t = ((r0 << 16) ^ r2) & 0xFFFF0000; r2 ^= t;  r0 ^= t >> 16;
+        t = ((r1 << 16) ^ r3) & 0xFFFF0000; r3 ^= t;  r1 ^= t >> 16;
+
+        out[0] = r0;
+        out[1] = r1;
+        out[2] = r2;
+        out[3] = r3;
+    }
+
+    /** Write the transposed bits of one color channel into the DMA buffer
+     *
+     *  Each data bit takes pulsesPerBit words. Only the pulses from
+     *  firstPulse up to endPulse differ between the "0" and "1"
+     *  encodings; the rest are constant and are filled in once, before
+     *  sending starts.
+     */
+    static inline void encode(const uint32_t * bits, uint32_t has_data_mask, volatile uint32_t * buf,
+                              int pulsesPerBit, int firstPulse, int endPulse)
+    {
+        for (int bitnum = 0; bitnum < 8; ++bitnum) {
+            uint32_t val = has_data_mask & bits[bitnum];
+            volatile uint32_t * pulses = buf + bitnum*pulsesPerBit;
+            for (int pulse_num = firstPulse; pulse_num < endPulse; ++pulse_num) {
+                pulses[pulse_num] = val;
+            }
+        }
+    }
+
+    /** Transpose 8x8 bit matrix, packed MSB-first into two words
+     *  From Hacker's Delight
+     */
+    static inline void transpose8x8(uint32_t & x, uint32_t & y)
+    {
+        uint32_t t;
+
+        t = (x ^ (x >> 7)) & 0x00AA00AA;  x = x ^ t ^ (t << 7);
+        t = (y ^ (y >> 7)) & 0x00AA00AA;  y = y ^ t ^ (t << 7);
+
+        t = (x ^ (x >>14)) & 0x0000CCCC;  x = x ^ t ^ (t <<14);
+        t = (y ^ (y >>14)) & 0x0000CCCC;  y = y ^ t ^ (t <<14);
+
+        t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+        y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+        x = t;
+    }
+};
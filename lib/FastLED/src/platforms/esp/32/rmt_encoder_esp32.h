@@ -0,0 +1,81 @@
+/*
+ * Table-driven RMT item encoder for the ESP32 clockless driver
+ *
+ * Each bit of pixel data is sent as one 32-bit RMT item: either the
+ * "one" item or the "zero" item, derived from the strip timing. Rather
+ * than test every bit and select between the two, the encoder keeps a
+ * table of the four items for each of the 16 possible nibbles, so one
+ * byte becomes two table lookups and eight stores.
+ *
+ * This file deliberately depends on nothing from ESP-IDF (items are
+ * plain uint32_t values, as in rmt_item32_t::val), so that it can be
+ * compiled and checked on a host against the bit-by-bit encoding.
+ * It expects <stdint.h> and <stddef.h> to have been included already.
+ */
+
+#pragma once
+
+class RMTNibbleEncoder
+{
+private:
+
+    // -- Items for each nibble, most significant bit first
+    uint32_t mItems[16][4];
+
+public:
+
+    // -- Build the table from the items for a zero bit and a one bit
+    void init(uint32_t zero_val, uint32_t one_val)
+    {
+        for (int nibble = 0; nibble < 16; nibble++) {
+            for (int bit = 0; bit < 4; bit++) {
+                mItems[nibble][bit] = (nibble & (0x8 >> bit)) ? one_val : zero_val;
+            }
+        }
+    }
+
+    // -- Write the 8 items for one byte, most significant bit first
+    //    Templated on the item pointer so it works both for RMT memory
+    //    (volatile uint32_t) and for ordinary buffers.
+    template <typename ITEM>
+    __attribute__ ((always_inline)) inline ITEM * encodeByte(uint8_t byteval, ITEM * pItem) const
+    {
+        const uint32_t * hi = mItems[byteval >> 4];
+        const uint32_t * lo = mItems[byteval & 0x0F];
+        pItem[0] = hi[0];
+        pItem[1] = hi[1];
+        pItem[2] = hi[2];
+        pItem[3] = hi[3];
+        pItem[4] = lo[0];
+        pItem[5] = lo[1];
+        pItem[6] = lo[2];
+        pItem[7] = lo[3];
+        return pItem + 8;
+    }
+
+    // -- Write the items for a run of bytes
+    template <typename ITEM>
+    inline ITEM * encode(const uint8_t * pData, int nBytes, ITEM * pItem) const
+    {
+        while (nBytes--) {
+            pItem = encodeByte(*pData++, pItem);
+        }
+        return pItem;
+    }
+
+    // -- Translate for the built-in driver's rmt_write_sample(): write the
+    //    items for as many whole bytes as fit in wanted_num items. Returns
+    //    the number of bytes used, and sets *item_num to the items written.
+    template <typename ITEM>
+    inline size_t translate(const uint8_t * pData, size_t src_size, ITEM * pItem,
+                            size_t wanted_num, size_t * item_num) const
+    {
+        size_t nBytes = wanted_num / 8;
+        if (nBytes > src_size) {
+            nBytes = src_size;
+        }
+        encode(pData, (int) nBytes, pItem);
+        *item_num = nBytes * 8;
+        return nBytes;
+    }
+};
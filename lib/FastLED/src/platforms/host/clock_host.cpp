@@ -0,0 +1,87 @@
+#define FASTLED_INTERNAL
+#include "FastLED.h"
+
+/// @file clock_host.cpp
+/// millis(), micros() and the software pin registers for the host platform
+
+#if defined(FASTLED_HOST)
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+volatile uint32_t gFastLEDHostPorts[FASTLED_HOST_PORTS];
+
+// Atomic, as the showAsync() thread moves virtual time on as it sends frames
+static std::atomic<bool> sVirtual(false);        // running on virtual time
+static std::atomic<uint64_t> sVirtualMicros(0);  // the virtual time
+static const std::chrono::steady_clock::time_point sStart = std::chrono::steady_clock::now();
+
+// The background thread's own virtual time, see CHostClock::setBackgroundThread()
+static std::atomic<uint64_t> sBackgroundMicros(0);
+static thread_local bool tBackground = false;
+
+static uint64_t hostMicros() {
+    if(sVirtual) { return tBackground ? sBackgroundMicros : sVirtualMicros; }
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - sStart).count();
+}
+
+/// Move the calling thread's virtual time on
+static void addVirtualMicros(uint64_t us) {
+    if(tBackground) {
+        sBackgroundMicros.fetch_add(us);
+    } else {
+        sVirtualMicros.fetch_add(us);
+    }
+}
+
+uint32_t micros() { return (uint32_t)hostMicros(); }
+uint32_t millis() { return (uint32_t)(hostMicros() / 1000); }
+
+void delayMicroseconds(unsigned int us) {
+    if(sVirtual) {
+        addVirtualMicros(us);
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    }
+}
+
+void delay(unsigned long ms) {
+    if(sVirtual) {
+        addVirtualMicros((uint64_t)ms * 1000);
+    } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+}
+
+FASTLED_NAMESPACE_BEGIN
+
+void CHostClock::setVirtual(bool bVirtual) {
+    if(bVirtual && !sVirtual) { sVirtualMicros = hostMicros(); }
+    sVirtual = bVirtual;
+}
+
+bool CHostClock::isVirtual() { return sVirtual; }
+
+void CHostClock::setMicros(uint32_t us) {
+    sVirtual = true;
+    sVirtualMicros = us;
+    sBackgroundMicros = us;
+}
+
+void CHostClock::advanceMicros(uint32_t us) {
+    if(sVirtual) { addVirtualMicros(us); }
+}
+
+void CHostClock::setBackgroundThread() { tBackground = true; }
+
+void CHostClock::syncBackground() { sBackgroundMicros = (uint64_t)sVirtualMicros; }
+
+void CHostClock::joinBackground() {
+    uint64_t end = sBackgroundMicros;
+    if(end > sVirtualMicros) { sVirtualMicros = end; }
+}
+
+FASTLED_NAMESPACE_END
+
+#endif
@@ -0,0 +1,37 @@
+#pragma once
+
+/// @file clock_host.h
+/// Controls the clock behind millis() and micros() on the host
+
+FASTLED_NAMESPACE_BEGIN
+
+/// The clock behind millis() and micros() on the host. It starts out following
+/// the system's steady clock. Switched to virtual time, it only moves when told
+/// to, or by delay(), so that timing-dependent code can be tested repeatably.
+class CHostClock {
+public:
+    /// Switch between virtual time and the steady clock
+    /// @param bVirtual true to stop following the steady clock; time then stays where it is until advanced
+    static void setVirtual(bool bVirtual);
+    /// @returns true if the clock is running on virtual time
+    static bool isVirtual();
+    /// Set the virtual time. Switches the clock to virtual time.
+    /// @param us the new value of micros()
+    static void setMicros(uint32_t us);
+    /// Move virtual time forward. Does nothing on the steady clock.
+    /// @param us number of microseconds to add
+    static void advanceMicros(uint32_t us);
+
+    /// Put the calling thread on a virtual timeline of its own, as if it ran
+    /// on another core. The showAsync() thread uses this, so that a frame on
+    /// the wire overlaps with what the caller does in the meantime.
+    static void setBackgroundThread();
+    /// Start the background timeline at the current virtual time, when a job
+    /// is handed to the background thread
+    static void syncBackground();
+    /// Move virtual time on to the end of the background timeline, if it is
+    /// later, once the background thread has been waited for
+    static void joinBackground();
+};
+
+FASTLED_NAMESPACE_END
@@ -0,0 +1,51 @@
+#define FASTLED_INTERNAL
+#include "FastLED.h"
+
+/// @file clockless_host.cpp
+/// Frame recording for the host clockless controllers
+
+#if defined(FASTLED_HOST)
+
+#include <stdlib.h>
+
+FASTLED_NAMESPACE_BEGIN
+
+CHostRecorder *CHostRecorder::s_pHead = NULL;
+
+CHostRecorder::CHostRecorder(uint8_t pin)
+    : m_pNext(s_pHead), m_nPin(pin), m_pFrame(NULL), m_nSize(0), m_nCapacity(0), m_nFrames(0), m_nFrameMicros(0) {
+    s_pHead = this;
+}
+
+CHostRecorder::~CHostRecorder() {
+    CHostRecorder **pp = &s_pHead;
+    while(*pp != this) { pp = &(*pp)->m_pNext; }
+    *pp = m_pNext;
+    free(m_pFrame);
+}
+
+CHostRecorder *CHostRecorder::forPin(uint8_t pin) {
+    for(CHostRecorder *p = s_pHead; p; p = p->m_pNext) {
+        if(p->m_nPin == pin) { return p; }
+    }
+    return NULL;
+}
+
+uint8_t *CHostRecorder::beginFrame(uint16_t bytes) {
+    if(bytes > m_nCapacity) {
+        m_pFrame = (uint8_t*)realloc(m_pFrame, bytes);
+        m_nCapacity = bytes;
+    }
+    m_nSize = bytes;
+    return m_pFrame;
+}
+
+void CHostRecorder::endFrame(uint32_t wireMicros) {
+    ++m_nFrames;
+    m_nFrameMicros = micros();
+    CHostClock::advanceMicros(wireMicros);
+}
+
+FASTLED_NAMESPACE_END
+
+#endif
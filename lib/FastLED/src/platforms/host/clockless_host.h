@@ -0,0 +1,89 @@
+#pragma once
+
+/// @file clockless_host.h
+/// Clockless controller for the host, which records each frame instead of sending it
+
+FASTLED_NAMESPACE_BEGIN
+
+#define FASTLED_HAS_CLOCKLESS 1
+
+#ifndef CLOCKLESS_FREQUENCY
+/// Clock the T1, T2 and T3 timings are counted in
+#define CLOCKLESS_FREQUENCY F_CPU
+#endif
+
+/// The frame recording behind the host ClocklessController, which does not
+/// depend on the template parameters. Each show() replaces the recorded frame
+/// with the bytes that would have gone down the wire, in wire order, after
+/// color correction, scaling and dithering.
+class CHostRecorder {
+    static CHostRecorder *s_pHead;  ///< all recorders, newest first
+    CHostRecorder *m_pNext;         ///< next recorder in the list
+    uint8_t m_nPin;                 ///< data pin of the controller
+    uint8_t *m_pFrame;              ///< the last frame
+    uint16_t m_nSize;               ///< bytes in the last frame
+    uint16_t m_nCapacity;           ///< bytes allocated at m_pFrame
+    uint32_t m_nFrames;             ///< frames recorded since the last reset
+    uint32_t m_nFrameMicros;        ///< micros() when the last frame was recorded
+
+protected:
+    /// Get space for a frame
+    /// @param bytes size of the frame
+    /// @returns where to write it
+    uint8_t *beginFrame(uint16_t bytes);
+
+    /// Finish the frame started with beginFrame(). On the virtual clock, time
+    /// moves on by as long as the frame takes to send.
+    /// @param wireMicros time the frame takes on the wire
+    void endFrame(uint32_t wireMicros);
+
+public:
+    /// Constructor
+    /// @param pin data pin of the controller
+    CHostRecorder(uint8_t pin);
+    ~CHostRecorder();
+
+    /// Find the recorder for a data pin
+    /// @returns the most recently created recorder on that pin, or NULL
+    static CHostRecorder *forPin(uint8_t pin);
+
+    /// @returns the bytes of the last frame, in the order they are sent
+    const uint8_t *getFrame() const { return m_pFrame; }
+    /// @returns the number of bytes in the last frame
+    uint16_t getFrameSize() const { return m_nSize; }
+    /// @returns the number of frames recorded since the last reset
+    uint32_t getFrameCount() const { return m_nFrames; }
+    /// @returns micros() when the last frame was recorded
+    uint32_t getFrameMicros() const { return m_nFrameMicros; }
+    /// Forget the recorded frames
+    void resetFrames() { m_nSize = 0; m_nFrames = 0; m_nFrameMicros = 0; }
+};
+
+/// Host stand-in for the clockless controllers, with the same template
+/// parameters as the hardware ones so that the chipset definitions can be used
+/// unchanged. Frames are recorded by CHostRecorder instead of being sent.
+template <int DATA_PIN, int T1, int T2, int T3, EOrder RGB_ORDER = RGB, int XTRA0 = 0, bool FLIP = false, int WAIT_TIME = 5>
+class ClocklessController : public CPixelLEDController<RGB_ORDER>, public CHostRecorder {
+public:
+    ClocklessController() : CHostRecorder(DATA_PIN) {}
+
+    virtual void init() {}
+
+    virtual uint16_t getMaxRefreshRate() const { return 400; }
+
+protected:
+    virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
+        uint8_t *pData = beginFrame(pixels.size() * 3);
+        while(pixels.has(1)) {
+            *pData++ = pixels.loadAndScale0();
+            *pData++ = pixels.loadAndScale1();
+            *pData++ = pixels.loadAndScale2();
+            pixels.advanceData();
+            pixels.stepDithering();
+        }
+        uint64_t bits = (uint64_t)pixels.size() * 3 * (8 + XTRA0);
+        endFrame((uint32_t)(bits * (T1 + T2 + T3) / (CLOCKLESS_FREQUENCY / 1000000)) + WAIT_TIME);
+    }
+};
+
+FASTLED_NAMESPACE_END
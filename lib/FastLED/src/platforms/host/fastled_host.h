@@ -0,0 +1,7 @@
+#pragma once
+
+/// @file fastled_host.h
+/// Platform headers for building FastLED natively on a desktop host
+
+#include "clock_host.h"
+#include "clockless_host.h"
@@ -0,0 +1,62 @@
+#pragma once
+
+/// @file led_sysdefs_host.h
+/// System definitions for building FastLED natively on a desktop host, for tests and benchmarks
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef FASTLED_HOST
+#define FASTLED_HOST
+#endif
+
+// Pins are plain bits in gFastLEDHostPorts, driven through the generic Pin class in fastpin.h
+#define FASTLED_FORCE_SOFTWARE_PINS
+// ...which is all there is on the host, so there are no faster pins to warn about
+#define HAS_HARDWARE_PIN_SUPPORT 1
+// Likewise any pin pair can do SPI, bit-banged, see fastspi.h
+#define FASTLED_ALL_PINS_HARDWARE_SPI
+
+// millis() and micros() come from the host clock, see clock_host.cpp
+#define FASTLED_HAS_MILLIS
+
+/// Nominal clock rate, used for the timing of the recorded clockless chipsets
+#ifndef F_CPU
+#define F_CPU 240000000
+#endif
+
+typedef volatile uint32_t RoReg;
+typedef volatile uint32_t RwReg;
+
+#ifndef FASTLED_USE_PROGMEM
+# define FASTLED_USE_PROGMEM 0
+#endif
+
+#ifndef FASTLED_ALLOW_INTERRUPTS
+# define FASTLED_ALLOW_INTERRUPTS 1
+# define INTERRUPT_THRESHOLD 0
+#endif
+
+#define INPUT 0
+#define OUTPUT 1
+
+/// Milliseconds since the host clock started
+uint32_t millis();
+/// Microseconds since the host clock started
+uint32_t micros();
+/// Wait for (or, on the virtual clock, skip ahead) the given number of milliseconds
+void delay(unsigned long ms);
+/// Wait for (or, on the virtual clock, skip ahead) the given number of microseconds
+void delayMicroseconds(unsigned int us);
+static inline void yield() {}
+
+/// Output and input registers for the software pins, 32 pins to a port
+extern volatile uint32_t gFastLEDHostPorts[];
+/// Number of ports in gFastLEDHostPorts
+#define FASTLED_HOST_PORTS 8
+
+static inline void pinMode(uint8_t, uint8_t) {}
+static inline uint32_t digitalPinToBitMask(uint8_t pin) { return 1UL << (pin & 31); }
+static inline uint8_t digitalPinToPort(uint8_t pin) { return (pin >> 5) % FASTLED_HOST_PORTS; }
+static inline volatile uint32_t *portOutputRegister(uint8_t port) { return gFastLEDHostPorts + port; }
+static inline volatile uint32_t *portInputRegister(uint8_t port) { return gFastLEDHostPorts + port; }
@@ -57,7 +57,42 @@ static const uint8_t gMCU_mW  =  25 * 5; // 25mA @ 5v = 125 mW
 static uint8_t  gMaxPowerIndicatorLEDPinNumber = 0; // default = Arduino onboard LED pin.  set to zero to skip this.
 
 
+const CLEDPowerModel gDefaultPowerModel = { gRed_mW, gGreen_mW, gBlue_mW, gDark_mW };
+
+/// Apply a power model to per-channel sums of LED data
+static uint32_t power_mW_for_sums( uint32_t red32, uint32_t green32, uint32_t blue32,
+                                   uint16_t numLeds, const CLEDPowerModel& model)
+{
+    red32   *= model.red_mW;
+    green32 *= model.green_mW;
+    blue32  *= model.blue_mW;
+
+    red32   >>= 8;
+    green32 >>= 8;
+    blue32  >>= 8;
+
+    return red32 + green32 + blue32 + ((uint32_t)model.dark_mW * numLeds);
+}
+
+/// Power-limited brightness for a given full-brightness power draw
+static uint8_t brightness_for_power_mW( uint32_t total_mW, uint8_t target_brightness, uint32_t max_power_mW)
+{
+	uint32_t requested_power_mW = ((uint32_t)total_mW * target_brightness) / 256;
+
+	uint8_t recommended_brightness = target_brightness;
+	if(requested_power_mW > max_power_mW) { 
+        recommended_brightness = (uint32_t)((uint8_t)(target_brightness) * (uint32_t)(max_power_mW)) / ((uint32_t)(requested_power_mW));
+	}
+
+	return recommended_brightness;
+}
+
 uint32_t calculate_unscaled_power_mW( const CRGB* ledbuffer, uint16_t numLeds ) //25354
+{
+    return calculate_unscaled_power_mW( ledbuffer, numLeds, gDefaultPowerModel);
+}
+
+uint32_t calculate_unscaled_power_mW( const CRGB* ledbuffer, uint16_t numLeds, const CLEDPowerModel& model)
 {
     uint32_t red32 = 0, green32 = 0, blue32 = 0;
     const CRGB* firstled = &(ledbuffer[0]);
@@ -73,17 +108,7 @@ uint32_t calculate_unscaled_power_mW( const CRGB* ledbuffer, uint16_t numLeds )
         --count;
     }
 
-    red32   *= gRed_mW;
-    green32 *= gGreen_mW;
-    blue32  *= gBlue_mW;
-
-    red32   >>= 8;
-    green32 >>= 8;
-    blue32  >>= 8;
-
-    uint32_t total = red32 + green32 + blue32 + (gDark_mW * numLeds);
-
-    return total;
+    return power_mW_for_sums( red32, green32, blue32, numLeds, model);
 }
 
 
@@ -92,16 +117,7 @@ uint8_t calculate_max_brightness_for_power_vmA(const CRGB* ledbuffer, uint16_t n
 }
 
 uint8_t calculate_max_brightness_for_power_mW(const CRGB* ledbuffer, uint16_t numLeds, uint8_t target_brightness, uint32_t max_power_mW) {
- 	uint32_t total_mW = calculate_unscaled_power_mW( ledbuffer, numLeds);
-
-	uint32_t requested_power_mW = ((uint32_t)total_mW * target_brightness) / 256;
-
-	uint8_t recommended_brightness = target_brightness;
-	if(requested_power_mW > max_power_mW) { 
-        recommended_brightness = (uint32_t)((uint8_t)(target_brightness) * (uint32_t)(max_power_mW)) / ((uint32_t)(requested_power_mW));
-	}
-
-	return recommended_brightness;
+ 	return brightness_for_power_mW( calculate_unscaled_power_mW( ledbuffer, numLeds), target_brightness, max_power_mW);
 }
 
 // sets brightness to
@@ -113,7 +129,12 @@ uint8_t calculate_max_brightness_for_power_mW( uint8_t target_brightness, uint32
 
     CLEDController *pCur = CLEDController::head();
 	while(pCur) {
-        total_mW += calculate_unscaled_power_mW( pCur->leds(), pCur->size());
+        CLEDPowerAccount *pAccount = pCur->getPowerAccount();
+        if( pAccount) {
+            total_mW += pAccount->unscaled_mW();
+        } else {
+            total_mW += calculate_unscaled_power_mW( pCur->leds(), pCur->size());
+        }
 		pCur = pCur->next();
 	}
 
@@ -166,6 +187,124 @@ uint8_t calculate_max_brightness_for_power_mW( uint8_t target_brightness, uint32
 }
 
 
+// CLEDPowerAccount
+
+CLEDPowerAccount::CLEDPowerAccount()
+    : m_pLeds(NULL), m_nLeds(0), m_nUpdateStart(0), m_nUpdateCount(0),
+      m_nRed(0), m_nGreen(0), m_nBlue(0), m_nMaxPower_mW(0), m_Model(gDefaultPowerModel)
+{
+}
+
+void CLEDPowerAccount::attach( CRGB* leds, uint16_t numLeds)
+{
+    m_pLeds = leds;
+    m_nLeds = numLeds;
+    m_nUpdateCount = 0;
+    recompute();
+}
+
+void CLEDPowerAccount::attach( CLEDController& controller)
+{
+    attach( controller.leds(), controller.size());
+    controller.setPowerAccount( this);
+}
+
+void CLEDPowerAccount::recompute()
+{
+    m_nRed = m_nGreen = m_nBlue = 0;
+    add( 0, m_nLeds, 1);
+}
+
+// Add (sign > 0) or remove (sign < 0) a range of LEDs from the sums.
+// Removal relies on unsigned wraparound, so it is exact as long as the
+// range has not changed since it was added.
+void CLEDPowerAccount::add( uint16_t start, uint16_t count, int8_t sign)
+{
+    uint32_t red32 = 0, green32 = 0, blue32 = 0;
+    const uint8_t* p = (const uint8_t*)(m_pLeds + start);
+
+    while( count) {
+        red32   += *p++;
+        green32 += *p++;
+        blue32  += *p++;
+        --count;
+    }
+
+    if( sign > 0) {
+        m_nRed += red32; m_nGreen += green32; m_nBlue += blue32;
+    } else {
+        m_nRed -= red32; m_nGreen -= green32; m_nBlue -= blue32;
+    }
+}
+
+void CLEDPowerAccount::beginUpdate( uint16_t start, uint16_t count)
+{
+    m_nUpdateStart = start;
+    m_nUpdateCount = count;
+    add( start, count, -1);
+}
+
+void CLEDPowerAccount::endUpdate()
+{
+    add( m_nUpdateStart, m_nUpdateCount, 1);
+    m_nUpdateCount = 0;
+}
+
+void CLEDPowerAccount::set( uint16_t index, const CRGB& color)
+{
+    CRGB& led = m_pLeds[index];
+    m_nRed   += (uint32_t)color.r - led.r;
+    m_nGreen += (uint32_t)color.g - led.g;
+    m_nBlue  += (uint32_t)color.b - led.b;
+    led = color;
+}
+
+void CLEDPowerAccount::fill_solid( uint16_t start, uint16_t count, const CRGB& color)
+{
+    if( start == 0 && count == m_nLeds) {
+        // the whole strip: no need to look at the old data
+        m_nRed = m_nGreen = m_nBlue = 0;
+    } else {
+        add( start, count, -1);
+    }
+    ::fill_solid( m_pLeds + start, count, color);
+    m_nRed   += (uint32_t)color.r * count;
+    m_nGreen += (uint32_t)color.g * count;
+    m_nBlue  += (uint32_t)color.b * count;
+}
+
+void CLEDPowerAccount::fadeToBlackBy( uint16_t start, uint16_t count, uint8_t fadeBy)
+{
+    beginUpdate( start, count);
+    ::fadeToBlackBy( m_pLeds + start, count, fadeBy);
+    endUpdate();
+}
+
+void CLEDPowerAccount::nscale8( uint16_t start, uint16_t count, uint8_t scale)
+{
+    beginUpdate( start, count);
+    ::nscale8( m_pLeds + start, count, scale);
+    endUpdate();
+}
+
+void CLEDPowerAccount::nblend( uint16_t start, CRGB* overlay, uint16_t count, fract8 amountOfOverlay)
+{
+    beginUpdate( start, count);
+    ::nblend( m_pLeds + start, overlay, count, amountOfOverlay);
+    endUpdate();
+}
+
+uint32_t CLEDPowerAccount::unscaled_mW() const
+{
+    return power_mW_for_sums( m_nRed, m_nGreen, m_nBlue, m_nLeds, m_Model);
+}
+
+uint8_t CLEDPowerAccount::max_brightness_for_power_mW( uint8_t target_brightness, uint32_t max_power_mW) const
+{
+    return brightness_for_power_mW( unscaled_mW(), target_brightness, max_power_mW);
+}
+
+
 void set_max_power_indicator_LED( uint8_t pinNumber)
 {
     gMaxPowerIndicatorLEDPinNumber = pinNumber;
@@ -57,6 +57,137 @@ void delay_at_max_brightness_for_power( uint16_t ms);
 /// @} PowerShowDelay
 
 
+/// @name Power Models and Incremental Power Accounting
+/// By default the power limit re-sums every LED on every show(). A
+/// CLEDPowerAccount keeps running per-channel sums for one strip instead,
+/// so the power-limited brightness costs the same however long the strip
+/// is, and lets each strip have its own power model and power budget.
+/// @{
+
+/// How much power one LED on a strip draws, in milliwatts, for each
+/// channel at full brightness plus a constant idle draw.
+struct CLEDPowerModel {
+    uint8_t red_mW;    ///< power used by the red channel at 255
+    uint8_t green_mW;  ///< power used by the green channel at 255
+    uint8_t blue_mW;   ///< power used by the blue channel at 255
+    uint8_t dark_mW;   ///< power used by an LED that is fully off
+};
+
+/// The default power model, measured on WS2812B strips at 5V
+extern const CLEDPowerModel gDefaultPowerModel;
+
+/// Running power sums for one set of LED data.
+///
+/// The sums are set up by attach() and must then be kept in step with the
+/// LED data. Either change the data through the fill/fade/blend members
+/// here, or bracket direct edits with beginUpdate() and endUpdate():
+/// @code
+/// account.beginUpdate( 10, 5);
+/// for( int i = 10; i < 15; ++i) { leds[i] = CHSV( hue + i, 255, 255); }
+/// account.endUpdate();
+/// @endcode
+/// Changing the data any other way leaves the sums stale until the next
+/// recompute().
+class CLEDPowerAccount {
+public:
+    /// Create an account with the default power model and no budget
+    CLEDPowerAccount();
+
+    /// Track a set of LED data, summing it once
+    /// @param leds the LED data to track
+    /// @param numLeds the number of LEDs in the data array
+    void attach( CRGB* leds, uint16_t numLeds);
+
+    /// Track the LED data of a controller, and make FastLED.show() use
+    /// these sums (and this account's budget) for that controller
+    /// @param controller the controller whose data to track
+    void attach( CLEDController& controller);
+
+    /// Re-sum the whole LED array, e.g. after editing it without telling the account
+    void recompute();
+
+    /// Set the power model used by unscaled_mW()
+    void setModel( const CLEDPowerModel& model) { m_Model = model; }
+
+    /// Get the power model used by unscaled_mW()
+    const CLEDPowerModel& getModel() const { return m_Model; }
+
+    /// Set a power budget for this strip on its own, applied in FastLED.show()
+    /// on top of the global one
+    /// @param max_power_mW the power budget in milliwatts, zero for none
+    void setMaxPowerInMilliWatts( uint32_t max_power_mW) { m_nMaxPower_mW = max_power_mW; }
+
+    /// @copydoc setMaxPowerInMilliWatts()
+    /// @param volts the voltage of the strip
+    /// @param milliamps the current budget of the strip
+    void setMaxPowerInVoltsAndMilliamps( uint8_t volts, uint32_t milliamps) { setMaxPowerInMilliWatts( volts * milliamps); }
+
+    /// Get the power budget for this strip, zero if it has none
+    uint32_t getMaxPowerInMilliWatts() const { return m_nMaxPower_mW; }
+
+    /// Take a range of LEDs out of the sums before editing it directly
+    /// @param start the index of the first LED that will change
+    /// @param count the number of LEDs that will change
+    void beginUpdate( uint16_t start, uint16_t count);
+
+    /// Put the range passed to beginUpdate() back into the sums
+    void endUpdate();
+
+    /// Set one LED, keeping the sums current
+    void set( uint16_t index, const CRGB& color);
+
+    /// fill_solid() a range of LEDs, keeping the sums current
+    void fill_solid( uint16_t start, uint16_t count, const CRGB& color);
+
+    /// fadeToBlackBy() a range of LEDs, keeping the sums current
+    void fadeToBlackBy( uint16_t start, uint16_t count, uint8_t fadeBy);
+
+    /// nscale8() a range of LEDs, keeping the sums current
+    void nscale8( uint16_t start, uint16_t count, uint8_t scale);
+
+    /// nblend() a range of LEDs toward an overlay, keeping the sums current
+    /// @param start the index of the first LED to blend
+    /// @param overlay the colors to blend in, one per LED
+    /// @param count the number of LEDs to blend
+    /// @param amountOfOverlay the fraction of the overlay to blend in
+    void nblend( uint16_t start, CRGB* overlay, uint16_t count, fract8 amountOfOverlay);
+
+    /// The power the tracked LEDs would draw at full brightness, in milliwatts.
+    /// Same result as calculate_unscaled_power_mW() on the data, in constant time.
+    uint32_t unscaled_mW() const;
+
+    /// The highest brightness at or below target_brightness that keeps the
+    /// tracked LEDs within max_power_mW
+    uint8_t max_brightness_for_power_mW( uint8_t target_brightness, uint32_t max_power_mW) const;
+
+    /// Limit a brightness to this account's own budget, if it has one
+    uint8_t limit_brightness( uint8_t brightness) const {
+        return m_nMaxPower_mW ? max_brightness_for_power_mW( brightness, m_nMaxPower_mW) : brightness;
+    }
+
+    /// Get the tracked LED data
+    CRGB* leds() const { return m_pLeds; }
+
+    /// Get the number of tracked LEDs
+    uint16_t size() const { return m_nLeds; }
+
+private:
+    void add( uint16_t start, uint16_t count, int8_t sign);
+
+    CRGB*    m_pLeds;
+    uint16_t m_nLeds;
+    uint16_t m_nUpdateStart;
+    uint16_t m_nUpdateCount;
+    uint32_t m_nRed;
+    uint32_t m_nGreen;
+    uint32_t m_nBlue;
+    uint32_t m_nMaxPower_mW;
+    CLEDPowerModel m_Model;
+};
+
+/// @} PowerAccount
+
+
 /// @name Power Control Internal Helper Functions
 /// Internal helper functions for power control.
 /// @{
@@ -68,6 +199,13 @@ void delay_at_max_brightness_for_power( uint16_t ms);
 /// @returns the number of milliwatts the LED data would consume at max brightness
 uint32_t calculate_unscaled_power_mW( const CRGB* ledbuffer, uint16_t numLeds);
 
+/// @copybrief calculate_unscaled_power_mW(const CRGB*, uint16_t)
+/// @param ledbuffer the LED data to check
+/// @param numLeds the number of LEDs in the data array
+/// @param model the power draw of the strip the data is shown on
+/// @returns the number of milliwatts the LED data would consume at max brightness
+uint32_t calculate_unscaled_power_mW( const CRGB* ledbuffer, uint16_t numLeds, const CLEDPowerModel& model);
+
 /// Determines the highest brightness level you can use and still stay under
 /// the specified power budget for a given set of LEDs.
 /// @param ledbuffer the LED data to check
@@ -0,0 +1,61 @@
+/// @file bench.h
+/// Minimal timing helpers shared by the host benchmarks
+
+#ifndef __INC_BENCH_H
+#define __INC_BENCH_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/// Wall-clock time in nanoseconds; the benchmarks never switch the host
+/// clock to virtual time, but they don't rely on it either
+static inline uint64_t benchNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// Keep the data behind a pointer alive, so the compiler can't drop the
+/// work that produced it
+static inline void benchKeep(const void *p) {
+    __asm__ __volatile__("" : : "g"(p) : "memory");
+}
+
+/// Time a function, repeating it for at least 100 ms after a warm-up call
+/// @returns the average time per call in nanoseconds
+template<typename FUNC>
+static double benchRun(FUNC fn) {
+    fn();
+    uint64_t calls = 0;
+    uint64_t start = benchNanos();
+    uint64_t elapsed;
+    do {
+        for(int i = 0; i < 16; ++i) { fn(); }
+        calls += 16;
+        elapsed = benchNanos() - start;
+    } while(elapsed < 100000000ULL);
+    return (double)elapsed / calls;
+}
+
+/// Print one result line: time per call, and items per second for `items` items per call
+static inline void benchReport(const char *name, double nsPerCall, uint32_t items, const char *unit) {
+    printf("%-40s %10.1f ns/call %9.2f M%s/s\n", name, nsPerCall, items * 1000.0 / nsPerCall, unit);
+}
+
+/// Rate of the CPU's cycle counter in cycles per nanosecond, measured over
+/// 20 ms, for results in cycles; 0 where there is no counter to read
+static inline double benchCyclesPerNano() {
+#if defined(__x86_64__) || defined(__i386__)
+    uint64_t start = benchNanos();
+    uint64_t cycles = __rdtsc();
+    while(benchNanos() - start < 20000000ULL) {}
+    return (double)(__rdtsc() - cycles) / (benchNanos() - start);
+#else
+    return 0;
+#endif
+}
+
+#endif
@@ -0,0 +1,46 @@
+/// @file bench_blur.cpp
+/// Times blur1d(), and blur2d() through a mapping table against blur2d()
+/// through XY(), on serpentine matrices from 16x16 to 255x255
+
+#include "FastLED.h"
+#include "bench.h"
+
+#define MAX_SIZE 255
+
+static uint8_t gWidth;
+static CRGB leds[MAX_SIZE * MAX_SIZE];
+static uint16_t xymap[MAX_SIZE * MAX_SIZE];
+
+uint16_t XY(uint8_t x, uint8_t y) {
+    return (y & 1) ? (uint16_t)y * gWidth + (gWidth - 1 - x) : (uint16_t)y * gWidth + x;
+}
+
+int main() {
+    for(uint32_t i = 0; i < MAX_SIZE * MAX_SIZE; ++i) { leds[i] = CRGB(i * 7, i * 13, i * 29); }
+
+    benchReport("blur1d, 255 LEDs", benchRun([] {
+        blur1d(leds, 255, 64);
+        benchKeep(leds);
+    }), 255, "px");
+
+    const uint8_t sizes[5] = { 16, 32, 64, 128, 255 };
+    for(int s = 0; s < 5; ++s) {
+        uint8_t size = sizes[s];
+        uint32_t n = (uint32_t)size * size;
+        gWidth = size;
+        fill_xymap(xymap, size, size);
+
+        char name[64];
+        snprintf(name, sizeof(name), "blur2d XY(), %dx%d", size, size);
+        benchReport(name, benchRun([size] {
+            blur2d(leds, size, size, 64);
+            benchKeep(leds);
+        }), n, "px");
+        snprintf(name, sizeof(name), "blur2d xymap, %dx%d", size, size);
+        benchReport(name, benchRun([size] {
+            blur2d(leds, size, size, 64, xymap);
+            benchKeep(leds);
+        }), n, "px");
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+/// @file bench_gamma.cpp
+/// Times napplyGamma_video() on arrays against the per-pixel
+/// applyGamma_video() loop it replaces, around the table thresholds: past
+/// 85 pixels with one gamma, and past 256 pixels with three
+
+#include "FastLED.h"
+#include "bench.h"
+
+#define MAX_LEDS 1024
+
+static CRGB leds[MAX_LEDS];
+static CRGB src[MAX_LEDS];
+
+int main() {
+    for(int i = 0; i < MAX_LEDS; ++i) { src[i] = CRGB(i * 7, i * 13, i * 29); }
+
+    const uint16_t counts[7] = { 16, 64, 85, 128, 256, 512, 1024 };
+    for(int n = 0; n < 7; ++n) {
+        uint16_t count = counts[n];
+        char name[64];
+
+        snprintf(name, sizeof(name), "per pixel, 1 gamma, %d", count);
+        benchReport(name, benchRun([count] {
+            memcpy(leds, src, count * sizeof(CRGB));
+            for(uint16_t i = 0; i < count; ++i) { leds[i] = applyGamma_video(leds[i], 2.2f); }
+            benchKeep(leds);
+        }), count, "px");
+        snprintf(name, sizeof(name), "napplyGamma_video, 1 gamma, %d", count);
+        benchReport(name, benchRun([count] {
+            memcpy(leds, src, count * sizeof(CRGB));
+            napplyGamma_video(leds, count, 2.2f);
+            benchKeep(leds);
+        }), count, "px");
+
+        snprintf(name, sizeof(name), "per pixel, 3 gammas, %d", count);
+        benchReport(name, benchRun([count] {
+            memcpy(leds, src, count * sizeof(CRGB));
+            for(uint16_t i = 0; i < count; ++i) { leds[i] = applyGamma_video(leds[i], 2.2f, 2.5f, 2.8f); }
+            benchKeep(leds);
+        }), count, "px");
+        snprintf(name, sizeof(name), "napplyGamma_video, 3 gammas, %d", count);
+        benchReport(name, benchRun([count] {
+            memcpy(leds, src, count * sizeof(CRGB));
+            napplyGamma_video(leds, count, 2.2f, 2.5f, 2.8f);
+            benchKeep(leds);
+        }), count, "px");
+    }
+
+    // a table built once and kept, as CRGBGammaTable is meant to be used
+    static CRGBGammaTable table(2.2f, 2.5f, 2.8f);
+    benchReport("CRGBGammaTable::apply, 1024", benchRun([] {
+        memcpy(leds, src, sizeof(leds));
+        table.apply(leds, MAX_LEDS);
+        benchKeep(leds);
+    }), MAX_LEDS, "px");
+    return 0;
+}
@@ -0,0 +1,37 @@
+/// @file bench_hsv2rgb.cpp
+/// Times the table-driven batch hsv2rgb_rainbow() against a loop over the
+/// single-pixel conversion, which is what the array version used to be
+
+#include "FastLED.h"
+#include "test_check.h"
+#include "bench.h"
+
+#define NUM_LEDS 256
+
+static CHSV hsv[NUM_LEDS];
+static CRGB rgb[NUM_LEDS];
+
+static void benchPair(const char *what) {
+    char name[64];
+    snprintf(name, sizeof(name), "per-pixel, %s", what);
+    benchReport(name, benchRun([] {
+        for(int i = 0; i < NUM_LEDS; ++i) { hsv2rgb_rainbow(hsv[i], rgb[i]); }
+        benchKeep(rgb);
+    }), NUM_LEDS, "px");
+    snprintf(name, sizeof(name), "batch, %s", what);
+    benchReport(name, benchRun([] {
+        hsv2rgb_rainbow(hsv, rgb, NUM_LEDS);
+        benchKeep(rgb);
+    }), NUM_LEDS, "px");
+}
+
+int main() {
+    // a rainbow at full saturation and brightness, the common case
+    for(int i = 0; i < NUM_LEDS; ++i) { hsv[i] = CHSV(i, 255, 255); }
+    benchPair("rainbow");
+
+    // random hues, saturations and values, so nothing is predictable
+    for(int i = 0; i < NUM_LEDS; ++i) { hsv[i] = CHSV(testRandom8(), testRandom8(), testRandom8()); }
+    benchPair("random");
+    return 0;
+}
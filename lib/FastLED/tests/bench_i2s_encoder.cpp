@@ -0,0 +1,108 @@
+/// @file bench_i2s_encoder.cpp
+/// Times the ESP32 I2SParallelEncoder against a naive bit-by-bit encoder,
+/// for 1 to 24 strips of 300 pixels with 10 pulses per bit. On SSE2 hosts
+/// it also times a movemask transpose, to show what a vector path would
+/// give on a CPU that has one; the ESP32 the driver runs on does not.
+
+#include <stdio.h>
+#include <stdint.h>
+#include "bench.h"
+#include "platforms/esp/32/i2s_encoder_esp32.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define NUM_PIXELS 300
+#define NUM_COLOR_CHANNELS 3
+#define PULSES_PER_BIT 10
+#define ONES_FOR_ZERO 3
+#define ONES_FOR_ONE 7
+
+static uint8_t rows[NUM_PIXELS][NUM_COLOR_CHANNELS][I2S_MAX_LANES];
+static volatile uint32_t buf[NUM_COLOR_CHANNELS * 8 * PULSES_PER_BIT];
+static uint32_t gMask;
+
+static void naiveFrame() {
+    for(int pixel = 0; pixel < NUM_PIXELS; ++pixel) {
+        for(int c = 0; c < NUM_COLOR_CHANNELS; ++c) {
+            const uint8_t *lanes = rows[pixel][c];
+            for(int b = 0; b < 8; ++b) {
+                uint32_t word = 0;
+                for(int i = 0; i < I2S_MAX_LANES; ++i) {
+                    word |= (uint32_t)((lanes[i] >> (7 - b)) & 1) << (i + 8);
+                }
+                word &= gMask;
+                volatile uint32_t *pulses = buf + (c * 8 + b) * PULSES_PER_BIT;
+                for(int p = ONES_FOR_ZERO; p < ONES_FOR_ONE; ++p) { pulses[p] = word; }
+            }
+        }
+    }
+}
+
+static void encoderFrame() {
+    for(int pixel = 0; pixel < NUM_PIXELS; ++pixel) {
+        for(int c = 0; c < NUM_COLOR_CHANNELS; ++c) {
+            uint32_t bits[8];
+            I2SParallelEncoder::transpose24(rows[pixel][c], bits);
+            I2SParallelEncoder::encode(bits, gMask, buf + c * 8 * PULSES_PER_BIT, PULSES_PER_BIT, ONES_FOR_ZERO, ONES_FOR_ONE);
+        }
+    }
+}
+
+#if defined(__SSE2__)
+/// transpose24() with SSE2: movemask picks the top bit of every byte
+static void transpose24Sse2(const uint8_t *lanes, uint32_t *bits) {
+    __m128i lo = _mm_loadu_si128((const __m128i*)lanes);
+    __m128i hi = _mm_loadl_epi64((const __m128i*)(lanes + 16));
+    for(int b = 0; b < 8; ++b) {
+        bits[b] = ((uint32_t)_mm_movemask_epi8(lo) | ((uint32_t)_mm_movemask_epi8(hi) << 16)) << 8;
+        lo = _mm_add_epi8(lo, lo);
+        hi = _mm_add_epi8(hi, hi);
+    }
+}
+
+static void sse2Frame() {
+    for(int pixel = 0; pixel < NUM_PIXELS; ++pixel) {
+        for(int c = 0; c < NUM_COLOR_CHANNELS; ++c) {
+            uint32_t bits[8];
+            transpose24Sse2(rows[pixel][c], bits);
+            I2SParallelEncoder::encode(bits, gMask, buf + c * 8 * PULSES_PER_BIT, PULSES_PER_BIT, ONES_FOR_ZERO, ONES_FOR_ONE);
+        }
+    }
+}
+#endif
+
+int main() {
+    for(int pixel = 0; pixel < NUM_PIXELS; ++pixel) {
+        for(int c = 0; c < NUM_COLOR_CHANNELS; ++c) {
+            for(int i = 0; i < I2S_MAX_LANES; ++i) { rows[pixel][c][i] = (uint8_t)(pixel * 7 + c * 13 + i * 29); }
+        }
+    }
+#if defined(__SSE2__)
+    for(int c = 0; c < NUM_COLOR_CHANNELS; ++c) {
+        uint32_t a[8], b[8];
+        I2SParallelEncoder::transpose24(rows[1][c], a);
+        transpose24Sse2(rows[1][c], b);
+        for(int i = 0; i < 8; ++i) {
+            if(a[i] != b[i]) { printf("SSE2 transpose mismatch\n"); return 1; }
+        }
+    }
+#endif
+
+    // the work per pixel doesn't depend on the lane count, only the output does
+    const int lanes[4] = { 1, 8, 16, 24 };
+    for(int n = 0; n < 4; ++n) {
+        gMask = ((1UL << lanes[n]) - 1) << 8;
+        uint32_t items = (uint32_t)lanes[n] * NUM_PIXELS;
+        char name[64];
+        snprintf(name, sizeof(name), "naive, %d lanes", lanes[n]);
+        benchReport(name, benchRun(naiveFrame), items, "lane-px");
+        snprintf(name, sizeof(name), "I2SParallelEncoder, %d lanes", lanes[n]);
+        benchReport(name, benchRun(encoderFrame), items, "lane-px");
+#if defined(__SSE2__)
+        snprintf(name, sizeof(name), "SSE2 movemask, %d lanes", lanes[n]);
+        benchReport(name, benchRun(sse2Frame), items, "lane-px");
+#endif
+    }
+    return 0;
+}
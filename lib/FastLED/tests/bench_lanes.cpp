@@ -0,0 +1,69 @@
+/// @file bench_lanes.cpp
+/// Times the packed-lane array kernels against the per-pixel CRGB member
+/// loops they replace, on 300 LEDs
+
+#include "FastLED.h"
+#include "bench.h"
+
+#define NUM_LEDS 300
+
+static CRGB leds[NUM_LEDS];
+static CRGB over[NUM_LEDS];
+static CRGB dest[NUM_LEDS];
+
+int main() {
+    for(int i = 0; i < NUM_LEDS; ++i) {
+        leds[i] = CRGB(i * 7, i * 13, i * 29);
+        over[i] = CRGB(i * 31, i * 3, i * 17);
+    }
+
+    // the scale varies from call to call, so that nothing is folded, and
+    // it never reaches 0 or 255, so that the LEDs keep their values
+    static uint8_t scale = 200;
+    #define NEXT_SCALE() (scale = (scale == 250) ? 200 : scale + 1)
+
+    benchReport("CRGB::nscale8 loop", benchRun([] {
+        NEXT_SCALE();
+        for(int i = 0; i < NUM_LEDS; ++i) { leds[i].nscale8(scale); }
+        benchKeep(leds);
+    }), NUM_LEDS, "px");
+    benchReport("nscale8", benchRun([] {
+        NEXT_SCALE();
+        nscale8(leds, NUM_LEDS, scale);
+        benchKeep(leds);
+    }), NUM_LEDS, "px");
+
+    benchReport("CRGB::nscale8_video loop", benchRun([] {
+        NEXT_SCALE();
+        for(int i = 0; i < NUM_LEDS; ++i) { leds[i].nscale8_video(scale); }
+        benchKeep(leds);
+    }), NUM_LEDS, "px");
+    benchReport("nscale8_video", benchRun([] {
+        NEXT_SCALE();
+        nscale8_video(leds, NUM_LEDS, scale);
+        benchKeep(leds);
+    }), NUM_LEDS, "px");
+
+    benchReport("nblend(CRGB&) loop", benchRun([] {
+        NEXT_SCALE();
+        for(int i = 0; i < NUM_LEDS; ++i) { nblend(leds[i], over[i], scale); }
+        benchKeep(leds);
+    }), NUM_LEDS, "px");
+    benchReport("nblend", benchRun([] {
+        NEXT_SCALE();
+        nblend(leds, over, NUM_LEDS, scale);
+        benchKeep(leds);
+    }), NUM_LEDS, "px");
+
+    benchReport("blend(CRGB) loop", benchRun([] {
+        NEXT_SCALE();
+        for(int i = 0; i < NUM_LEDS; ++i) { dest[i] = blend(leds[i], over[i], scale); }
+        benchKeep(dest);
+    }), NUM_LEDS, "px");
+    benchReport("blend", benchRun([] {
+        NEXT_SCALE();
+        blend(leds, over, dest, NUM_LEDS, scale);
+        benchKeep(dest);
+    }), NUM_LEDS, "px");
+    return 0;
+}
@@ -0,0 +1,55 @@
+/// @file bench_noise_batch.cpp
+/// Times inoise16_batch() / inoise8_batch() against a loop over the
+/// scalar inoise16() / inoise8(), for scattered and for clustered points
+
+#include "FastLED.h"
+#include "test_check.h"
+#include "bench.h"
+
+#define COUNT 1024
+
+static uint32_t xs[COUNT], ys[COUNT], zs[COUNT];
+static uint16_t xs8[COUNT], ys8[COUNT], zs8[COUNT];
+static uint16_t out16[COUNT];
+static uint8_t out8[COUNT];
+
+static void benchPoints(const char *what) {
+    char name[64];
+    snprintf(name, sizeof(name), "inoise16 scalar, %s", what);
+    benchReport(name, benchRun([] {
+        for(int i = 0; i < COUNT; ++i) { out16[i] = inoise16(xs[i], ys[i], zs[i]); }
+        benchKeep(out16);
+    }), COUNT, "pt");
+    snprintf(name, sizeof(name), "inoise16_batch, %s", what);
+    benchReport(name, benchRun([] {
+        inoise16_batch(xs, ys, zs, out16, COUNT);
+        benchKeep(out16);
+    }), COUNT, "pt");
+
+    snprintf(name, sizeof(name), "inoise8 scalar, %s", what);
+    benchReport(name, benchRun([] {
+        for(int i = 0; i < COUNT; ++i) { out8[i] = inoise8(xs8[i], ys8[i], zs8[i]); }
+        benchKeep(out8);
+    }), COUNT, "pt");
+    snprintf(name, sizeof(name), "inoise8_batch, %s", what);
+    benchReport(name, benchRun([] {
+        inoise8_batch(xs8, ys8, zs8, out8, COUNT);
+        benchKeep(out8);
+    }), COUNT, "pt");
+}
+
+int main() {
+    for(int i = 0; i < COUNT; ++i) {
+        xs[i] = testRandom(); ys[i] = testRandom(); zs[i] = testRandom();
+        xs8[i] = testRandom(); ys8[i] = testRandom(); zs8[i] = testRandom();
+    }
+    benchPoints("scattered");
+
+    // a 32x32 grid at one time, as when sampling an LED matrix
+    for(int i = 0; i < COUNT; ++i) {
+        xs[i] = 0x10000000UL + (i % 32) * 0x0C00; ys[i] = 0x20000000UL + (i / 32) * 0x0C00; zs[i] = 0x30000000UL;
+        xs8[i] = (i % 32) * 12; ys8[i] = (i / 32) * 12; zs8[i] = 0x3000;
+    }
+    benchPoints("grid");
+    return 0;
+}
@@ -0,0 +1,44 @@
+/// @file bench_noise_field.cpp
+/// Times CNoiseField16 against calling inoise16() per pixel, for square
+/// grids from 16x16 to 128x128, one animation frame (a new time) per call
+
+#include "FastLED.h"
+#include "bench.h"
+
+#define MAX_SIZE 128
+
+static uint16_t data[MAX_SIZE * MAX_SIZE];
+static NoiseAxis16 xaxis[MAX_SIZE];
+static NoiseAxis16 yaxis[MAX_SIZE];
+
+int main() {
+    const uint32_t x = 0x12345678, y = 0x9ABCDEF0;
+    const int32_t scale = 0x0C00;  // a dozen pixels per noise cell
+
+    for(uint16_t size = 16; size <= MAX_SIZE; size *= 2) {
+        char name[64];
+        uint32_t time = 0;
+        snprintf(name, sizeof(name), "inoise16 per pixel, %dx%d", size, size);
+        benchReport(name, benchRun([&] {
+            time += 0x100;
+            for(uint16_t i = 0; i < size; ++i) {
+                for(uint16_t j = 0; j < size; ++j) {
+                    data[i * size + j] = inoise16(x + j * scale, y + i * scale, time);
+                }
+            }
+            benchKeep(data);
+        }), size * size, "px");
+
+        CNoiseField16 field(xaxis, size, yaxis, size);
+        field.setX(x, scale);
+        field.setY(y, scale);
+        snprintf(name, sizeof(name), "CNoiseField16, %dx%d", size, size);
+        benchReport(name, benchRun([&] {
+            time += 0x100;
+            field.setTime(time);
+            field.fillRows(data, 0, size);
+            benchKeep(data);
+        }), size * size, "px");
+    }
+    return 0;
+}
@@ -0,0 +1,49 @@
+/// @file bench_palette_cache.cpp
+/// Times CRGBPaletteCache against ColorFromPalette() for a palette fill,
+/// and what a rebuild costs when the palette changes
+
+#include "FastLED.h"
+#include "test_check.h"
+#include "bench.h"
+
+#define NUM_LEDS 256
+
+static CRGB leds[NUM_LEDS];
+static CRGBPalette16 palette;
+static CRGBPaletteCache cache;
+
+static void benchBlend(TBlendType blendType, const char *what) {
+    char name[64];
+    snprintf(name, sizeof(name), "fill_palette, %s", what);
+    benchReport(name, benchRun([blendType] {
+        fill_palette(leds, NUM_LEDS, 0, 3, palette, 200, blendType);
+        benchKeep(leds);
+    }), NUM_LEDS, "px");
+
+    snprintf(name, sizeof(name), "cache fillFromPalette, %s", what);
+    cache.update(palette, 200, blendType);
+    benchReport(name, benchRun([] {
+        cache.fillFromPalette(leds, NUM_LEDS, 0, 3);
+        benchKeep(leds);
+    }), NUM_LEDS, "px");
+
+    snprintf(name, sizeof(name), "cache update, unchanged, %s", what);
+    benchReport(name, benchRun([blendType] {
+        cache.update(palette, 200, blendType);
+        benchKeep(cache.entries);
+    }), 1, "call");
+
+    snprintf(name, sizeof(name), "cache update, rebuilt, %s", what);
+    benchReport(name, benchRun([blendType] {
+        cache.invalidate();
+        cache.update(palette, 200, blendType);
+        benchKeep(cache.entries);
+    }), 1, "call");
+}
+
+int main() {
+    for(int i = 0; i < 16; ++i) { palette.entries[i] = CRGB(testRandom8(), testRandom8(), testRandom8()); }
+    benchBlend(LINEARBLEND, "LINEARBLEND");
+    benchBlend(NOBLEND, "NOBLEND");
+    return 0;
+}
@@ -0,0 +1,57 @@
+/// @file bench_rmt_encoder.cpp
+/// Times the ESP32 RMTNibbleEncoder against the bit-by-bit encoding it
+/// replaced, for a 300 LED strip, both into a whole-strip buffer and in
+/// the 32-item chunks of a half RMT memory block
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "bench.h"
+#include "platforms/esp/32/rmt_encoder_esp32.h"
+
+#define NUM_BYTES (300 * 3)
+
+static uint8_t data[NUM_BYTES];
+static uint32_t items[NUM_BYTES * 8];
+static uint32_t zeroVal = 0x00200050;
+static uint32_t oneVal = 0x00500020;
+static RMTNibbleEncoder encoder;
+
+static void report(const char *name, double ns, double cyclesPerNano) {
+    benchReport(name, ns, NUM_BYTES, "B");
+    if(cyclesPerNano > 0) { printf("%-40s %10.2f cycles/byte\n", "", ns * cyclesPerNano / NUM_BYTES); }
+}
+
+int main() {
+    for(int i = 0; i < NUM_BYTES; ++i) { data[i] = (uint8_t)(i * 37); }
+    encoder.init(zeroVal, oneVal);
+    double cyclesPerNano = benchCyclesPerNano();
+
+    report("bit loop", benchRun([] {
+        uint32_t *pItem = items;
+        for(int i = 0; i < NUM_BYTES; ++i) {
+            uint32_t byteval = (uint32_t)data[i] << 24;
+            for(uint32_t j = 0; j < 8; j++) {
+                *pItem++ = (byteval & 0x80000000L) ? oneVal : zeroVal;
+                byteval <<= 1;
+            }
+        }
+        benchKeep(items);
+    }), cyclesPerNano);
+
+    report("RMTNibbleEncoder::encode", benchRun([] {
+        encoder.encode(data, NUM_BYTES, items);
+        benchKeep(items);
+    }), cyclesPerNano);
+
+    report("RMTNibbleEncoder::translate, 32 items", benchRun([] {
+        size_t src = 0;
+        while(src < NUM_BYTES) {
+            size_t itemNum;
+            // as the driver refills half a memory block at a time
+            src += encoder.translate(data + src, NUM_BYTES - src, items, 32, &itemNum);
+            benchKeep(items);
+        }
+    }), cyclesPerNano);
+    return 0;
+}
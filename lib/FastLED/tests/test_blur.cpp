@@ -0,0 +1,93 @@
+/// @file test_blur.cpp
+/// Checks the packed-lane blur1d() and the table-mapped blur2d() against
+/// blurRows() / blurColumns(), which still do the per-pixel CRGB math
+/// through XY()
+
+#include <stdlib.h>
+#include "FastLED.h"
+#include "test_check.h"
+
+#define MAX_WIDTH 255
+#define MAX_HEIGHT 24
+
+enum ELayout { ROW_MAJOR, SERPENTINE, SHUFFLED };
+
+static uint8_t gWidth;
+static uint8_t gHeight;
+static ELayout gLayout;
+static uint16_t gShuffle[MAX_WIDTH * MAX_HEIGHT];
+
+uint16_t XY(uint8_t x, uint8_t y) {
+    uint16_t i = (uint16_t)y * gWidth + x;
+    switch(gLayout) {
+    case SERPENTINE: return (y & 1) ? (uint16_t)y * gWidth + (gWidth - 1 - x) : i;
+    case SHUFFLED: return gShuffle[i];
+    default: return i;
+    }
+}
+
+static void setLayout(uint8_t width, uint8_t height, ELayout layout) {
+    gWidth = width;
+    gHeight = height;
+    gLayout = layout;
+    uint16_t n = (uint16_t)width * height;
+    for(uint16_t i = 0; i < n; ++i) { gShuffle[i] = i; }
+    for(uint16_t i = n; i > 1; --i) {
+        uint16_t j = testRandom() % i;
+        uint16_t t = gShuffle[i - 1]; gShuffle[i - 1] = gShuffle[j]; gShuffle[j] = t;
+    }
+}
+
+static void randomFill(CRGB *leds, int count) {
+    for(int i = 0; i < count; ++i) {
+        // mostly bright, so that the saturating adds get exercised
+        uint8_t r = testRandom8();
+        leds[i] = (r & 3) ? CRGB(testRandom8() | 0xC0, testRandom8(), testRandom8() | 0x80) : CRGB(r, 0, 255);
+    }
+}
+
+/// blur1d() against blurRows() on a single row-major row
+static void testBlur1d() {
+    for(int width = 1; width <= 255; width += (width < 8) ? 1 : 31) {
+        setLayout(width, 1, ROW_MAJOR);
+        for(int amount = 0; amount < 256; amount += 17) {
+            CRGB fast[255], ref[255];
+            randomFill(ref, width);
+            memcpy(fast, ref, width * sizeof(CRGB));
+            blur1d(fast, width, amount);
+            blurRows(ref, width, 1, amount);
+            for(int i = 0; i < width; ++i) { CHECK(fast[i] == ref[i]); }
+        }
+    }
+}
+
+/// blur2d() through a mapping table against blur2d() through XY()
+static void testBlur2d() {
+    // 33 and 255 wide leave a partial column tile at the right edge
+    const uint8_t sizes[8][2] = { { 1, 1 }, { 1, 7 }, { 7, 1 }, { 2, 2 }, { 16, 16 }, { 40, 24 }, { 33, 5 }, { MAX_WIDTH, 3 } };
+    for(int s = 0; s < 8; ++s) {
+        for(int layout = ROW_MAJOR; layout <= SHUFFLED; ++layout) {
+            setLayout(sizes[s][0], sizes[s][1], (ELayout)layout);
+            uint16_t n = (uint16_t)gWidth * gHeight;
+            uint16_t xymap[MAX_WIDTH * MAX_HEIGHT];
+            fill_xymap(xymap, gWidth, gHeight);
+            for(uint16_t i = 0; i < n; ++i) { CHECK(xymap[i] == XY(i % gWidth, i / gWidth)); }
+
+            for(int amount = 0; amount < 256; amount += 15) {
+                CRGB fast[MAX_WIDTH * MAX_HEIGHT], ref[MAX_WIDTH * MAX_HEIGHT];
+                randomFill(ref, n);
+                memcpy(fast, ref, n * sizeof(CRGB));
+                blur2d(fast, gWidth, gHeight, amount, xymap);
+                blur2d(ref, gWidth, gHeight, amount);
+                for(uint16_t i = 0; i < n; ++i) { CHECK(fast[i] == ref[i]); }
+            }
+        }
+    }
+}
+
+int main() {
+    testBlur1d();
+    testBlur2d();
+    if(failures == 0) { printf("all passed\n"); }
+    return failures ? 1 : 0;
+}
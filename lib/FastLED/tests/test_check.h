@@ -0,0 +1,29 @@
+/// @file test_check.h
+/// Minimal check macro shared by the host tests
+
+#ifndef __INC_TEST_CHECK_H
+#define __INC_TEST_CHECK_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/// Number of failed checks; main() returns non-zero if any failed
+static int failures = 0;
+
+/// Report a failed condition with its location, and carry on
+#define CHECK(cond) do { if(!(cond)) { printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); ++failures; } } while(0)
+
+/// Small deterministic random number generator (xorshift32), so that
+/// failures reproduce on every platform
+static uint32_t testRandomState = 2463534242UL;
+
+static inline uint32_t testRandom() {
+    testRandomState ^= testRandomState << 13;
+    testRandomState ^= testRandomState >> 17;
+    testRandomState ^= testRandomState << 5;
+    return testRandomState;
+}
+
+static inline uint8_t testRandom8() { return (uint8_t)(testRandom() >> 24); }
+
+#endif
@@ -0,0 +1,159 @@
+/// @file test_dither.cpp
+/// Checks the BINARY_DITHER frame-rate gate against frame intervals swept
+/// across FASTLED_DITHER_ON_FPS / FASTLED_DITHER_OFF_FPS, and measures the
+/// mean brightness error of each dither mode over a run of frames
+
+#include <math.h>
+#include "FastLED.h"
+#include "test_check.h"
+
+#define NUM_LEDS 64
+#define DATA_PIN 5
+#define FRAMES 64  // a whole number of dither cycles
+
+static CRGB leds[NUM_LEDS];
+static CLEDController *pController;
+static CHostRecorder *pRecorder;
+static uint32_t wireMicros;
+static int toggles;
+
+/// show() with frames spaced `interval` microseconds apart, counting how
+/// often the gate switches
+static void showAt(uint32_t interval) {
+    bool dithering = FastLED.isDithering();
+    delayMicroseconds(interval - wireMicros);
+    FastLED.show();
+    if(FastLED.isDithering() != dithering) { ++toggles; }
+}
+
+static void testGate() {
+    const uint32_t onMicros = 1000000UL / FASTLED_DITHER_ON_FPS;
+    const uint32_t offMicros = 1000000UL / FASTLED_DITHER_OFF_FPS;
+
+    // slow frames: off
+    for(int i = 0; i < 50; ++i) { showAt(20000); }
+    CHECK(!FastLED.isDithering());
+
+    // sweep the frame rate up from 50fps to 200fps and back down, one
+    // microsecond per frame: the gate switches on once, and off once
+    toggles = 0;
+    bool wasOn = false;
+    uint32_t onAt = 0, offAt = 0;
+    for(uint32_t interval = 20000; interval > 5000; interval -= 1) {
+        showAt(interval);
+        if(FastLED.isDithering() && !wasOn) { onAt = interval; wasOn = true; }
+    }
+    CHECK(FastLED.isDithering());
+    for(uint32_t interval = 5000; interval < 20000; interval += 1) {
+        showAt(interval);
+        if(!FastLED.isDithering() && wasOn) { offAt = interval; wasOn = false; }
+    }
+    CHECK(!FastLED.isDithering());
+    CHECK(toggles == 2);
+    // the smoothing lags a slow sweep by a few frames at most
+    CHECK(onAt < onMicros && onAt > onMicros - 20);
+    CHECK(offAt > offMicros && offAt < offMicros + 20);
+    printf("gate: on at %u us (%u fps), off at %u us (%u fps)\n",
+           (unsigned)onAt, (unsigned)(1000000UL / onAt), (unsigned)offAt, (unsigned)(1000000UL / offAt));
+
+    // frame times jittering anywhere between the two thresholds don't
+    // switch it either way
+    const bool start[2] = { false, true };
+    for(int s = 0; s < 2; ++s) {
+        // get into the band from the side that leaves the gate as wanted
+        for(int i = 0; i < 50; ++i) { showAt(start[s] ? 5000 : 20000); }
+        CHECK(FastLED.isDithering() == start[s]);
+        toggles = 0;
+        for(int i = 0; i < 5000; ++i) { showAt(onMicros + 10 + testRandom() % (offMicros - onMicros - 20)); }
+        CHECK(toggles == 0);
+    }
+
+    // and neither do single slow frames among fast ones
+    for(int i = 0; i < 50; ++i) { showAt(5000); }
+    toggles = 0;
+    for(int i = 0; i < 1000; ++i) { showAt((i % 20 == 0) ? 50000 : 5000); }
+    CHECK(toggles == 0);
+}
+
+struct SError {
+    double mean;      ///< mean signed error, in output steps
+    double meanAbs;   ///< mean absolute error, in output steps
+};
+
+/// Average the recorded output over FRAMES frames at a brightness, shown
+/// `interval` microseconds apart, against the exact scaled value
+static SError measure(EDitherMode mode, uint32_t interval, uint8_t brightness) {
+    pController->setDither(mode);
+    // let the gate settle at this frame rate first
+    for(int i = 0; i < 50; ++i) { showAt(interval); }
+
+    static double sums[NUM_LEDS * 3];
+    for(int i = 0; i < NUM_LEDS * 3; ++i) { sums[i] = 0; }
+    FastLED.setBrightness(brightness);
+    for(int f = 0; f < FRAMES; ++f) {
+        showAt(interval);
+        const uint8_t *frame = pRecorder->getFrame();
+        for(int i = 0; i < NUM_LEDS * 3; ++i) { sums[i] += frame[i]; }
+    }
+    FastLED.setBrightness(255);
+
+    SError err = { 0, 0 };
+    for(int i = 0; i < NUM_LEDS; ++i) {
+        for(int c = 0; c < 3; ++c) {
+            // scale8() with FASTLED_SCALE8_FIXED is v * (scale + 1) / 256
+            double exact = leds[i].raw[c] * (brightness + 1) / 256.0;
+            double e = sums[i * 3 + c] / FRAMES - exact;
+            err.mean += e;
+            err.meanAbs += fabs(e);
+        }
+    }
+    err.mean /= NUM_LEDS * 3;
+    err.meanAbs /= NUM_LEDS * 3;
+    return err;
+}
+
+static void testBrightnessError() {
+    // every LED a different level, so that all the rounding cases come up
+    for(int i = 0; i < NUM_LEDS; ++i) { leds[i] = CRGB(4 * i + 1, 4 * i + 2, 4 * i + 3); }
+
+    const uint8_t brightnesses[4] = { 16, 48, 100, 200 };
+    printf("%-24s %10s %12s %12s\n", "mode", "brightness", "mean error", "mean |error|");
+    for(int b = 0; b < 4; ++b) {
+        uint8_t brightness = brightnesses[b];
+        SError off = measure(DISABLE_DITHER, 5000, brightness);
+        SError binaryFast = measure(BINARY_DITHER, 5000, brightness);
+        SError binarySlow = measure(BINARY_DITHER, 20000, brightness);
+        SError temporalSlow = measure(TEMPORAL_DITHER, 20000, brightness);
+        printf("%-24s %10d %12.3f %12.3f\n", "DISABLE_DITHER", brightness, off.mean, off.meanAbs);
+        printf("%-24s %10d %12.3f %12.3f\n", "BINARY_DITHER, 200fps", brightness, binaryFast.mean, binaryFast.meanAbs);
+        printf("%-24s %10d %12.3f %12.3f\n", "BINARY_DITHER, 50fps", brightness, binarySlow.mean, binarySlow.meanAbs);
+        printf("%-24s %10d %12.3f %12.3f\n", "TEMPORAL_DITHER, 50fps", brightness, temporalSlow.mean, temporalSlow.meanAbs);
+
+        // without dithering the output is truncated: half a step low on average
+        CHECK(off.mean < -0.3 && off.mean > -0.7);
+        // gated off, BINARY_DITHER is no dithering at all
+        CHECK(binarySlow.mean == off.mean && binarySlow.meanAbs == off.meanAbs);
+        // TEMPORAL_DITHER is the same dither as BINARY_DITHER, without the gate
+        CHECK(temporalSlow.mean == binaryFast.mean && temporalSlow.meanAbs == binaryFast.meanAbs);
+        // dithering takes the bias out; the dither only spans 256 / brightness
+        // of the input, so it does most for the absolute error at low brightness
+        CHECK(fabs(binaryFast.mean) < fabs(off.mean) / 4);
+        CHECK(binaryFast.meanAbs < ((brightness < 64) ? off.meanAbs / 2 : off.meanAbs));
+    }
+}
+
+int main() {
+    CHostClock::setMicros(1000000);
+    pController = &FastLED.addLeds<WS2812B, DATA_PIN, GRB>(leds, NUM_LEDS);
+    pRecorder = CHostRecorder::forPin(DATA_PIN);
+    CHECK(pRecorder != NULL);
+    if(pRecorder == NULL) { return 1; }
+
+    FastLED.show();
+    wireMicros = micros() - pRecorder->getFrameMicros();
+
+    testGate();
+    testBrightnessError();
+    if(failures == 0) { printf("all passed\n"); }
+    return failures ? 1 : 0;
+}
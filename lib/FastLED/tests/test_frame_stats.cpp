@@ -0,0 +1,155 @@
+/// @file test_frame_stats.cpp
+/// Checks the FASTLED_FRAME_STATS counters on the virtual clock: the phase
+/// timings of FastLED.show(), the per-controller times, the frame history
+/// and the text from formatFrameStats(). Built against a library compiled
+/// with FASTLED_FRAME_STATS=1.
+
+#include "FastLED.h"
+#include "test_check.h"
+
+#if (FASTLED_FRAME_STATS != 1)
+#error test_frame_stats has to be built with FASTLED_FRAME_STATS=1
+#endif
+
+#define NUM_LEDS 10
+
+static CRGB leds[NUM_LEDS];
+static CRGB moreLeds[2 * NUM_LEDS];
+
+/// Min, max, average, histogram and percentiles of known samples
+static void testTimingStats() {
+    CTimingStats stats;
+    CHECK(stats.getCount() == 0 && stats.getMin() == 0 && stats.getMax() == 0 && stats.getAvg() == 0);
+    CHECK(stats.getP99() == 0);
+
+    // bucket n takes 2^(n-1) .. 2^n - 1
+    const uint32_t samples[6] = { 0, 1, 2, 3, 1000, 0xFFFFFFFF };
+    for(int i = 0; i < 6; ++i) { stats.add(samples[i]); }
+    CHECK(stats.getCount() == 6);
+    CHECK(stats.getMin() == 0 && stats.getMax() == 0xFFFFFFFF);
+    CHECK(stats.getTotal() == 1006ULL + 0xFFFFFFFFULL);
+    CHECK(stats.getBucket(0) == 1 && stats.getBucket(1) == 1 && stats.getBucket(2) == 2);
+    CHECK(stats.getBucket(10) == 1 && stats.getBucket(FASTLED_TIMING_BUCKETS - 1) == 1);
+
+    // a percentile is never under the true value, and at most about twice it
+    for(int round = 0; round < 200; ++round) {
+        stats.reset();
+        uint32_t sorted[100];
+        int n = 1 + testRandom() % 100;
+        for(int i = 0; i < n; ++i) {
+            uint32_t us = testRandom() % 20000;
+            stats.add(us);
+            int j = i;
+            while(j > 0 && sorted[j - 1] > us) { sorted[j] = sorted[j - 1]; --j; }
+            sorted[j] = us;
+        }
+        const uint8_t pcts[4] = { 1, 50, 99, 100 };
+        for(int p = 0; p < 4; ++p) {
+            uint32_t truth = sorted[(n * pcts[p] + 99) / 100 - 1];
+            uint32_t estimate = stats.getPercentile(pcts[p]);
+            CHECK(estimate >= truth && estimate <= 2 * truth + 1 && estimate <= stats.getMax());
+        }
+    }
+    stats.reset();
+    CHECK(stats.getCount() == 0 && stats.getBucket(0) == 0);
+}
+
+static void testShowStats() {
+    CHostClock::setMicros(1000000);
+    CLEDController &first = FastLED.addLeds<WS2812B, 5, GRB>(leds, NUM_LEDS);
+    CLEDController &second = FastLED.addLeds<WS2812B, 6, GRB>(moreLeds, 2 * NUM_LEDS);
+    CHostRecorder *pFirst = CHostRecorder::forPin(5);
+    CHostRecorder *pSecond = CHostRecorder::forPin(6);
+    CHECK(pFirst != NULL && pSecond != NULL);
+    if(pFirst == NULL || pSecond == NULL) { return; }
+
+    // the wire times of the two strips
+    FastLED.show();
+    uint32_t wire2 = micros() - pSecond->getFrameMicros();
+    uint32_t wire1 = pSecond->getFrameMicros() - pFirst->getFrameMicros();
+    CHECK(wire1 > 0 && wire2 > wire1);
+    FastLED.resetFrameStats();
+    CFrameStats &stats = FastLED.getFrameStats();
+    CHECK(stats.getFrames() == 0 && stats.getHistory() == 0 && stats.show.getCount() == 0);
+    CHECK(first.getShowStats().getCount() == 0 && second.getShowStats().getCount() == 0);
+
+    // frames exactly 10ms apart, slower than the 400fps limit: no waiting,
+    // and every phase takes as long as the virtual clock says
+    delay(10);
+    const int frames = 50;
+    for(int i = 0; i < frames; ++i) {
+        uint32_t start = micros();
+        FastLED.show();
+        delayMicroseconds(10000 - (micros() - start));
+    }
+    CHECK(stats.getFrames() == frames);
+    CHECK(stats.interval.getCount() == frames - 1);
+    CHECK(stats.interval.getMin() == 10000 && stats.interval.getMax() == 10000 && stats.interval.getAvg() == 10000);
+    CHECK(stats.wait.getCount() == frames && stats.wait.getMax() == 0);
+    CHECK(stats.power.getCount() == 0);
+    CHECK(stats.show.getCount() == frames);
+    CHECK(stats.show.getMin() == wire1 + wire2 && stats.show.getMax() == wire1 + wire2);
+    CHECK(first.getShowStats().getCount() == frames && first.getShowStats().getAvg() == wire1);
+    CHECK(second.getShowStats().getCount() == frames && second.getShowStats().getAvg() == wire2);
+
+    // the history holds the most recent start times, newest first
+    CHECK(stats.getHistory() == FASTLED_FRAME_HISTORY);
+    CHECK(stats.getFrameStart(0) == pFirst->getFrameMicros());
+    for(uint16_t ago = 1; ago < stats.getHistory(); ++ago) {
+        CHECK(stats.getFrameStart(ago - 1) - stats.getFrameStart(ago) == 10000);
+    }
+    CHECK(stats.getFrameStart(FASTLED_FRAME_HISTORY) == 0);
+
+    // back to back, frames are held to 400fps: the wait makes up the rest of the 2500us
+    FastLED.resetFrameStats();
+    delay(10);
+    for(int i = 0; i < frames; ++i) { FastLED.show(); }
+    CHECK(stats.interval.getMin() == 2500 && stats.interval.getMax() == 2500);
+    CHECK(stats.wait.getMin() == 0 && stats.wait.getMax() == 2500 - (wire1 + wire2));
+    CHECK(stats.getFrameStart(0) - stats.getFrameStart(1) == 2500);
+
+    // the power limit is timed when there is one
+    FastLED.resetFrameStats();
+    FastLED.setMaxPowerInVoltsAndMilliamps(5, 500);
+    for(int i = 0; i < 5; ++i) { FastLED.show(); }
+    CHECK(stats.power.getCount() == 5);
+
+    // showAsync() frames are counted as well, the power limit by the caller
+    // and the rest by the show thread
+    FastLED.resetFrameStats();
+    for(int i = 0; i < 5; ++i) {
+        FastLED.showAsync();
+        FastLED.waitForShow();
+    }
+    CHECK(stats.getFrames() == 5 && stats.show.getCount() == 5 && stats.power.getCount() == 5);
+    CHECK(first.getShowStats().getCount() == 5 && first.getShowStats().getAvg() == wire1);
+}
+
+/// The text for Serial, whole and cut short
+static void testFormat() {
+    char text[512];
+    int len = FastLED.formatFrameStats(text, sizeof(text));
+    printf("%s", text);
+    CHECK(len > 0 && len < (int)sizeof(text) && (int)strlen(text) == len);
+    CHECK(strncmp(text, "frames: 5\n", 10) == 0);
+    const char *lines[6] = { "\ninterval: n=4 ", "\nwait: n=5 ", "\npower: n=5 ", "\nshow: n=5 ",
+                             "\ncontroller 0: n=5 ", "\ncontroller 1: n=5 " };
+    for(int i = 0; i < 6; ++i) { CHECK(strstr(text, lines[i]) != NULL); }
+    CHECK(text[len - 1] == '\n');
+
+    // as with snprintf(), a short buffer gets as much as fits, terminated,
+    // and the return value is still the whole length
+    char shortText[40];
+    memset(shortText, 'x', sizeof(shortText));
+    CHECK(FastLED.formatFrameStats(shortText, sizeof(shortText)) == len);
+    CHECK(strlen(shortText) == sizeof(shortText) - 1 && strncmp(shortText, text, sizeof(shortText) - 1) == 0);
+    CHECK(FastLED.formatFrameStats(NULL, 0) == len);
+}
+
+int main() {
+    testTimingStats();
+    testShowStats();
+    testFormat();
+    if(failures == 0) { printf("all passed\n"); }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,58 @@
+/// @file test_gamma.cpp
+/// Checks CRGBGammaTable and the table path of napplyGamma_video() against
+/// applyGamma_video(), on either side of the table thresholds
+
+#include "FastLED.h"
+#include "test_check.h"
+
+static void randomFill(CRGB *leds, int count) {
+    for(int i = 0; i < count; ++i) {
+        leds[i] = CRGB(testRandom8(), testRandom8(), testRandom8());
+    }
+}
+
+static void testGammaTable() {
+    const float gammas[5] = { 1.0f, 1.8f, 2.2f, 2.5f, 0.5f };
+    for(int k = 0; k < 5; ++k) {
+        CRGBGammaTable table(gammas[k]);
+        CRGBGammaTable split(gammas[k], gammas[(k + 1) % 5], gammas[(k + 2) % 5]);
+        for(int i = 0; i < 256; ++i) {
+            CRGB c(i, 255 - i, i ^ 0x55);
+            CHECK(table.apply(c) == applyGamma_video(c, gammas[k]));
+            CHECK(split.apply(c) == applyGamma_video(c, gammas[k], gammas[(k + 1) % 5], gammas[(k + 2) % 5]));
+        }
+
+        // the correction is the controller's per-channel scale8() after the
+        // gamma; it is set twice since corrections must not stack
+        CRGB adj = CLEDController::computeAdjustment(200, TypicalLEDStrip, Tungsten100W);
+        split.setCorrection(TypicalLEDStrip, Tungsten100W, 200);
+        split.setCorrection(TypicalLEDStrip, Tungsten100W, 200);
+        for(int i = 0; i < 256; ++i) {
+            CRGB ref = applyGamma_video(CRGB(i, i, i), gammas[k], gammas[(k + 1) % 5], gammas[(k + 2) % 5]);
+            CHECK(split.r[i] == scale8(ref.r, adj.r));
+            CHECK(split.g[i] == scale8(ref.g, adj.g));
+            CHECK(split.b[i] == scale8(ref.b, adj.b));
+        }
+
+        // the array functions switch to tables past a size threshold, so try either side of it
+        const uint16_t counts[5] = { 1, 85, 86, 256, 300 };
+        for(int n = 0; n < 5; ++n) {
+            CRGB fast[300], fast3[300], ref[300];
+            randomFill(ref, counts[n]);
+            memcpy(fast, ref, sizeof(fast));
+            memcpy(fast3, ref, sizeof(fast3));
+            napplyGamma_video(fast, counts[n], gammas[k]);
+            napplyGamma_video(fast3, counts[n], gammas[k], 2.0f, 2.8f);
+            for(int i = 0; i < counts[n]; ++i) {
+                CHECK(fast[i] == applyGamma_video(ref[i], gammas[k]));
+                CHECK(fast3[i] == applyGamma_video(ref[i], gammas[k], 2.0f, 2.8f));
+            }
+        }
+    }
+}
+
+int main() {
+    testGammaTable();
+    if(failures == 0) { printf("all passed\n"); }
+    return failures ? 1 : 0;
+}
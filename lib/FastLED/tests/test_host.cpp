@@ -0,0 +1,106 @@
+/// @file test_host.cpp
+/// Checks the host platform: frames recorded by the clockless controller and the virtual clock
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "FastLED.h"
+#include "test_check.h"
+
+#define NUM_LEDS 4
+#define DATA_PIN 5
+
+static CRGB leds[NUM_LEDS];
+static CRGB spiLeds[NUM_LEDS];
+static int callbacks = 0;
+
+static void countCallback(void *) { ++callbacks; }
+
+/// The C library's atexit() must still work when FastLED is linked in: the
+/// exit status is only set here, so the test fails if this never runs
+static void exitCheck() { fflush(stdout); _exit(failures ? 1 : 0); }
+
+int main() {
+    CHostClock::setMicros(1000);
+    CHECK(CHostClock::isVirtual());
+    CHECK(micros() == 1000);
+    delay(2);
+    CHECK(micros() == 3000);
+    CHECK(millis() == 3);
+
+    FastLED.addLeds<WS2812B, DATA_PIN, GRB>(leds, NUM_LEDS);
+    FastLED.setDither(DISABLE_DITHER);
+    CHostRecorder *pRecorder = CHostRecorder::forPin(DATA_PIN);
+    CHECK(pRecorder != NULL);
+    CHECK(CHostRecorder::forPin(DATA_PIN + 1) == NULL);
+    if(pRecorder == NULL) { return 1; }
+
+    // colour order and brightness
+    leds[0] = CRGB(0x10, 0x20, 0x30);
+    leds[1] = CRGB(255, 0, 0);
+    leds[2] = CRGB(0, 255, 0);
+    leds[3] = CRGB(0, 0, 255);
+    FastLED.setBrightness(255);
+    FastLED.show();
+    CHECK(pRecorder->getFrameCount() == 1);
+    CHECK(pRecorder->getFrameSize() == NUM_LEDS * 3);
+    const uint8_t expected[NUM_LEDS * 3] = { 0x20, 0x10, 0x30, 0, 255, 0, 255, 0, 0, 0, 0, 255 };
+    for(int i = 0; i < NUM_LEDS * 3; ++i) { CHECK(pRecorder->getFrame()[i] == expected[i]); }
+
+    FastLED.setBrightness(128);
+    FastLED.show();
+    CHECK(pRecorder->getFrameCount() == 2);
+    CHECK(pRecorder->getFrame()[4] == scale8(255, 128));
+
+    // time moves on by the wire time of a frame, and shows are limited to 400 a second
+    uint32_t first = pRecorder->getFrameMicros();
+    FastLED.show();
+    CHECK(pRecorder->getFrameMicros() - first == 2500);
+    uint32_t wire = micros() - pRecorder->getFrameMicros();
+    CHECK(wire >= 5 + 96 && wire <= 5 + 130);
+
+    // showAsync() snapshots the leds, so they can change while the frame is sent
+    leds[1] = CRGB(1, 2, 3);
+    FastLED.setShowCallback(countCallback);
+    FastLED.showAsync(255);
+    leds[1] = CRGB::Black;
+    FastLED.waitForShow();
+    CHECK(callbacks == 1);
+    CHECK(pRecorder->getFrameCount() == 4);
+    CHECK(pRecorder->getFrame()[3] == 2 && pRecorder->getFrame()[4] == 1 && pRecorder->getFrame()[5] == 3);
+    FastLED.setShowCallback(NULL);
+
+    // the show thread keeps its own virtual time, as another core would, so
+    // with showAsync() a frame's wire time overlaps with the work on the next
+    const uint32_t work = 3000;
+    delay(5);
+    uint32_t start = micros();
+    for(int i = 0; i < 10; ++i) {
+        FastLED.show();
+        delayMicroseconds(work);
+    }
+    uint32_t syncMicros = micros() - start;
+    delay(5);
+    start = micros();
+    for(int i = 0; i < 10; ++i) {
+        FastLED.showAsync();
+        delayMicroseconds(work);
+    }
+    FastLED.waitForShow();
+    uint32_t asyncMicros = micros() - start;
+    printf("10 frames with %u us of work each: show() %u us, showAsync() %u us, %u us overlapped\n",
+           (unsigned)work, (unsigned)syncMicros, (unsigned)asyncMicros, (unsigned)(syncMicros - asyncMicros));
+    CHECK(syncMicros == 10 * (work + wire));
+    CHECK(asyncMicros == 10 * work);
+
+    pRecorder->resetFrames();
+    CHECK(pRecorder->getFrameCount() == 0);
+
+    // SPI chipsets build without warnings, bit-banged into the host ports
+    FastLED.addLeds<APA102, 6, 7, RGB>(spiLeds, NUM_LEDS);
+
+    FastLED.showAsync(255);  // left in flight; the show thread is joined at exit
+    if(atexit(exitCheck) != 0) { return 1; }
+    if(failures == 0) { printf("all passed\n"); }
+    return 2;
+}
@@ -0,0 +1,46 @@
+/// @file test_hsv2rgb.cpp
+/// Checks the table-driven batch hsv2rgb_rainbow() against the single-pixel conversion
+
+#include "FastLED.h"
+#include "test_check.h"
+
+/// Every CHSV through the batch converter, one sat/val pair at a time
+static void testHsv2RgbBatch() {
+    CHSV hsv[256];
+    CRGB rgb[256];
+    for(int s = 0; s < 256; ++s) {
+        for(int v = 0; v < 256; ++v) {
+            for(int h = 0; h < 256; ++h) { hsv[h] = CHSV(h, s, v); }
+            hsv2rgb_rainbow(hsv, rgb, 256);
+            for(int h = 0; h < 256; ++h) {
+                CRGB ref;
+                hsv2rgb_rainbow(hsv[h], ref);
+                if(!(rgb[h] == ref)) {
+                    CHECK(rgb[h] == ref);
+                    printf("  hsv(%d,%d,%d)\n", h, s, v);
+                    return;
+                }
+            }
+        }
+    }
+
+    // odd lengths, and a zero length that must not touch the output
+    for(int round = 0; round < 100; ++round) {
+        int count = testRandom() % 40;
+        for(int i = 0; i < count; ++i) { hsv[i] = CHSV(testRandom8(), testRandom8(), testRandom8()); }
+        rgb[count] = CRGB(1, 2, 3);
+        hsv2rgb_rainbow(hsv, rgb, count);
+        for(int i = 0; i < count; ++i) {
+            CRGB ref;
+            hsv2rgb_rainbow(hsv[i], ref);
+            CHECK(rgb[i] == ref);
+        }
+        CHECK(rgb[count] == CRGB(1, 2, 3));
+    }
+}
+
+int main() {
+    testHsv2RgbBatch();
+    if(failures == 0) { printf("all passed\n"); }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,117 @@
+/// @file test_i2s_encoder.cpp
+/// Checks the ESP32 I2SParallelEncoder against a naive encoder that builds
+/// every pulse word bit by bit, for 1 to 24 strips of unequal length
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "test_check.h"
+#include "platforms/esp/32/i2s_encoder_esp32.h"
+
+#define NUM_COLOR_CHANNELS 3
+#define MAX_PIXELS 40
+#define MAX_PULSES_PER_BIT 10
+#define SENTINEL 0x5A5A5A5A
+
+/// The pulse word for one data bit position of every strip, strip i in
+/// bit (i+8): high for the first onesForZero pulses, then the data bit
+/// until onesForOne, then low
+static uint32_t refPulse(const uint8_t *lanes, uint32_t hasDataMask, int bit, int pulse, int onesForZero, int onesForOne) {
+    uint32_t word = 0;
+    for(int i = 0; i < I2S_MAX_LANES; ++i) {
+        bool level = (pulse < onesForZero) || (pulse < onesForOne && ((lanes[i] >> bit) & 1));
+        if(level) { word |= 1UL << (i + 8); }
+    }
+    return word & hasDataMask;
+}
+
+/// transpose24() on its own, for random bytes and single set bits
+static void testTranspose() {
+    for(int round = 0; round < 10000; ++round) {
+        uint8_t lanes[I2S_MAX_LANES];
+        for(int i = 0; i < I2S_MAX_LANES; ++i) {
+            lanes[i] = (round < 192) ? ((i == round / 8) ? (1 << (round % 8)) : 0) : testRandom8();
+        }
+        uint32_t bits[8];
+        I2SParallelEncoder::transpose24(lanes, bits);
+        for(int b = 0; b < 8; ++b) {
+            uint32_t ref = 0;
+            for(int i = 0; i < I2S_MAX_LANES; ++i) {
+                if((lanes[i] >> (7 - b)) & 1) { ref |= 1UL << (i + 8); }
+            }
+            CHECK(bits[b] == ref);
+        }
+    }
+}
+
+/// Whole frames, as fillBuffer() builds them: one pixel of every strip that
+/// still has data per DMA buffer, with the bytes of finished strips and of
+/// unused lanes left as whatever was there before
+static void testFrames() {
+    static uint8_t strips[I2S_MAX_LANES][MAX_PIXELS * NUM_COLOR_CHANNELS];
+    for(int round = 0; round < 2000; ++round) {
+        int nLanes = 1 + round % I2S_MAX_LANES;
+        int lengths[I2S_MAX_LANES];
+        int maxLength = 0;
+        for(int i = 0; i < nLanes; ++i) {
+            // equal lengths in the first rounds, unequal ones after
+            lengths[i] = (round < 48) ? MAX_PIXELS : testRandom() % (MAX_PIXELS + 1);
+            if(lengths[i] > maxLength) { maxLength = lengths[i]; }
+            for(int j = 0; j < lengths[i] * NUM_COLOR_CHANNELS; ++j) { strips[i][j] = testRandom8(); }
+        }
+        int pulsesPerBit = 3 + testRandom() % (MAX_PULSES_PER_BIT - 2);
+        int onesForZero = 1 + testRandom() % (pulsesPerBit - 2);
+        int onesForOne = onesForZero + 1 + testRandom() % (pulsesPerBit - onesForZero - 1);
+
+        uint8_t row[NUM_COLOR_CHANNELS][I2S_MAX_LANES];
+        for(int c = 0; c < NUM_COLOR_CHANNELS; ++c) {
+            for(int i = 0; i < I2S_MAX_LANES; ++i) { row[c][i] = testRandom8(); }
+        }
+        for(int pixel = 0; pixel < maxLength; ++pixel) {
+            uint32_t hasDataMask = 0;
+            for(int i = 0; i < nLanes; ++i) {
+                if(pixel < lengths[i]) {
+                    for(int c = 0; c < NUM_COLOR_CHANNELS; ++c) { row[c][i] = strips[i][pixel * NUM_COLOR_CHANNELS + c]; }
+                    hasDataMask |= 1UL << (i + 8);
+                }
+            }
+
+            volatile uint32_t buf[NUM_COLOR_CHANNELS * 8 * MAX_PULSES_PER_BIT];
+            for(int k = 0; k < NUM_COLOR_CHANNELS * 8 * MAX_PULSES_PER_BIT; ++k) { buf[k] = SENTINEL; }
+            for(int c = 0; c < NUM_COLOR_CHANNELS; ++c) {
+                uint32_t bits[8];
+                I2SParallelEncoder::transpose24(row[c], bits);
+                I2SParallelEncoder::encode(bits, hasDataMask, buf + c * 8 * pulsesPerBit, pulsesPerBit, onesForZero, onesForOne);
+            }
+
+            // the pulses that differ between a 0 and a 1 are written, the
+            // constant ones are left to the buffer's initial fill
+            bool ok = true;
+            for(int c = 0; c < NUM_COLOR_CHANNELS; ++c) {
+                for(int b = 0; b < 8; ++b) {
+                    for(int p = 0; p < pulsesPerBit; ++p) {
+                        uint32_t got = buf[(c * 8 + b) * pulsesPerBit + p];
+                        uint32_t want = (p >= onesForZero && p < onesForOne)
+                            ? refPulse(row[c], hasDataMask, 7 - b, p, onesForZero, onesForOne) : SENTINEL;
+                        ok = ok && (got == want);
+                    }
+                }
+            }
+            for(int k = NUM_COLOR_CHANNELS * 8 * pulsesPerBit; k < NUM_COLOR_CHANNELS * 8 * MAX_PULSES_PER_BIT; ++k) {
+                ok = ok && (buf[k] == SENTINEL);
+            }
+            if(!ok) {
+                CHECK(ok);
+                printf("  %d lanes, pixel %d\n", nLanes, pixel);
+                return;
+            }
+        }
+    }
+}
+
+int main() {
+    testTranspose();
+    testFrames();
+    if(failures == 0) { printf("all passed\n"); }
+    return failures ? 1 : 0;
+}
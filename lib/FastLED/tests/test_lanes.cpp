@@ -0,0 +1,58 @@
+/// @file test_lanes.cpp
+/// Checks the packed-lane array kernels behind nscale8(), nscale8_video(),
+/// fadeToBlackBy(), fade_video(), nblend() and blend() against the
+/// per-pixel CRGB functions
+
+#include "FastLED.h"
+#include "test_check.h"
+
+static void randomFill(CRGB *leds, int count) {
+    for(int i = 0; i < count; ++i) {
+        leds[i] = CRGB(testRandom8(), testRandom8(), testRandom8());
+    }
+}
+
+/// The array kernels on every scale, with lengths that leave every
+/// possible tail after the four-byte words
+static void testLaneKernels() {
+    const int counts[5] = { 1, 2, 3, 4, 37 };
+    for(int n = 0; n < 5; ++n) {
+        int count = counts[n];
+        for(int scale = 0; scale < 256; ++scale) {
+            CRGB src[37], over[37], fast[37], ref[37], dest[37];
+            randomFill(src, count);
+            randomFill(over, count);
+            // make sure the edge values are covered
+            src[0] = CRGB(0, 1, 255);
+
+            memcpy(fast, src, sizeof(fast));
+            nscale8(fast, count, scale);
+            for(int i = 0; i < count; ++i) { ref[i] = src[i]; ref[i].nscale8(scale); CHECK(fast[i] == ref[i]); }
+
+            memcpy(fast, src, sizeof(fast));
+            nscale8_video(fast, count, scale);
+            for(int i = 0; i < count; ++i) { ref[i] = src[i]; ref[i].nscale8_video(scale); CHECK(fast[i] == ref[i]); }
+
+            memcpy(fast, src, sizeof(fast));
+            fadeToBlackBy(fast, count, scale);
+            for(int i = 0; i < count; ++i) { ref[i] = src[i]; ref[i].fadeToBlackBy(scale); CHECK(fast[i] == ref[i]); }
+
+            memcpy(fast, src, sizeof(fast));
+            fade_video(fast, count, scale);
+            for(int i = 0; i < count; ++i) { ref[i] = src[i]; ref[i].fadeLightBy(scale); CHECK(fast[i] == ref[i]); }
+
+            memcpy(fast, src, sizeof(fast));
+            nblend(fast, over, count, scale);
+            for(int i = 0; i < count; ++i) { ref[i] = src[i]; nblend(ref[i], over[i], scale); CHECK(fast[i] == ref[i]); }
+
+            blend(src, over, dest, count, scale);
+            for(int i = 0; i < count; ++i) { CHECK(dest[i] == blend(src[i], over[i], scale)); }
+        }
+    }
+}
+
+int main() {
+    testLaneKernels();
+    if(failures == 0) { printf("all passed\n"); }
+    return failures ? 1 : 0;
+}
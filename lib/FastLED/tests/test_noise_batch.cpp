@@ -0,0 +1,41 @@
+/// @file test_noise_batch.cpp
+/// Checks inoise16_batch() / inoise8_batch() against per-point inoise16() and inoise8()
+
+#include "FastLED.h"
+#include "test_check.h"
+
+static void testNoiseBatch() {
+    for(int round = 0; round < 200; ++round) {
+        // lengths that leave every possible tail after the blocks of eight
+        uint16_t count = testRandom() % 70;
+        uint32_t xs[70], ys[70], zs[70];
+        uint16_t xs8[70], ys8[70], zs8[70];
+        uint16_t out16[71];
+        uint8_t out8[71];
+        for(int i = 0; i < count; ++i) {
+            // mix random points with points on the same lattice cell
+            xs[i] = (round & 1) ? testRandom() : (0x12340000UL + testRandom() % 0x10000);
+            ys[i] = testRandom();
+            zs[i] = (round & 2) ? testRandom() : 0;
+            xs8[i] = testRandom();
+            ys8[i] = (round & 1) ? testRandom() : 0x5500 + i;
+            zs8[i] = testRandom();
+        }
+        out16[count] = 0xBEEF;
+        out8[count] = 0xA5;
+        inoise16_batch(xs, ys, zs, out16, count);
+        inoise8_batch(xs8, ys8, zs8, out8, count);
+        for(int i = 0; i < count; ++i) {
+            CHECK(out16[i] == inoise16(xs[i], ys[i], zs[i]));
+            CHECK(out8[i] == inoise8(xs8[i], ys8[i], zs8[i]));
+        }
+        CHECK(out16[count] == 0xBEEF);
+        CHECK(out8[count] == 0xA5);
+    }
+}
+
+int main() {
+    testNoiseBatch();
+    if(failures == 0) { printf("all passed\n"); }
+    return failures ? 1 : 0;
+}
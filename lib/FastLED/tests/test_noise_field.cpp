@@ -0,0 +1,125 @@
+/// @file test_noise_field.cpp
+/// Checks CNoiseField16 against per-point inoise16(), and the field-based
+/// fill_raw_2dnoise16into8() against the per-pixel version it replaced
+
+#include "FastLED.h"
+#include "test_check.h"
+
+#define WIDTH 23
+#define HEIGHT 17
+
+static void checkField(CNoiseField16 &field, uint32_t x, int32_t scalex, uint32_t y, int32_t scaley, uint32_t z) {
+    field.setX(x, scalex);
+    field.setY(y, scaley);
+    field.setTime(z);
+
+    uint16_t data[WIDTH * HEIGHT];
+    field.fillRows(data, 0, HEIGHT);
+    for(int i = 0; i < HEIGHT; ++i) {
+        for(int j = 0; j < WIDTH; ++j) {
+            uint16_t ref = inoise16(x + j * scalex, y + i * scaley, z);
+            if(data[i * WIDTH + j] != ref) {
+                CHECK(data[i * WIDTH + j] == ref);
+                printf("  x=%u/%d y=%u/%d z=%u row %d col %d\n", x, scalex, y, scaley, z, i, j);
+                return;
+            }
+        }
+    }
+
+    // a single row, and a band of rows, agree with the whole grid
+    uint16_t row[WIDTH];
+    uint16_t r = testRandom() % HEIGHT;
+    field.fillRow(row, r);
+    for(int j = 0; j < WIDTH; ++j) { CHECK(row[j] == data[r * WIDTH + j]); }
+
+    uint16_t band[WIDTH * HEIGHT];
+    uint16_t begin = testRandom() % HEIGHT;
+    field.fillRows(band, begin, HEIGHT);
+    for(int k = begin * WIDTH; k < WIDTH * HEIGHT; ++k) { CHECK(band[k] == data[k]); }
+}
+
+static void testNoiseField() {
+    CNoiseField16Array<WIDTH, HEIGHT> field;
+    CHECK(field.width() == WIDTH);
+    CHECK(field.height() == HEIGHT);
+
+    // steps within a cell, steps across several cells, negative steps and zero
+    const int32_t scales[7] = { 0, 1, 300, 0x3000, 0x10000, 0x12345, -0x2000 };
+    for(int a = 0; a < 7; ++a) {
+        for(int b = 0; b < 7; ++b) {
+            checkField(field, testRandom(), scales[a], testRandom(), scales[b], testRandom());
+        }
+    }
+    for(int round = 0; round < 100; ++round) {
+        checkField(field, testRandom(), (int32_t)testRandom() >> 12, testRandom(), (int32_t)testRandom() >> 12, testRandom());
+    }
+
+    // wrapping around the top of the coordinate space
+    checkField(field, 0xFFFFF000UL, 0x800, 0xFFFFFFFFUL, 0x1000, 0);
+
+    // animating: only the time moves
+    uint32_t x = testRandom(), y = testRandom();
+    for(uint32_t z = 0; z < 0x40000; z += 0x1234) {
+        checkField(field, x, 0x2000, y, 0x2000, z);
+    }
+}
+
+/// fill_raw_2dnoise16into8() as it was before it used CNoiseField16
+static void refFill(uint8_t *pData, int width, int height, uint8_t octaves, q44 freq44, fract8 amplitude, int skip, uint32_t x, int scalex, uint32_t y, int scaley, uint32_t time) {
+    if(octaves > 1) {
+        refFill(pData, width, height, octaves-1, freq44, amplitude, skip+1, x*freq44, scalex *freq44, y*freq44, scaley * freq44, time);
+    } else {
+        amplitude = 255;
+    }
+
+    scalex *= skip;
+    scaley *= skip;
+    fract8 invamp = 255-amplitude;
+    for(int i = 0; i < height; i+=skip, y+=scaley) {
+        uint8_t *pRow = pData + (i*width);
+        uint32_t xx = x;
+        for(int j = 0; j < width; j+=skip, xx+=scalex) {
+            uint16_t noise_base = inoise16(xx,y,time);
+            noise_base = (0x8000 & noise_base) ? noise_base - (32767) : 32767 - noise_base;
+            noise_base = scale8(noise_base>>7,amplitude);
+            if(skip==1) {
+                pRow[j] = qadd8(scale8(pRow[j],invamp),noise_base);
+            } else {
+                for(int ii = i; ii<(i+skip) && ii<height; ++ii) {
+                    uint8_t *pRow = pData + (ii*width);
+                    for(int jj=j; jj<(j+skip) && jj<width; ++jj) {
+                        pRow[jj] = scale8(pRow[jj],invamp) + noise_base;
+                    }
+                }
+            }
+        }
+    }
+}
+
+/// Grids narrower and wider than the chunk of columns sampled at a time,
+/// with every octave count, so that the skip of the coarser octaves
+/// lands on and off the chunk boundaries
+static void testFillRaw() {
+    const int widths[7] = { 1, 7, 31, 32, 33, 100, 255 };
+    for(int w = 0; w < 7; ++w) {
+        for(uint8_t octaves = 1; octaves <= 4; ++octaves) {
+            int width = widths[w];
+            int height = 1 + testRandom() % 20;
+            uint8_t fast[255 * 20], ref[255 * 20];
+            for(int i = 0; i < width * height; ++i) { fast[i] = ref[i] = testRandom8(); }
+            uint32_t x = testRandom(), y = testRandom(), time = testRandom();
+            int scalex = (int)(testRandom() % 0x4000) - 0x1000;
+            int scaley = (int)(testRandom() % 0x4000) - 0x1000;
+            fill_raw_2dnoise16into8(fast, width, height, octaves, q44(2,0), 171, 1, x, scalex, y, scaley, time);
+            refFill(ref, width, height, octaves, q44(2,0), 171, 1, x, scalex, y, scaley, time);
+            CHECK(memcmp(fast, ref, width * height) == 0);
+        }
+    }
+}
+
+int main() {
+    testNoiseField();
+    testFillRaw();
+    if(failures == 0) { printf("all passed\n"); }
+    return failures ? 1 : 0;
+}
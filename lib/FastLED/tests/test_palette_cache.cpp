@@ -0,0 +1,73 @@
+/// @file test_palette_cache.cpp
+/// Checks CRGBPaletteCache against ColorFromPalette() and fill_palette()
+
+#include "FastLED.h"
+#include "test_check.h"
+
+static void randomFill(CRGB *leds, int count) {
+    for(int i = 0; i < count; ++i) {
+        leds[i] = CRGB(testRandom8(), testRandom8(), testRandom8());
+    }
+}
+
+template<typename PALETTE>
+static void checkPaletteCache(const CRGBPaletteCache &cache, const PALETTE &pal, uint8_t brightness, TBlendType blendType) {
+    for(int i = 0; i < 256; ++i) {
+        CHECK(cache[i] == ColorFromPalette(pal, (uint8_t)i, brightness, blendType));
+    }
+
+    CRGB fast[60], ref[60];
+    uint8_t start = testRandom8();
+    uint8_t inc = testRandom8();
+    cache.fillFromPalette(fast, 60, start, inc);
+    fill_palette(ref, 60, start, inc, pal, brightness, blendType);
+    for(int i = 0; i < 60; ++i) { CHECK(fast[i] == ref[i]); }
+}
+
+static void testPaletteCache() {
+    const TBlendType blends[2] = { NOBLEND, LINEARBLEND };
+    const uint8_t brightnesses[4] = { 255, 128, 1, 0 };
+
+    CRGBPaletteCache cache;
+    CRGBPalette16 pal16;
+    randomFill(pal16.entries, 16);
+    for(int b = 0; b < 2; ++b) {
+        for(int k = 0; k < 4; ++k) {
+            CHECK(cache.update(pal16, brightnesses[k], blends[b]));
+            checkPaletteCache(cache, pal16, brightnesses[k], blends[b]);
+            CHECK(!cache.update(pal16, brightnesses[k], blends[b]));
+        }
+    }
+
+    // palette edits in place are picked up, whether blended or written directly
+    CRGBPalette16 target;
+    randomFill(target.entries, 16);
+    for(int round = 0; round < 20; ++round) {
+        nblendPaletteTowardPalette(pal16, target, 8);
+        cache.update(pal16);
+        checkPaletteCache(cache, pal16, 255, LINEARBLEND);
+    }
+    pal16.entries[testRandom() % 16] += CRGB(1, 1, 1);
+    CHECK(cache.update(pal16));
+    checkPaletteCache(cache, pal16, 255, LINEARBLEND);
+
+    cache.invalidate();
+    CHECK(cache.update(pal16));
+
+    // a 32-entry palette whose first half matches the 16-entry one is still a different source
+    CRGBPalette32 pal32;
+    for(int i = 0; i < 32; ++i) { pal32.entries[i] = pal16.entries[i & 15]; }
+    CHECK(cache.update(pal32));
+    checkPaletteCache(cache, pal32, 255, LINEARBLEND);
+    randomFill(pal32.entries, 32);
+    for(int b = 0; b < 2; ++b) {
+        CHECK(cache.update(pal32, 200, blends[b]));
+        checkPaletteCache(cache, pal32, 200, blends[b]);
+    }
+}
+
+int main() {
+    testPaletteCache();
+    if(failures == 0) { printf("all passed\n"); }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,130 @@
+/// @file test_power.cpp
+/// Checks CLEDPowerAccount against summing the whole LED array with
+/// calculate_unscaled_power_mW() after every edit, and the brightness
+/// FastLED.show() uses for a controller with an account attached
+
+#include "FastLED.h"
+#include "test_check.h"
+
+#define NUM_LEDS 300
+#define DATA_PIN 5
+
+static CRGB leds[NUM_LEDS];
+static CRGB shadow[NUM_LEDS];
+
+static CRGB randomColor() {
+    return CRGB(testRandom8(), testRandom8(), testRandom8());
+}
+
+/// Run random edits through the account, and apply the same edits to a
+/// shadow copy with the plain array functions
+static void testRandomEdits(CLEDPowerAccount &account) {
+    for(int round = 0; round < 5000; ++round) {
+        uint16_t start = testRandom() % NUM_LEDS;
+        uint16_t count = testRandom() % (NUM_LEDS - start + 1);
+        uint8_t amount = testRandom8();
+        switch(testRandom() % 7) {
+        case 0: {
+            CRGB c = randomColor();
+            account.set(start, c);
+            shadow[start] = c;
+            break;
+        }
+        case 1: {
+            CRGB c = randomColor();
+            if(testRandom() & 1) { start = 0; count = NUM_LEDS; }
+            account.fill_solid(start, count, c);
+            fill_solid(shadow + start, count, c);
+            break;
+        }
+        case 2:
+            account.fadeToBlackBy(start, count, amount);
+            fadeToBlackBy(shadow + start, count, amount);
+            break;
+        case 3:
+            account.nscale8(start, count, amount);
+            nscale8(shadow + start, count, amount);
+            break;
+        case 4: {
+            CRGB overlay[NUM_LEDS];
+            for(int i = 0; i < count; ++i) { overlay[i] = randomColor(); }
+            account.nblend(start, overlay, count, amount);
+            nblend(shadow + start, overlay, count, amount);
+            break;
+        }
+        case 5:
+            // direct edits, bracketed
+            account.beginUpdate(start, count);
+            for(int i = start; i < start + count; ++i) {
+                leds[i] = shadow[i] = (testRandom() & 1) ? randomColor() : CRGB(CRGB::White);
+            }
+            account.endUpdate();
+            break;
+        default:
+            // direct edits, then a recompute
+            for(int i = start; i < start + count; i += 7) { leds[i] = shadow[i] = randomColor(); }
+            account.recompute();
+            break;
+        }
+
+        CHECK(memcmp(leds, shadow, sizeof(leds)) == 0);
+        uint32_t ref = calculate_unscaled_power_mW(leds, NUM_LEDS, account.getModel());
+        if(account.unscaled_mW() != ref) {
+            CHECK(account.unscaled_mW() == ref);
+            printf("  round %d: %u != %u\n", round, account.unscaled_mW(), ref);
+            return;
+        }
+    }
+}
+
+int main() {
+    CLEDController &controller = FastLED.addLeds<WS2812B, DATA_PIN, GRB>(leds, NUM_LEDS);
+    FastLED.setDither(DISABLE_DITHER);
+    CHostRecorder *pRecorder = CHostRecorder::forPin(DATA_PIN);
+    CHECK(pRecorder != NULL);
+    if(pRecorder == NULL) { return 1; }
+
+    for(int i = 0; i < NUM_LEDS; ++i) { leds[i] = shadow[i] = randomColor(); }
+    CLEDPowerAccount account;
+    account.attach(controller);
+    CHECK(account.leds() == leds);
+    CHECK(account.size() == NUM_LEDS);
+    CHECK(controller.getPowerAccount() == &account);
+
+    // the default model matches the global power functions
+    testRandomEdits(account);
+    CHECK(account.unscaled_mW() == calculate_unscaled_power_mW(leds, NUM_LEDS));
+    const uint32_t budgets[5] = { 0, 100, 1000, 5000, 100000 };
+    for(int b = 0; b < 5; ++b) {
+        for(int target = 0; target < 256; target += 51) {
+            CHECK(account.max_brightness_for_power_mW(target, budgets[b]) ==
+                  calculate_max_brightness_for_power_mW(leds, NUM_LEDS, target, budgets[b]));
+        }
+    }
+
+    // and a strip with its own model
+    const CLEDPowerModel model = { 20, 15, 25, 1 };
+    account.setModel(model);
+    testRandomEdits(account);
+    account.setModel(gDefaultPowerModel);
+
+    // show() writes the controller out at the brightness the account's budget allows
+    fill_solid(leds, NUM_LEDS, CRGB::White);
+    account.recompute();
+    account.setMaxPowerInVoltsAndMilliamps(5, 2000);
+    uint8_t expected = calculate_max_brightness_for_power_mW(leds, NUM_LEDS, 255, 10000);
+    CHECK(expected < 255);
+    CHECK(account.limit_brightness(255) == expected);
+    FastLED.show(255);
+    CHECK(pRecorder->getFrameCount() == 1);
+    CHECK(pRecorder->getFrame()[0] == scale8(255, expected));
+
+    // detached, the strip is shown at full brightness again
+    controller.setPowerAccount(NULL);
+    FastLED.show(255);
+    CHECK(pRecorder->getFrameCount() == 2);
+    CHECK(pRecorder->getFrame()[0] == 255);
+
+    if(failures == 0) { printf("all passed\n"); }
+    return failures ? 1 : 0;
+}
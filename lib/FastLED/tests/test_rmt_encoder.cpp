@@ -0,0 +1,101 @@
+/// @file test_rmt_encoder.cpp
+/// Checks the ESP32 RMTNibbleEncoder, and the translation the built-in RMT
+/// driver pulls pulses through, against the bit-by-bit encoding it replaced
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "test_check.h"
+#include "platforms/esp/32/rmt_encoder_esp32.h"
+
+#define MAX_BYTES 300
+
+static uint32_t zeroVal;
+static uint32_t oneVal;
+
+/// The items for one byte, as ESP32RMTController::convertByte() wrote them
+/// before the encoder table
+static uint32_t *refConvertByte(uint32_t byteval, uint32_t *pItem) {
+    byteval <<= 24;
+    for(uint32_t j = 0; j < 8; j++) {
+        *pItem++ = (byteval & 0x80000000L) ? oneVal : zeroVal;
+        byteval <<= 1;
+    }
+    return pItem;
+}
+
+static void randomItems(RMTNibbleEncoder &encoder) {
+    zeroVal = testRandom();
+    do { oneVal = testRandom(); } while(oneVal == zeroVal);
+    encoder.init(zeroVal, oneVal);
+}
+
+/// Every byte value, into an ordinary buffer and into volatile memory as in RMTMEM
+static void testEncodeByte() {
+    RMTNibbleEncoder encoder;
+    for(int round = 0; round < 20; ++round) {
+        randomItems(encoder);
+        for(int b = 0; b < 256; ++b) {
+            uint32_t ref[8], fast[9];
+            volatile uint32_t mem[8];
+            fast[8] = 0xDEADBEEF;
+            refConvertByte(b, ref);
+            CHECK(encoder.encodeByte((uint8_t)b, fast) == fast + 8);
+            CHECK(encoder.encodeByte((uint8_t)b, mem) == mem + 8);
+            for(int i = 0; i < 8; ++i) { CHECK(fast[i] == ref[i] && mem[i] == ref[i]); }
+            CHECK(fast[8] == 0xDEADBEEF);
+        }
+    }
+}
+
+/// The driver asks for chunks of items of any size; every chunk must hold
+/// whole bytes, and the chunks together the whole stream
+static void testTranslate() {
+    RMTNibbleEncoder encoder;
+    uint8_t data[MAX_BYTES];
+    uint32_t ref[MAX_BYTES * 8];
+    uint32_t fast[MAX_BYTES * 8 + 64];
+    const size_t chunks[6] = { 8, 15, 24, 32, 64, 100 };
+    for(int round = 0; round < 200; ++round) {
+        randomItems(encoder);
+        size_t nBytes = (round < 6) ? round : 1 + testRandom() % MAX_BYTES;
+        for(size_t i = 0; i < nBytes; ++i) { data[i] = testRandom8(); }
+        uint32_t *pRef = ref;
+        for(size_t i = 0; i < nBytes; ++i) { pRef = refConvertByte(data[i], pRef); }
+
+        // a fixed chunk size for the first rounds of each, then random ones
+        size_t chunk = chunks[round % 6];
+        bool random = round >= 100;
+        memset(fast, 0, sizeof(fast));
+        size_t src = 0, items = 0;
+        while(src < nBytes) {
+            size_t wanted = random ? 8 + testRandom() % 120 : chunk;
+            size_t itemNum = 12345;
+            fast[items + wanted] = 0xDEADBEEF;
+            size_t used = encoder.translate(data + src, nBytes - src, fast + items, wanted, &itemNum);
+            CHECK(used > 0 && used <= nBytes - src);
+            CHECK(used == wanted / 8 || used == nBytes - src);
+            CHECK(itemNum == used * 8);
+            CHECK(fast[items + wanted] == 0xDEADBEEF);
+            if(used == 0) { break; }
+            src += used;
+            items += itemNum;
+        }
+        CHECK(items == nBytes * 8);
+        CHECK(memcmp(fast, ref, nBytes * 8 * sizeof(uint32_t)) == 0);
+    }
+
+    // nothing is written when the chunk is too small for a byte
+    uint32_t item = 0xDEADBEEF;
+    size_t itemNum = 12345;
+    CHECK(encoder.translate(data, 10, &item, 7, &itemNum) == 0);
+    CHECK(itemNum == 0 && item == 0xDEADBEEF);
+}
+
+int main() {
+    testEncodeByte();
+    testTranslate();
+    if(failures == 0) { printf("all passed\n"); }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,136 @@
+/// @file test_skip.cpp
+/// Checks FastLED.setSkipUnchanged() against a model that writes out a frame
+/// whenever its LED data or color adjustment differ from the last frame
+/// written out, or the refresh interval ran out
+
+#include "FastLED.h"
+#include "test_check.h"
+
+#define NUM_LEDS 13
+#define DATA_PIN 5
+#define REFRESH_MS 100
+
+static CRGB leds[NUM_LEDS];
+
+/// Check the last recorded frame against the LED data at a color adjustment
+static bool frameMatches(CHostRecorder *pRecorder, const CRGB &adj) {
+    const uint8_t *frame = pRecorder->getFrame();
+    for(int i = 0; i < NUM_LEDS; ++i) {
+        CRGB c(scale8(leds[i].r, adj.r), scale8(leds[i].g, adj.g), scale8(leds[i].b, adj.b));
+        if(frame[i * 3] != c.g || frame[i * 3 + 1] != c.r || frame[i * 3 + 2] != c.b) { return false; }
+    }
+    return true;
+}
+
+int main() {
+    CHostClock::setMicros(1000000);
+    CLEDController &controller = FastLED.addLeds<WS2812B, DATA_PIN, GRB>(leds, NUM_LEDS);
+    FastLED.setDither(DISABLE_DITHER);
+    FastLED.setSkipUnchanged(true, REFRESH_MS);
+    CHostRecorder *pRecorder = CHostRecorder::forPin(DATA_PIN);
+    CHECK(pRecorder != NULL);
+    if(pRecorder == NULL) { return 1; }
+
+    // random edits, brightness and correction changes and pauses, against a
+    // model that compares with a copy of the last frame written out
+    uint8_t brightness = 255;
+    uint32_t frames = 0, skips = 0;
+    uint32_t lastWritten = 0;
+    CRGB lastLeds[NUM_LEDS];
+    CRGB lastAdj;
+    bool first = true;
+    for(int round = 0; round < 2000; ++round) {
+        uint8_t what = testRandom8();
+        if(what < 64) {
+            // an edit, which may put back the value that was last written out
+            int i = testRandom() % NUM_LEDS;
+            leds[i] = ((what & 1) && !first) ? lastLeds[i] : CRGB(testRandom8(), testRandom8(), testRandom8());
+        } else if(what < 80) {
+            brightness = (what & 1) ? brightness : testRandom8();
+        } else if(what < 88) {
+            controller.setCorrection((what & 1) ? TypicalLEDStrip : UncorrectedColor);
+        }
+        delay((what & 0x80) ? 5 : 30);
+
+        uint32_t now = millis();
+        CRGB adj = controller.getAdjustment(brightness);
+        bool expectWrite = first || memcmp(leds, lastLeds, sizeof(leds)) != 0 || !(adj == lastAdj) ||
+                           (now - lastWritten) >= REFRESH_MS;
+        FastLED.show(brightness);
+        if(expectWrite) {
+            ++frames;
+            lastWritten = now;
+            memcpy(lastLeds, leds, sizeof(leds));
+            lastAdj = adj;
+            first = false;
+        } else {
+            ++skips;
+        }
+        CHECK(pRecorder->getFrameCount() == frames);
+        CHECK(controller.getSkipCount() == skips);
+        CHECK(frameMatches(pRecorder, adj));
+    }
+    CHECK(skips > 200 && frames > 200);
+
+    // turning skipping on again forgets the last frame
+    FastLED.setSkipUnchanged(true, 0);
+    delay(5);
+    FastLED.show(brightness);
+    CHECK(pRecorder->getFrameCount() == ++frames);
+
+    // without a refresh interval, unchanged frames are skipped however long it has been
+    delay(10000);
+    FastLED.show(brightness);
+    CHECK(pRecorder->getFrameCount() == frames);
+
+    // dithering changes the output every frame, so nothing is skipped below full scale
+    controller.setDither(TEMPORAL_DITHER);
+    for(int i = 0; i < 10; ++i) {
+        delay(5);
+        FastLED.show(128);
+        CHECK(pRecorder->getFrameCount() == ++frames);
+    }
+    // but at full scale there is nothing to dither
+    delay(5);
+    FastLED.show(255);
+    CHECK(pRecorder->getFrameCount() == ++frames);
+    delay(5);
+    FastLED.show(255);
+    CHECK(pRecorder->getFrameCount() == frames);
+
+    // and without skipping, every show() is written out
+    FastLED.setSkipUnchanged(false);
+    controller.resetSkipCount();
+    for(int i = 0; i < 10; ++i) {
+        delay(5);
+        FastLED.show(255);
+        CHECK(pRecorder->getFrameCount() == ++frames);
+    }
+    CHECK(controller.getSkipCount() == 0);
+
+    // showAsync() skips the same frames. At 33fps binary dithering is gated
+    // off, so it doesn't stop unchanged frames from being skipped below full scale.
+    controller.setDither(BINARY_DITHER);
+    FastLED.setSkipUnchanged(true, 0);
+    for(int i = 0; i < 20; ++i) {
+        delay(30);
+        FastLED.show(128);
+    }
+    CHECK(!FastLED.isDithering());
+    frames = pRecorder->getFrameCount();
+    for(int i = 0; i < 10; ++i) {
+        delay(30);
+        FastLED.showAsync(128);
+        FastLED.waitForShow();
+        CHECK(pRecorder->getFrameCount() == frames);
+    }
+    leds[0].r ^= 0x40;
+    delay(30);
+    FastLED.showAsync(128);
+    FastLED.waitForShow();
+    CHECK(pRecorder->getFrameCount() == ++frames);
+    CHECK(frameMatches(pRecorder, controller.getAdjustment(128)));
+
+    if(failures == 0) { printf("all passed\n"); }
+    return failures ? 1 : 0;
+}
@@ -825,6 +825,29 @@ void OLEDDisplay::clear(void) {
   memset(buffer, 0, displayBufferSize);
 }
 
+#ifdef OLEDDISPLAY_DOUBLE_BUFFER
+bool OLEDDisplay::updateDirtyPages(uint8_t *dirtyFirst, uint8_t *dirtyLast, uint8_t maxPages) {
+  bool changed = false;
+  uint8_t pages = (displayHeight / 8 < maxPages) ? displayHeight / 8 : maxPages;
+  for (uint8_t y = 0; y < pages; y++) {
+    const uint8_t *cur = buffer + y * displayWidth;
+    uint8_t *back = buffer_back + y * displayWidth;
+    dirtyFirst[y] = UINT8_MAX;
+    dirtyLast[y] = 0;
+    if (memcmp(cur, back, displayWidth) == 0) continue;
+
+    uint16_t first = 0, last = displayWidth - 1;
+    while (cur[first] == back[first]) first++;
+    while (cur[last] == back[last]) last--;
+    memcpy(back + first, cur + first, last - first + 1);
+    dirtyFirst[y] = first;
+    dirtyLast[y] = last;
+    changed = true;
+  }
+  return changed;
+}
+#endif
+
 void OLEDDisplay::drawLogBuffer(uint16_t xMove, uint16_t yMove) {
 #if !defined(NO_GLOBAL_INSTANCES) && !defined(NO_GLOBAL_SERIAL)
   Serial.println("[deprecated] Print functionality now handles buffer management automatically. This is a no-op.");
@@ -394,6 +394,15 @@ class OLEDDisplay : public Stream {
     // Send all the init commands
     void sendInitCommands();
 
+    #ifdef OLEDDISPLAY_DOUBLE_BUFFER
+    // Find the changed columns of each page and copy them from buffer to
+    // buffer_back. dirtyFirst/dirtyLast get the first and last changed
+    // column of each page, first > last if the page is unchanged. At most
+    // maxPages pages are looked at, the size of dirtyFirst and dirtyLast.
+    // Returns false if nothing changed.
+    bool updateDirtyPages(uint8_t *dirtyFirst, uint8_t *dirtyLast, uint8_t maxPages);
+    #endif
+
     // converts utf8 characters to extended ascii
     char* utf8ascii(const String &s);
 
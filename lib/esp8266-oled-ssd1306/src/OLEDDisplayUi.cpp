@@ -51,6 +51,13 @@ OLEDDisplayUi::OLEDDisplayUi(OLEDDisplay *display) {
   frameCount = 0;
   nextFrameNumber = -1;
   overlayCount = 0;
+  changeDrivenRedraw = false;
+  needsRedraw = true;
+  frameChangedFunctions = NULL;
+  overlayChangedFunctions = NULL;
+  lastDrawnState = FIXED;
+  lastDrawnFrame = 0;
+  skippedFrames = 0;
   indicatorDrawState = 1;
   loadingDrawFunction = LoadingDrawDefault;
   updateInterval = 33;
@@ -64,10 +71,21 @@ OLEDDisplayUi::OLEDDisplayUi(OLEDDisplay *display) {
   state.userData = NULL;
   shouldDrawIndicators = true;
   autoTransition = true;
+  useTransitionSnapshots = false;
+  snapshotBuffer = NULL;
+  snapshotSize = 0;
+  snapshotValid = false;
+  snapshotFrame = 0;
+  snapshotNextFrame = 0;
+  snapshotIndicatorDrawn = true;
   setTimePerFrame(5000);
   setTimePerTransition(500);
 }
 
+OLEDDisplayUi::~OLEDDisplayUi() {
+  if (this->snapshotBuffer) free(this->snapshotBuffer);
+}
+
 void OLEDDisplayUi::init() {
   this->display->init();
 }
@@ -103,6 +121,18 @@ void OLEDDisplayUi::setTimePerTransition(uint16_t time){
   this->timePerTransition = time;
   this->ticksPerTransition = timePerTransition / updateInterval;
 }
+void OLEDDisplayUi::enableTransitionSnapshots(){
+  this->useTransitionSnapshots = true;
+}
+void OLEDDisplayUi::disableTransitionSnapshots(){
+  this->useTransitionSnapshots = false;
+  this->snapshotValid = false;
+  if (this->snapshotBuffer) {
+    free(this->snapshotBuffer);
+    this->snapshotBuffer = NULL;
+    this->snapshotSize = 0;
+  }
+}
 
 // -/------ Customize indicator position and style -------\-
 void OLEDDisplayUi::enableIndicator(){
@@ -115,23 +145,29 @@ void OLEDDisplayUi::disableIndicator(){
 
 void OLEDDisplayUi::enableAllIndicators(){
   this->shouldDrawIndicators = true;
+  this->needsRedraw = true;
 }
 
 void OLEDDisplayUi::disableAllIndicators(){
   this->shouldDrawIndicators = false;
+  this->needsRedraw = true;
 }
 
 void OLEDDisplayUi::setIndicatorPosition(IndicatorPosition pos) {
   this->indicatorPosition = pos;
+  this->needsRedraw = true;
 }
 void OLEDDisplayUi::setIndicatorDirection(IndicatorDirection dir) {
   this->indicatorDirection = dir;
+  this->needsRedraw = true;
 }
 void OLEDDisplayUi::setActiveSymbol(const uint8_t* symbol) {
   this->activeSymbol = symbol;
+  this->needsRedraw = true;
 }
 void OLEDDisplayUi::setInactiveSymbol(const uint8_t* symbol) {
   this->inactiveSymbol = symbol;
+  this->needsRedraw = true;
 }
 
 
@@ -149,6 +185,30 @@ void OLEDDisplayUi::setFrames(FrameCallback* frameFunctions, uint8_t frameCount)
 void OLEDDisplayUi::setOverlays(OverlayCallback* overlayFunctions, uint8_t overlayCount){
   this->overlayFunctions = overlayFunctions;
   this->overlayCount     = overlayCount;
+  this->needsRedraw = true;
+}
+
+// -/----- Change-driven redraw -----\-
+void OLEDDisplayUi::enableChangeDrivenRedraw(){
+  this->changeDrivenRedraw = true;
+  this->needsRedraw = true;
+}
+void OLEDDisplayUi::disableChangeDrivenRedraw(){
+  this->changeDrivenRedraw = false;
+}
+void OLEDDisplayUi::setFrameChangedCallbacks(ChangedCallback* changedFunctions){
+  this->frameChangedFunctions = changedFunctions;
+  this->needsRedraw = true;
+}
+void OLEDDisplayUi::setOverlayChangedCallbacks(ChangedCallback* changedFunctions){
+  this->overlayChangedFunctions = changedFunctions;
+  this->needsRedraw = true;
+}
+void OLEDDisplayUi::invalidate(){
+  this->needsRedraw = true;
+}
+uint32_t OLEDDisplayUi::getSkippedFrames(){
+  return this->skippedFrames;
 }
 
 // -/----- Loading Process -----\-
@@ -280,6 +340,14 @@ void OLEDDisplayUi::tick() {
       break;
   }
 
+  if (this->changeDrivenRedraw && !this->shouldRedraw()) {
+    this->skippedFrames++;
+    return;
+  }
+  this->needsRedraw = false;
+  this->lastDrawnState = this->state.frameState;
+  this->lastDrawnFrame = this->state.currentFrame;
+
   this->display->clear();
   this->drawFrame();
   if (shouldDrawIndicators) {
@@ -295,41 +363,65 @@ void OLEDDisplayUi::resetState() {
   this->state.frameState = FIXED;
   this->state.currentFrame = 0;
   this->state.isIndicatorDrawn = true;
+  this->snapshotValid = false;
+  this->needsRedraw = true;
+}
+
+bool OLEDDisplayUi::shouldRedraw() {
+  if (this->needsRedraw || this->state.frameState != FIXED) return true;
+
+  // Came out of a transition or switched frames since the last draw
+  if (this->lastDrawnState != FIXED || this->lastDrawnFrame != this->state.currentFrame) return true;
+
+  // Ask every changed callback, so that each one sees every tick
+  bool changed = false;
+  if (this->frameChangedFunctions && this->frameChangedFunctions[this->state.currentFrame]) {
+    changed |= (this->frameChangedFunctions[this->state.currentFrame])(&this->state);
+  }
+  if (this->overlayChangedFunctions) {
+    for (uint8_t i = 0; i < this->overlayCount; i++) {
+      if (this->overlayChangedFunctions[i]) changed |= (this->overlayChangedFunctions[i])(&this->state);
+    }
+  }
+  return changed;
 }
 
 void OLEDDisplayUi::drawFrame(){
   switch (this->state.frameState){
      case IN_TRANSITION: {
-       float progress = 0.f;
+       // How far the frames have slid, in pixels along the direction of travel
+       int16_t x = 0, y = 0, x1 = 0, y1 = 0;
+       int16_t width = this->display->width(), height = this->display->height();
+       int16_t travel = (this->frameAnimationDirection == SLIDE_LEFT || this->frameAnimationDirection == SLIDE_RIGHT) ? width : height;
+       int16_t shift = 0;
        if (this->ticksPerTransition > 0u) {
-         progress = (float) this->state.ticksSinceLastStateSwitch / (float) this->ticksPerTransition;
+         shift = (int32_t) travel * this->state.ticksSinceLastStateSwitch / this->ticksPerTransition;
        }
-       int16_t x = 0, y = 0, x1 = 0, y1 = 0;
        switch(this->frameAnimationDirection){
         case SLIDE_LEFT:
-          x = -this->display->width() * progress;
+          x = -shift;
           y = 0;
-          x1 = x + this->display->width();
+          x1 = x + width;
           y1 = 0;
           break;
         case SLIDE_RIGHT:
-          x = this->display->width() * progress;
+          x = shift;
           y = 0;
-          x1 = x - this->display->width();
+          x1 = x - width;
           y1 = 0;
           break;
         case SLIDE_UP:
           x = 0;
-          y = -this->display->height() * progress;
+          y = -shift;
           x1 = 0;
-          y1 = y + this->display->height();
+          y1 = y + height;
           break;
         case SLIDE_DOWN:
         default:
           x = 0;
-          y = this->display->height() * progress;
+          y = shift;
           x1 = 0;
-          y1 = y - this->display->height();
+          y1 = y - height;
           break;
        }
 
@@ -337,6 +429,13 @@ void OLEDDisplayUi::drawFrame(){
        int8_t dir = this->state.frameTransitionDirection >= 0 ? 1 : -1;
        x *= dir; y *= dir; x1 *= dir; y1 *= dir;
 
+       if (this->useTransitionSnapshots && this->drawTransitionSnapshots()) {
+         this->blitSnapshot(this->snapshotBuffer, x, y);
+         this->blitSnapshot(this->snapshotBuffer + this->snapshotSize, x1, y1);
+         this->state.isIndicatorDrawn = this->snapshotIndicatorDrawn;
+         break;
+       }
+
        bool drawnCurrentFrame;
 
 
@@ -367,6 +466,7 @@ void OLEDDisplayUi::drawFrame(){
        break;
      }
      case FIXED:
+      this->snapshotValid = false;
       // Always assume that the indicator is drawn!
       // And set indicatorDrawState to "not known yet"
       this->indicatorDrawState = 0;
@@ -376,6 +476,95 @@ void OLEDDisplayUi::drawFrame(){
   }
 }
 
+bool OLEDDisplayUi::drawTransitionSnapshots() {
+  uint8_t nextFrame = this->getNextFrameNumber();
+  if (this->snapshotValid && this->snapshotFrame == this->state.currentFrame && this->snapshotNextFrame == nextFrame) {
+    return true;
+  }
+
+  uint16_t size = this->display->width() * this->display->height() / 8;
+  if (this->snapshotBuffer == NULL || this->snapshotSize != size) {
+    if (this->snapshotBuffer) free(this->snapshotBuffer);
+    this->snapshotBuffer = (uint8_t*) malloc(2 * size);
+    if (!this->snapshotBuffer) {
+      DEBUG_OLEDDISPLAYUI("[OLEDDISPLAYUI] Not enough memory for transition snapshots\n");
+      this->snapshotSize = 0;
+      return false;
+    }
+    this->snapshotSize = size;
+  }
+
+  // Draw both frames at the origin with the display pointed at the
+  // snapshots, probing each for the indicator drawn state as drawFrame does
+  uint8_t *screen = this->display->buffer;
+
+  this->display->buffer = this->snapshotBuffer;
+  this->display->clear();
+  this->enableIndicator();
+  (this->frameFunctions[this->state.currentFrame])(this->display, &this->state, 0, 0);
+  bool drawnCurrentFrame = this->state.isIndicatorDrawn;
+
+  this->display->buffer = this->snapshotBuffer + size;
+  this->display->clear();
+  this->enableIndicator();
+  (this->frameFunctions[nextFrame])(this->display, &this->state, 0, 0);
+  bool drawnNextFrame = this->state.isIndicatorDrawn;
+
+  this->display->buffer = screen;
+
+  if (drawnCurrentFrame && !drawnNextFrame) {
+    this->indicatorDrawState = 2;
+  } else if (!drawnCurrentFrame && drawnNextFrame) {
+    this->indicatorDrawState = 1;
+  } else if (!drawnCurrentFrame && !drawnNextFrame) {
+    this->indicatorDrawState = 3;
+  }
+  this->snapshotIndicatorDrawn = drawnCurrentFrame && drawnNextFrame;
+
+  this->snapshotFrame = this->state.currentFrame;
+  this->snapshotNextFrame = nextFrame;
+  this->snapshotValid = true;
+  return true;
+}
+
+// Draw a snapshot onto the display with its top left corner at (x, y),
+// clipped to the screen. The buffer is one byte per column for each page
+// of 8 rows, so a sideways shift just copies part of each page, and an
+// up/down shift moves whole pages and splits the rest across two pages.
+void OLEDDisplayUi::blitSnapshot(const uint8_t* snapshot, int16_t x, int16_t y) {
+  int16_t width = this->display->width();
+  int16_t pages = this->display->height() / 8;
+  if (x <= -width || x >= width || y <= -(pages * 8) || y >= pages * 8) return;
+
+  int16_t firstColumn = x > 0 ? x : 0;
+  int16_t columns = (x > 0 ? width - x : width + x);
+  const uint8_t *src = snapshot + firstColumn - x;
+  uint8_t *dst = this->display->buffer + firstColumn;
+
+  // y = 8 * pageShift + bitShift, with bitShift in 0-7
+  int16_t pageShift = y >= 0 ? y / 8 : -((7 - y) / 8);
+  uint8_t bitShift = y - pageShift * 8;
+
+  for (int16_t page = 0; page < pages; page++) {
+    int16_t srcPage = page - pageShift;
+    const uint8_t *lower = (srcPage >= 0 && srcPage < pages) ? src + srcPage * width : NULL;
+    const uint8_t *upper = (bitShift && srcPage >= 1 && srcPage <= pages) ? src + (srcPage - 1) * width : NULL;
+    uint8_t *out = dst + page * width;
+
+    if (bitShift == 0) {
+      if (lower) memcpy(out, lower, columns);
+      continue;
+    }
+    if (lower && upper) {
+      for (int16_t i = 0; i < columns; i++) out[i] |= (lower[i] << bitShift) | (upper[i] >> (8 - bitShift));
+    } else if (lower) {
+      for (int16_t i = 0; i < columns; i++) out[i] |= lower[i] << bitShift;
+    } else if (upper) {
+      for (int16_t i = 0; i < columns; i++) out[i] |= upper[i] >> (8 - bitShift);
+    }
+  }
+}
+
 void OLEDDisplayUi::drawIndicator() {
 
     // Only draw if the indicator is invisible
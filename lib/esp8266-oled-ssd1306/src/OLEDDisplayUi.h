@@ -109,6 +109,8 @@ struct LoadingStage {
 typedef void (*FrameCallback)(OLEDDisplay *display,  OLEDDisplayUiState* state, int16_t x, int16_t y);
 typedef void (*OverlayCallback)(OLEDDisplay *display,  OLEDDisplayUiState* state);
 typedef void (*LoadingDrawFunction)(OLEDDisplay *display, LoadingStage* stage, uint8_t progress);
+// Returns true if the matching frame or overlay would draw something different now
+typedef bool (*ChangedCallback)(OLEDDisplayUiState* state);
 
 class OLEDDisplayUi {
   private:
@@ -143,6 +145,15 @@ class OLEDDisplayUi {
     OverlayCallback*    overlayFunctions;
     uint8_t             overlayCount;
 
+    // Change-driven redraw of FIXED frames
+    bool                changeDrivenRedraw;
+    bool                needsRedraw;
+    ChangedCallback*    frameChangedFunctions;
+    ChangedCallback*    overlayChangedFunctions;
+    FrameState          lastDrawnState;
+    uint8_t             lastDrawnFrame;
+    uint32_t            skippedFrames;
+
     // Will the Indicator be drawn
     // 3 Not drawn in both frames
     // 2 Drawn this frame but not next
@@ -162,9 +173,22 @@ class OLEDDisplayUi {
     uint16_t            timePerFrame;
     uint16_t            timePerTransition;
 
+    // Off-screen snapshots of the two frames in a transition, drawn once
+    // when it starts and then shifted into place on every tick
+    bool                useTransitionSnapshots;
+    uint8_t*            snapshotBuffer;       // both snapshots, one after the other
+    uint16_t            snapshotSize;         // size of one snapshot in bytes
+    bool                snapshotValid;
+    uint8_t             snapshotFrame;        // frame in the first snapshot
+    uint8_t             snapshotNextFrame;    // frame in the second snapshot
+    bool                snapshotIndicatorDrawn;
+
     uint8_t             getNextFrameNumber();
     void                drawIndicator();
     void                drawFrame();
+    bool                drawTransitionSnapshots();
+    bool                shouldRedraw();
+    void                blitSnapshot(const uint8_t* snapshot, int16_t x, int16_t y);
     void                drawOverlays();
     void                tick();
     void                resetState();
@@ -172,6 +196,7 @@ class OLEDDisplayUi {
   public:
 
     OLEDDisplayUi(OLEDDisplay *display);
+    ~OLEDDisplayUi();
 
     /**
      * Initialise the display
@@ -210,6 +235,22 @@ class OLEDDisplayUi {
      */
     void setTimePerTransition(uint16_t time);
 
+    /**
+     * Draw both frames of a transition once, into off-screen buffers, when
+     * the transition starts, and slide those instead of calling the frame
+     * functions on every tick. Frames then keep their content for the
+     * whole transition, and nothing drawn outside their bounds is shown.
+     * It needs two extra display buffers; if they can't be allocated the
+     * frames are drawn directly as before.
+     */
+    void enableTransitionSnapshots();
+
+    /**
+     * Call the frame functions on every tick of a transition. This is the
+     * default.
+     */
+    void disableTransitionSnapshots();
+
     // Customize indicator position and style
 
     /**
@@ -277,6 +318,42 @@ class OLEDDisplayUi {
      */
     void setOverlays(OverlayCallback* overlayFunctions, uint8_t overlayCount);
 
+    // Change-driven redraw
+
+    /**
+     * Only redraw and send a FIXED frame when something has changed: when
+     * `invalidate()` was called, a changed callback returns true, or the UI
+     * itself moved to another frame. Transitions are always drawn.
+     */
+    void enableChangeDrivenRedraw();
+
+    /**
+     * Redraw on every tick. This is the default.
+     */
+    void disableChangeDrivenRedraw();
+
+    /**
+     * Set functions reporting whether each frame has changed, one for each
+     * frame passed to `setFrames`. NULL entries only redraw on `invalidate()`.
+     */
+    void setFrameChangedCallbacks(ChangedCallback* changedFunctions);
+
+    /**
+     * Set functions reporting whether each overlay has changed, one for each
+     * overlay passed to `setOverlays`.
+     */
+    void setOverlayChangedCallbacks(ChangedCallback* changedFunctions);
+
+    /**
+     * Redraw the screen on the next tick, e.g. after a value shown on it changed
+     */
+    void invalidate();
+
+    /**
+     * The number of ticks on which nothing was redrawn because nothing changed
+     */
+    uint32_t getSkippedFrames();
+
 
     // Loading animation
     /**
@@ -44,6 +44,7 @@
 #define SH1106_SET_PUMP_MODE 0XAD
 #define SH1106_PUMP_ON 0X8B
 #define SH1106_PUMP_OFF 0X8A
+#define SH1106_PAGES 8 /** The SH1106 has 8 pages of RAM */
 //--------------------------------------
 
 class SH1106Wire : public OLEDDisplay {
@@ -103,80 +104,19 @@ class SH1106Wire : public OLEDDisplay {
     void display(void) {
       initI2cIfNeccesary();
       #ifdef OLEDDISPLAY_DOUBLE_BUFFER
-        uint8_t minBoundY = UINT8_MAX;
-        uint8_t maxBoundY = 0;
-
-        uint8_t minBoundX = UINT8_MAX;
-        uint8_t maxBoundX = 0;
-
-        uint8_t x, y;
-
-        // Calculate the Y bounding box of changes
-        // and copy buffer[pos] to buffer_back[pos];
-        for (y = 0; y < (displayHeight / 8); y++) {
-          for (x = 0; x < displayWidth; x++) {
-           uint16_t pos = x + y * displayWidth;
-           if (buffer[pos] != buffer_back[pos]) {
-             minBoundY = _min(minBoundY, y);
-             maxBoundY = _max(maxBoundY, y);
-             minBoundX = _min(minBoundX, x);
-             maxBoundX = _max(maxBoundX, x);
-           }
-           buffer_back[pos] = buffer[pos];
-         }
-         yield();
-        }
-
-        // If the minBoundY wasn't updated
-        // we can savely assume that buffer_back[pos] == buffer[pos]
-        // holdes true for all values of pos
-        if (minBoundY == UINT8_MAX) return;
-
-        // Calculate the colum offset
-        uint8_t minBoundXp2H = (minBoundX + 2) & 0x0F;
-        uint8_t minBoundXp2L = 0x10 | ((minBoundX + 2) >> 4 );
-
-        uint8_t k = 0;
-        for (y = minBoundY; y <= maxBoundY; y++) {
-          sendCommand(0xB0 + y);
-          sendCommand(minBoundXp2H);
-          sendCommand(minBoundXp2L);
-          for (x = minBoundX; x <= maxBoundX; x++) {
-            if (k == 0) {
-              _wire->beginTransmission(_address);
-              _wire->write(0x40);
-            }
-            _wire->write(buffer[x + y * displayWidth]);
-            k++;
-            if (k == I2C_OLED_TRANSFER_BYTE)  {
-              _wire->endTransmission();
-              k = 0;
-            }
-          }
-          if (k != 0)  {
-            _wire->endTransmission();
-            k = 0;
-          }
+        // The SH1106 addresses each page separately, so rather than one
+        // bounding box send each changed page with its own column range
+        uint8_t dirtyFirst[SH1106_PAGES], dirtyLast[SH1106_PAGES];
+        if (!updateDirtyPages(dirtyFirst, dirtyLast, SH1106_PAGES)) return;
+
+        for (uint8_t y = 0; y < pageCount(); y++) {
+          if (dirtyFirst[y] > dirtyLast[y]) continue;
+          sendPage(y, dirtyFirst[y], dirtyLast[y]);
           yield();
         }
-
-        if (k != 0) {
-          _wire->endTransmission();
-        }
       #else
-        uint8_t * p = &buffer[0];
-        for (uint8_t y=0; y<8; y++) {
-          sendCommand(0xB0+y);
-          sendCommand(0x02);
-          sendCommand(0x10);
-          for( uint8_t x=0; x<(128/I2C_OLED_TRANSFER_BYTE); x++) {
-            _wire->beginTransmission(_address);
-            _wire->write(0x40);
-            for (uint8_t k = 0; k < I2C_OLED_TRANSFER_BYTE; k++) {
-              _wire->write(*p++);
-            }
-            _wire->endTransmission();
-          }
+        for (uint8_t y = 0; y < pageCount(); y++) {
+          sendPage(y, 0, displayWidth - 1);
         }
       #endif
     }
@@ -189,6 +129,10 @@ class SH1106Wire : public OLEDDisplay {
 	int getBufferOffset(void) {
 		return 0;
 	}
+    // Pages to send: the geometry's, but no more than the controller has
+    inline uint8_t pageCount(void) {
+      return (displayHeight / 8 < SH1106_PAGES) ? displayHeight / 8 : SH1106_PAGES;
+    }
     inline void sendCommand(uint8_t command) __attribute__((always_inline)){
       _wire->beginTransmission(_address);
       _wire->write(0x80);
@@ -196,6 +140,31 @@ class SH1106Wire : public OLEDDisplay {
       _wire->endTransmission();
     }
 
+    // Send columns firstX..lastX of page y. The page and column address
+    // go in one transmission, and the column is offset by 2 because the
+    // SH1106 has 132 columns of RAM centred on the 128 column panel.
+    void sendPage(uint8_t y, uint8_t firstX, uint8_t lastX) {
+      uint8_t column = firstX + 2;
+      _wire->beginTransmission(_address);
+      _wire->write(0x00);   // command stream
+      _wire->write(0xB0 + y);
+      _wire->write(column & 0x0F);
+      _wire->write(0x10 | (column >> 4));
+      _wire->endTransmission();
+
+      const uint8_t *p = buffer + firstX + y * displayWidth;
+      uint16_t remaining = lastX - firstX + 1;
+      while (remaining) {
+        uint8_t chunk = remaining < I2C_OLED_TRANSFER_BYTE ? remaining : I2C_OLED_TRANSFER_BYTE;
+        _wire->beginTransmission(_address);
+        _wire->write(0x40);
+        _wire->write(p, chunk);
+        _wire->endTransmission();
+        p += chunk;
+        remaining -= chunk;
+      }
+    }
+
     void initI2cIfNeccesary() {
       if (_doI2cAutoInit) {
 #ifdef ARDUINO_ARCH_AVR
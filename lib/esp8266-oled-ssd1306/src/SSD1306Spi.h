@@ -40,12 +40,35 @@
   #define BRZO_I2C_SPEED 800
 #endif
 
+// The ESP cores can send a whole buffer with one SPI.writeBytes call
+#if defined(ARDUINO_ARCH_ESP32) || defined(ARDUINO_ARCH_ESP8266)
+#define SSD1306SPI_WRITE_BYTES
+#endif
+
+// On the ESP32 the transfer can be handed to a background task, see setQueuedTransfer()
+#if defined(ARDUINO_ARCH_ESP32) && defined(OLEDDISPLAY_DOUBLE_BUFFER)
+#define SSD1306SPI_QUEUED_TRANSFER
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#endif
+
 class SSD1306Spi : public OLEDDisplay {
   private:
       uint8_t             _rst;
       uint8_t             _dc;
       uint8_t             _cs;
 
+      // First and last changed column of each page, first > last if unchanged
+      uint8_t*            _dirtyFirst = NULL;
+      uint8_t*            _dirtyLast = NULL;
+
+#ifdef SSD1306SPI_QUEUED_TRANSFER
+      bool                _queued = false;
+      TaskHandle_t        _transferTask = NULL;
+      SemaphoreHandle_t   _transferIdle = NULL;
+#endif
+
   public:
     /* pass _cs as -1 to indicate "do not use CS pin", for cases where it is hard wired low */
     SSD1306Spi(uint8_t rst, uint8_t dc, uint8_t cs, OLEDDISPLAY_GEOMETRY g = GEOMETRY_128_64) {
@@ -56,6 +79,17 @@ class SSD1306Spi : public OLEDDisplay {
       this->_cs  = cs;
     }
 
+    ~SSD1306Spi() {
+#ifdef SSD1306SPI_QUEUED_TRANSFER
+      if (_transferTask) {
+        waitForTransfer();
+        vTaskDelete(_transferTask);
+        vSemaphoreDelete(_transferIdle);
+      }
+#endif
+      if (_dirtyFirst) free(_dirtyFirst);
+    }
+
     bool connect(){
       pinMode(_dc, OUTPUT);
       if (_cs != (uint8_t) -1) {
@@ -72,82 +106,81 @@ class SSD1306Spi : public OLEDDisplay {
       digitalWrite(_rst, LOW);
       delay(10);
       digitalWrite(_rst, HIGH);
+
+    #ifdef OLEDDISPLAY_DOUBLE_BUFFER
+      if (_dirtyFirst == NULL) {
+        _dirtyFirst = (uint8_t*) malloc(2 * (displayHeight / 8));
+        if (!_dirtyFirst) return false;
+        _dirtyLast = _dirtyFirst + (displayHeight / 8);
+      }
+    #endif
       return true;
     }
 
+#ifdef SSD1306SPI_QUEUED_TRANSFER
+    /**
+     * Let display() return as soon as it has worked out what changed, and
+     * send the changes from a background task while the next frame is
+     * drawn. The next display() or command waits for the transfer to end.
+     * Nothing else may use the SPI bus from another task meanwhile.
+     */
+    void setQueuedTransfer(bool queued) {
+      waitForTransfer();
+      if (queued && _transferTask == NULL) {
+        _transferIdle = xSemaphoreCreateBinary();
+        if (_transferIdle == NULL) return;
+        xSemaphoreGive(_transferIdle);
+        if (xTaskCreate(transferTask, "SSD1306Spi", 2048, this, 1, &_transferTask) != pdPASS) {
+          vSemaphoreDelete(_transferIdle);
+          _transferIdle = NULL;
+          _transferTask = NULL;
+          return;
+        }
+      }
+      _queued = queued;
+    }
+
+    /**
+     * Wait until a queued transfer has been sent
+     */
+    void waitForTransfer() {
+      if (_transferTask) {
+        xSemaphoreTake(_transferIdle, portMAX_DELAY);
+        xSemaphoreGive(_transferIdle);
+      }
+    }
+#endif
+
     void display(void) {
     #ifdef OLEDDISPLAY_DOUBLE_BUFFER
-       uint8_t minBoundY = UINT8_MAX;
-       uint8_t maxBoundY = 0;
-
-       uint8_t minBoundX = UINT8_MAX;
-       uint8_t maxBoundX = 0;
-
-       uint8_t x, y;
-
-       // Calculate the Y bounding box of changes
-       // and copy buffer[pos] to buffer_back[pos];
-       for (y = 0; y < (displayHeight / 8); y++) {
-         for (x = 0; x < displayWidth; x++) {
-          uint16_t pos = x + y * displayWidth;
-          if (buffer[pos] != buffer_back[pos]) {
-            minBoundY = _min(minBoundY, y);
-            maxBoundY = _max(maxBoundY, y);
-            minBoundX = _min(minBoundX, x);
-            maxBoundX = _max(maxBoundX, x);
-          }
-          buffer_back[pos] = buffer[pos];
-        }
-        yield();
-       }
-
-       // If the minBoundY wasn't updated
-       // we can savely assume that buffer_back[pos] == buffer[pos]
-       // holdes true for all values of pos
-       if (minBoundY == UINT8_MAX) return;
-
-       sendCommand(COLUMNADDR);
-       sendCommand(minBoundX);
-       sendCommand(maxBoundX);
-
-       sendCommand(PAGEADDR);
-       sendCommand(minBoundY);
-       sendCommand(maxBoundY);
-
-       set_CS(HIGH);
-       digitalWrite(_dc, HIGH);   // data mode
-       set_CS(LOW);
-       for (y = minBoundY; y <= maxBoundY; y++) {
-         for (x = minBoundX; x <= maxBoundX; x++) {
-           SPI.transfer(buffer[x + y * displayWidth]);
-         }
-         yield();
-       }
-       set_CS(HIGH);
-     #else
-       // No double buffering
-       sendCommand(COLUMNADDR);
-       sendCommand(0x0);
-       sendCommand(0x7F);
-
-       sendCommand(PAGEADDR);
-       sendCommand(0x0);
-
-       if (geometry == GEOMETRY_128_64 || geometry == GEOMETRY_64_48 || geometry == GEOMETRY_64_32 ) {
-         sendCommand(0x7);
-       } else if (geometry == GEOMETRY_128_32) {
-         sendCommand(0x3);
-       }
-
-        set_CS(HIGH);
-        digitalWrite(_dc, HIGH);   // data mode
-        set_CS(LOW);
-        for (uint16_t i=0; i<displayBufferSize; i++) {
-          SPI.transfer(buffer[i]);
-          yield();
-        }
-        set_CS(HIGH);
-     #endif
+    #ifdef SSD1306SPI_QUEUED_TRANSFER
+      // The task sends from buffer_back, so it must be done before it is updated
+      if (_transferTask) xSemaphoreTake(_transferIdle, portMAX_DELAY);
+    #endif
+
+      if (!updateDirtyPages(_dirtyFirst, _dirtyLast, displayHeight / 8)) {
+    #ifdef SSD1306SPI_QUEUED_TRANSFER
+        if (_transferTask) xSemaphoreGive(_transferIdle);
+    #endif
+        return;
+      }
+
+    #ifdef SSD1306SPI_QUEUED_TRANSFER
+      if (_queued) {
+        xTaskNotifyGive(_transferTask);
+        return;
+      }
+    #endif
+
+      sendChanges();
+
+    #ifdef SSD1306SPI_QUEUED_TRANSFER
+      if (_transferTask) xSemaphoreGive(_transferIdle);
+    #endif
+    #else
+      // No double buffering
+      sendRegion(buffer, 0, displayWidth - 1, 0, displayHeight / 8 - 1);
+    #endif
     }
 
   private:
@@ -159,13 +192,77 @@ class SSD1306Spi : public OLEDDisplay {
         digitalWrite(_cs, level);
       }
     };
-    inline void sendCommand(uint8_t com) __attribute__((always_inline)){
+    inline void writeBytes(const uint8_t *data, uint16_t length) {
+    #ifdef SSD1306SPI_WRITE_BYTES
+      SPI.writeBytes((uint8_t *) data, length);
+    #else
+      while (length--) SPI.transfer(*data++);
+    #endif
+    }
+    // Send a run of command bytes with a single CS/DC setup
+    void writeCommands(const uint8_t *commands, uint8_t length) {
       set_CS(HIGH);
       digitalWrite(_dc, LOW);
       set_CS(LOW);
-      SPI.transfer(com);
+      writeBytes(commands, length);
+      set_CS(HIGH);
+    }
+    inline void sendCommand(uint8_t com) __attribute__((always_inline)){
+    #ifdef SSD1306SPI_QUEUED_TRANSFER
+      waitForTransfer();
+    #endif
+      writeCommands(&com, 1);
+    }
+
+    // Send the columns firstX..lastX of pages firstY..lastY from src,
+    // setting the address window once and holding CS low for all the data
+    void sendRegion(const uint8_t *src, uint8_t firstX, uint8_t lastX, uint8_t firstY, uint8_t lastY) {
+      const uint8_t window[] = { COLUMNADDR, firstX, lastX, PAGEADDR, firstY, lastY };
+      writeCommands(window, sizeof(window));
+
+      set_CS(HIGH);
+      digitalWrite(_dc, HIGH);   // data mode
+      set_CS(LOW);
+      if (firstX == 0 && lastX == displayWidth - 1) {
+        // Whole pages are contiguous in the buffer
+        writeBytes(src + firstY * displayWidth, (lastY - firstY + 1) * displayWidth);
+      } else {
+        for (uint8_t y = firstY; y <= lastY; y++) {
+          writeBytes(src + firstX + y * displayWidth, lastX - firstX + 1);
+        }
+      }
       set_CS(HIGH);
     }
+
+#ifdef OLEDDISPLAY_DOUBLE_BUFFER
+    // Send the pages marked dirty by display(), merging runs of adjacent
+    // dirty pages into one region covering all their changed columns
+    void sendChanges() {
+      const uint8_t pages = displayHeight / 8;
+      uint8_t y = 0;
+      while (y < pages) {
+        if (_dirtyFirst[y] > _dirtyLast[y]) { y++; continue; }
+        uint8_t firstY = y, firstX = _dirtyFirst[y], lastX = _dirtyLast[y];
+        while (++y < pages && _dirtyFirst[y] <= _dirtyLast[y]) {
+          if (_dirtyFirst[y] < firstX) firstX = _dirtyFirst[y];
+          if (_dirtyLast[y] > lastX) lastX = _dirtyLast[y];
+        }
+        sendRegion(buffer_back, firstX, lastX, firstY, y - 1);
+        yield();
+      }
+    }
+#endif
+
+#ifdef SSD1306SPI_QUEUED_TRANSFER
+    static void transferTask(void *arg) {
+      SSD1306Spi *self = (SSD1306Spi *) arg;
+      for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        self->sendChanges();
+        xSemaphoreGive(self->_transferIdle);
+      }
+    }
+#endif
 };
 
 #endif
@@ -0,0 +1,108 @@
+// ****************************************************************************
+// Title		: Button Events
+// File Name	: 'button_events.cpp'
+// Target MCU	: Espressif ESP32 (Doit DevKit Version 1)
+// ****************************************************************************
+
+// Include Files
+// ****************************************************************************
+#include "button_events.h"
+
+// Functions
+// ****************************************************************************
+void ButtonEvents::begin(uint32_t now, bool down)
+{
+	_lastTime = now;
+	_raw = _down = _edgeDown = down;
+	_level = down ? BUTTON_SETTLE_US : 0;
+}
+
+void ButtonEvents::update(uint32_t now, bool down)
+{
+	ButtonEdge queued;
+	while (_edges.pop(queued))
+	{
+		advance(queued.time);
+		_raw = queued.down;
+	}
+	advance(now);
+	_raw = down;
+}
+
+bool ButtonEvents::read(ButtonEvent &event)
+{
+	return _events.pop(event);
+}
+
+bool ButtonEvents::isDown(void) const
+{
+	return _down;
+}
+
+// Run the integrator at the current contact level up to time
+void ButtonEvents::advance(uint32_t time)
+{
+	int32_t elapsed = time - _lastTime;
+	if (elapsed <= 0) // Edge queued after now was read
+	{
+		return;
+	}
+
+	if (_raw)
+	{
+		if (!_down && _level + elapsed >= BUTTON_SETTLE_US)
+		{
+			pressed(_lastTime + (BUTTON_SETTLE_US - _level));
+		}
+		_level = _level + elapsed >= BUTTON_SETTLE_US ? BUTTON_SETTLE_US : _level + elapsed;
+	}
+	else
+	{
+		if (_down && (uint32_t) elapsed >= _level)
+		{
+			released(_lastTime + _level);
+		}
+		_level = _level > (uint32_t) elapsed ? _level - elapsed : 0;
+	}
+	_lastTime = time;
+
+	if (_down && !_longSent && time - _pressTime >= BUTTON_LONG_PRESS_US)
+	{
+		_longSent = true;
+		send(BUTTON_LONG_PRESS, _pressTime + BUTTON_LONG_PRESS_US);
+	}
+}
+
+void ButtonEvents::pressed(uint32_t time)
+{
+	_down = true;
+	_pressTime = time;
+	_longSent = false;
+	send(BUTTON_PRESS, time);
+
+	_secondClick = _clickOpen && time - _releaseTime <= BUTTON_DOUBLE_CLICK_US;
+	_clickOpen = false;
+	if (_secondClick)
+	{
+		send(BUTTON_DOUBLE_CLICK, time);
+	}
+}
+
+void ButtonEvents::released(uint32_t time)
+{
+	if (!_longSent && time - _pressTime >= BUTTON_LONG_PRESS_US) // Crossed the limit since the last update
+	{
+		_longSent = true;
+		send(BUTTON_LONG_PRESS, _pressTime + BUTTON_LONG_PRESS_US);
+	}
+	_down = false;
+	_releaseTime = time;
+	_clickOpen = !_longSent && !_secondClick;
+	send(BUTTON_RELEASE, time);
+}
+
+void ButtonEvents::send(uint8_t type, uint32_t time)
+{
+	ButtonEvent event = {type, time};
+	_events.push(event); // Dropped if the loop is not reading events
+}
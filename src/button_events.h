@@ -0,0 +1,107 @@
+// ****************************************************************************
+// Title		: Button Events
+// File Name	: 'button_events.h'
+// Target MCU	: Espressif ESP32 (Doit DevKit Version 1)
+//
+// Debounces a push button from timestamped edges rather than by polling.
+// A pin interrupt calls edge() with the time and new level, which only
+// queues them. update(), called from the loop, replays the edges through
+// an integrator: the integrator runs up while the contact reads down and
+// back while it reads up, and the button only changes state when it hits
+// either end, BUTTON_SETTLE_US apart. Because the integrator is driven by
+// the edge times and not by how often update() runs, events carry the
+// time they actually happened even when the loop has stalled.
+//
+// On top of that the presses are turned into events: press, release, long
+// press (held for BUTTON_LONG_PRESS_US, sent while still held) and double
+// click (pressed again within BUTTON_DOUBLE_CLICK_US of a short click).
+// ****************************************************************************
+
+#ifndef button_events_H
+#define button_events_H
+#pragma once
+
+// Include Files
+// ****************************************************************************
+#include <stdint.h>
+#include "spsc_queue.h"
+
+// Constants
+// ****************************************************************************
+const uint32_t BUTTON_SETTLE_US = 10000;			// Contact must settle this long
+const uint32_t BUTTON_LONG_PRESS_US = 800000;		// Held this long is a long press
+const uint32_t BUTTON_DOUBLE_CLICK_US = 400000;		// Release to next press for a double click
+
+enum ButtonEventType
+{
+	BUTTON_PRESS,
+	BUTTON_RELEASE,
+	BUTTON_LONG_PRESS,
+	BUTTON_DOUBLE_CLICK		// Sent after the BUTTON_PRESS of the second click
+};
+
+struct ButtonEvent
+{
+	uint8_t type;	// ButtonEventType
+	uint32_t time;	// When it happened, in µs
+};
+
+struct ButtonEdge
+{
+	uint32_t time;
+	bool down;
+};
+
+// Class
+// ****************************************************************************
+class ButtonEvents
+{
+public:
+	// Take the level the pin reads now as settled. Call before the interrupt
+	// is attached.
+	void begin(uint32_t now, bool down);
+
+	// Call from the pin interrupt with micros() and whether the button reads down
+	inline void edge(uint32_t time, bool down)
+	{
+		if (down == _edgeDown) // Bounced back before the interrupt ran
+		{
+			return;
+		}
+		ButtonEdge newEdge = {time, down};
+		if (_edges.push(newEdge))	// If full, update() still gets the level right
+		{
+			_edgeDown = down;
+		}
+	}
+
+	// Process the queued edges up to now, in µs. down is the level the pin
+	// reads now, which covers any edges that did not fit in the queue.
+	void update(uint32_t now, bool down);
+
+	bool read(ButtonEvent &event);	// Next event, oldest first
+	bool isDown(void) const;		// Debounced state
+
+private:
+	SpscQueue<ButtonEdge, 64> _edges;	// Interrupt -> update()
+	bool _edgeDown = false;				// Level of the last queued edge; interrupt only
+	SpscQueue<ButtonEvent, 8> _events;	// update() -> read()
+
+	uint32_t _lastTime = 0;		// Integrated up to here
+	uint32_t _level = 0;		// Integrator, 0 to BUTTON_SETTLE_US
+	bool _raw = false;			// Contact reads down
+	bool _down = false;			// Debounced state
+
+	uint32_t _pressTime = 0;
+	uint32_t _releaseTime = 0;
+	bool _longSent = false;		// This press has become a long press
+	bool _secondClick = false;	// This press is the second of a double click
+	bool _clickOpen = false;	// A short click ended; another press makes a double
+
+	void advance(uint32_t time);
+	void pressed(uint32_t time);
+	void released(uint32_t time);
+	void send(uint8_t type, uint32_t time);
+};
+
+#endif // button_events_H
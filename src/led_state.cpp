@@ -0,0 +1,66 @@
+// ****************************************************************************
+// Title		: LED State
+// File Name	: 'led_state.cpp'
+// Target MCU	: Espressif ESP32 (Doit DevKit Version 1)
+// ****************************************************************************
+
+// Include Files
+// ****************************************************************************
+#include "led_state.h"
+
+// Constructor
+// ****************************************************************************
+LedStateMachine::LedStateMachine(uint16_t blinkInterval)
+{
+	_blinkInterval = blinkInterval;
+}
+
+// Functions
+// ****************************************************************************
+bool LedStateMachine::update(uint32_t now, LEDState mode, uint8_t color, uint8_t brightness)
+{
+	bool refresh = false;
+
+	if (!_started || mode != _mode)
+	{
+		_started = true;
+		_mode = mode;
+		_lit = mode != OFF;	// Blinking starts lit
+		_deadline = now + _blinkInterval;
+		refresh = true;
+	}
+	else if (_mode == BLINK && (int32_t) (now - _deadline) >= 0)
+	{
+		// Edges missed while the loop was busy are skipped, keeping the phase
+		uint32_t edges = 1 + (now - _deadline) / _blinkInterval;
+		_deadline += edges * _blinkInterval;
+		if (edges & 1)
+		{
+			_lit = !_lit;
+			refresh = true;
+		}
+	}
+
+	if (color != _color || brightness != _brightness)
+	{
+		_color = color;
+		_brightness = brightness;
+		refresh |= _lit;	// A dark LED picks up the change when it lights
+	}
+	return refresh;
+}
+
+bool LedStateMachine::lit(void) const
+{
+	return _lit;
+}
+
+bool LedStateMachine::hasWake(void) const
+{
+	return _mode == BLINK;
+}
+
+uint32_t LedStateMachine::nextWake(void) const
+{
+	return _deadline;
+}
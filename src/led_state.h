@@ -0,0 +1,52 @@
+// ****************************************************************************
+// Title		: LED State
+// File Name	: 'led_state.h'
+// Target MCU	: Espressif ESP32 (Doit DevKit Version 1)
+//
+// Decides when the RGB LED needs writing. The loop hands over the wanted
+// mode, colour and brightness on every pass, and update() only asks for a
+// refresh when one of them changes in a way that shows, or when a blink
+// edge is due. Blink edges are scheduled from the moment blinking started,
+// so they do not drift with the loop. nextWake() gives the time of the next
+// edge, for a loop that wants to sleep until then.
+// ****************************************************************************
+
+#ifndef led_state_H
+#define led_state_H
+#pragma once
+
+// Include Files
+// ****************************************************************************
+#include <stdint.h>
+
+// Constants
+// ****************************************************************************
+enum LEDState { OFF, ON, BLINK };	// LED state modes
+enum Color { Red, Green, Blue, Yellow, Cyan, Purple, Orange };	// LED colours
+
+// Class
+// ****************************************************************************
+class LedStateMachine
+{
+public:
+	LedStateMachine(uint16_t blinkInterval);	// Time on, and time off, in ms
+
+	// Catch up to now, in ms. Returns true when the LED has to be written,
+	// and lit() then says whether it should show the colour or be dark.
+	bool update(uint32_t now, LEDState mode, uint8_t color, uint8_t brightness);
+
+	bool lit(void) const;
+	bool hasWake(void) const;		// There is a blink edge coming
+	uint32_t nextWake(void) const;	// Time of that edge, in ms
+
+private:
+	uint16_t _blinkInterval;
+	bool _started = false;
+	LEDState _mode = OFF;
+	uint8_t _color = 0;
+	uint8_t _brightness = 0;
+	bool _lit = false;
+	uint32_t _deadline = 0;		// Next blink edge
+};
+
+#endif // led_state_H
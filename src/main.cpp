@@ -26,7 +26,12 @@
 #include <SSD1306Wire.h>            // OLED display library
 #include <stdint.h>                 // Standard integer library
 #include <FastLED.h>                // FastLED library for RGB LED
-#include <debounce.h>               // Debounce library for push button
+#include "button_events.h"          // Interrupt-driven push button events
+#include "led_state.h"              // When the RGB LED needs writing
+#include "serial_command.h"         // Serial line reader and name hashing
+#include "serial_frame.h"           // Binary frames on the serial link
+#include "telemetry.h"              // Rate-limited ADC reports
+#include "spsc_queue.h"             // Lock-free queues between tasks
 
 // Globals
 // *************************************************************************
@@ -37,13 +42,11 @@ unsigned long ledBlinkTime = 0;        // Time for the next blink
 
 ADS1115 ADS(0x48);                     // Create an ADS1115 object with the default I2C address 0x48
 SSD1306Wire display(0x3c, SDA, SCL);   // OLED display
+Telemetry telemetry;                   // Reports the ADC readings over serial
+const uint8_t ADC_PERIOD_MS = 8;       // One sample per conversion at 128 SPS
+SpscQueue<int16_t, 64> adcSamples;     // adcTask -> loop
+volatile uint32_t adcOverruns = 0;     // Samples that did not fit in adcSamples
 
-enum Position               // Text position on the OLED display         
-{ TOP, 
-  MIDDLE, 
-  BOTTOM, 
-  UNKNOWN 
-}; 
 const uint8_t TOP_Y = 0;              // Y position for the top line
 const uint8_t MIDDLE_Y = 24;          // Y position for the middle line
 const uint8_t BOTTOM_Y = 48;          // Y position for the bottom line
@@ -53,28 +56,22 @@ const uint8_t Roboto_Mono_14 []       // Font 1 for the OLED display
 
 };
 
-String inputString = "";           // A string to hold incoming serial data
-bool stringComplete = false;       // Whether the string is complete
+SerialLineReader serialReader;      // Collects incoming serial data a line at a time
+FrameDecoder frameDecoder;          // Collects incoming binary frames
+FrameWriter frameReply;             // Status frame sent back for each binary frame
+SpscQueue<uint8_t, 1024> serialBytes;  // serialReceive -> loop
+volatile uint32_t serialOverruns = 0;  // Bytes that did not fit in serialBytes
  
-String topText = "Top Line";        // Text for the top line
-String middleText = "Middle Line";  // Text for the middle line
-String bottomText = "Bottom Line";  // Text for the bottom line
+char topText[SERIAL_LINE_SIZE + 1] = "Top Line";        // Text for the top line
+char middleText[SERIAL_LINE_SIZE + 1] = "Middle Line";  // Text for the middle line
+char bottomText[SERIAL_LINE_SIZE + 1] = "Bottom Line";  // Text for the bottom line
 
 // Define the number of LEDs and the data pin
 const uint8_t NUM_LEDS = 1;         // Number of LEDs
 const uint8_t DATA_PIN = 16;        // Data pin for the LED strip
 CRGB leds[NUM_LEDS];                // Define the LED strip
 
-// Define the colors
-enum Color                          // Enum for the LED colors
-{ Red, 
-  Green, 
-  Blue, 
-  Yellow, 
-  Cyan, 
-  Purple, 
-  Orange 
-};
+// Current color, see Color in led_state.h
 Color currentColor = Red; 
 
 // Brightness control
@@ -83,37 +80,42 @@ bool increasing = true;   // Direction of brightness change
 
 // Push button
 const uint8_t BUTTON_PIN = 17;    // GPIO pin for the push button
-enum LEDState { OFF, ON, BLINK };  // LED state modes
 LEDState ledStateMode = OFF;       // Initial LED state mode
-unsigned long buttonDebounceTime = 0;  // Time for the next button debounce
-const uint16_t DEBOUNCE_DELAY = 50;    // Debounce delay in milliseconds
+LedStateMachine ledMachine(BLINK_INTERVAL);  // Decides when to call FastLED.show()
+ButtonEvents buttonEvents;         // Fed by buttonISR
 
 // Function Prototypes
 // *************************************************************************
 void updateLEDState();               // Update the LED state
 CRGB getColorFromEnum(Color color);  // Get the CRGB color from the enum
 void displayAllText();               // Display all text on the OLED display
-void processSerialCommand();         // Process the serial command
+void processSerialCommand(TextView line);  // Process the serial command
 void checkButtonState();             // Check the button state
-Position getPositionFromString(const String &posStr);  // Get the position from the string
+void processSerialFrame();           // Process a binary frame
+void sendFrameStatus(uint8_t seq, uint8_t result);  // Reply to a binary frame
+void processSerialInput();           // Handle the bytes queued by serialReceive
+void serialReceive();                // Queue received bytes, runs in the UART task
+void adcTask(void *parameter);       // Queue ADC samples, runs on the other core
+void buttonISR();                    // Queue button edges
 
 // Setup Code
 // *************************************************************************
 void setup() 
 {
   Serial.begin(115200);           // Initialize serial communication at 115200 baud rate
+  Serial.onReceive(serialReceive);  // Take bytes out of the UART as soon as they arrive
   Serial.println("ADS testing");  // Print a message to the serial monitor
-  inputString.reserve(128);       // Reserve memory for the input string
   Wire.begin();                   // Initialize I2C communication
   ADS.begin();                    // Initialize ADS1115
   pinMode(LED, OUTPUT);           // Initialize the LED pin as an output
 
   ADS.setGain(1);                // Set gain to 1 (±4.096V)
   ADS.setMode(0);                // Set to continuous conversion mode
-  ADS.getValue();                // Read the initial value
+  ADS.requestADC(0);             // Start converting channel 0
+  telemetry.setScale(ADS.toVoltage(1000) * 1000);  // Microvolts per bit
+  xTaskCreatePinnedToCore(adcTask, "adc", 2048, NULL, 1, NULL, 0);  // Loop runs on core 1
 
   // OLED Display Setup
-  inputString.reserve(128);      // Reserve memory for the input string
   display.init();                // Initialize the OLED display
   display.displayOn();           // Turn on the display
   display.clear();               // Clear the display
@@ -122,10 +124,13 @@ void setup()
 
   // RGB LED Setup
   FastLED.addLeds<WS2812B, DATA_PIN, GRB>(leds, NUM_LEDS); // Initialize LED
+  FastLED.setSkipUnchanged(true);  // Only resend the LED data when it changes
   FastLED.show();                // Display the initial LED state
 
   // Button Setup
   pinMode(BUTTON_PIN, INPUT_PULLUP); 
+  buttonEvents.begin(micros(), digitalRead(BUTTON_PIN) == LOW);
+  attachInterrupt(BUTTON_PIN, buttonISR, CHANGE);
 
   // Print the initial message
   Serial.println("\nText Display Example"); 
@@ -145,24 +150,31 @@ void loop()
     ledBlinkTime = millis();                 // Update the blink time
   }
 
-  // Read the value from the ADS1115
-  int16_t value0 = ADS.readADC(0);           // Read the value from ADS1115
-  float voltage0 = ADS.toVoltage(2) / 2;     // Convert the value to voltage
-  Serial.print("Analog0: ");                 // Print the channel name
-  Serial.print(value0);                      // Print the raw value
-  Serial.print("\t ");                       // Print a tab character
-  Serial.println(value0 * voltage0, 3);      // Print the voltage value
+  // Summarise the samples taken by adcTask
+  static uint32_t countedOverruns = 0;
+  uint32_t overruns = adcOverruns;
+  telemetry.addDropped(overruns - countedOverruns);  // Reported with the samples that did arrive
+  countedOverruns = overruns;
+  int16_t samples[16];
+  uint16_t sampleCount;
+  while ((sampleCount = adcSamples.pop(samples, 16)) > 0)
+  {
+    for (uint16_t i = 0; i < sampleCount; i++)
+    {
+      telemetry.add(samples[i]);             // Summarised and sent a few times a second
+    }
+  }
+  uint16_t reportLength = telemetry.poll(millis(), Serial.availableForWrite());
+  if (reportLength)
+  {
+    Serial.write(telemetry.data(), reportLength);  // Fits in the UART buffer, so does not block
+  }
 
   // Display the value on the OLED display
   displayAllText();
 
   // Process serial input
-  if (stringComplete)
-  {
-    processSerialCommand();    // Process the serial command
-    stringComplete = false;    // Reset the flag
-    inputString = "";          // Clear the input string
-  }
+  processSerialInput();
 
   // Check button state
   checkButtonState();   
@@ -173,82 +185,127 @@ void loop()
 
 // Function Definitions
 // *************************************************************************
-Position getPositionFromString(const String &posStr) // Get the position from the string
+
+// setLineText
+// *************************************************************************
+void setLineText(char *text, TextView value)
 {
-  if (posStr == "top")  
-  {
-    return TOP;
-  }
-  else if (posStr == "middle")
-  {
-    return MIDDLE;
-  }
-  else if (posStr == "bottom")
-  {
-    return BOTTOM;
-  }
-  else
-  {
-    return UNKNOWN;
-  }
+  memcpy(text, value.ptr, value.len);
+  text[value.len] = '\0';
 }
 
 // processSerialCommand
 // *************************************************************************
-void processSerialCommand() 
+void processSerialCommand(TextView line) 
 {
-  inputString.trim();  // Remove leading and trailing whitespace
-  int8_t colonIndex = inputString.indexOf(':'); // Find the colon index
-  if (colonIndex == -1)                         // Check if colon is missing
+  SerialCommand command = parseSerialCommand(line);
+  switch (command.type)
   {
-    Serial.println("Error: Missing Text. Use format: Position:Text or Color:ColorName");
-    return;
+    case COMMAND_LINE:
+    {
+      char *text = command.position == TOP ? topText : command.position == MIDDLE ? middleText : bottomText;
+      setLineText(text, command.value);
+      Serial.println(text);
+      Serial.println(command.position == TOP ? "Top Line Updated" : command.position == MIDDLE ? "Middle Line Updated" : "Bottom Line Updated");
+      break;
+    }
+    case COMMAND_COLOR:
+      currentColor = command.color;
+      Serial.print("Color Updated to: ");
+      Serial.write(command.value.ptr, command.value.len);
+      Serial.println();
+      break;
+    case COMMAND_TELEMETRY:
+      telemetry.setMode(command.mode);
+      Serial.println("Telemetry Updated");
+      break;
+    case COMMAND_MISSING_TEXT:
+      Serial.println("Error: Missing Text. Use format: Position:Text or Color:ColorName");
+      break;
+    case COMMAND_BAD_COLOR:
+      Serial.println("Error: Unknown Color. Valid colors are: Red, Green, Blue, Yellow, Cyan, Purple, Orange");
+      break;
+    case COMMAND_BAD_MODE:
+      Serial.println("Error: Unknown Mode. Valid modes are: csv, binary, off");
+      break;
+    case COMMAND_UNKNOWN:
+      Serial.println("Error: Unknown Command. Valid commands are: top, middle, bottom, color, telemetry");
+      break;
   }
-  String command = inputString.substring(0, colonIndex);
-  String value = inputString.substring(colonIndex + 1);
-  
-  if (command == "top" || command == "middle" || command == "bottom")
+}
+
+// applyFrameFields
+// *************************************************************************
+bool applyFrameFields(const uint8_t *payload, uint8_t length, bool apply) // Check the fields, and change the settings only if apply is set
+{
+  FieldReader fields(payload, length);
+  uint8_t field, fieldLength;
+  const uint8_t *data;
+  while (fields.next(field, data, fieldLength))
   {
-    Position pos = getPositionFromString(command);
-    switch (pos)
+    TextView text = {(const char *) data, fieldLength};
+    switch (field)
     {
-      case TOP:
-        topText = value;
-        Serial.println(value);
-        Serial.println("Top Line Updated");
+      case FIELD_TOP:
+      case FIELD_MIDDLE:
+      case FIELD_BOTTOM:
+        if (fieldLength > SERIAL_LINE_SIZE) return false;
+        if (apply) setLineText(field == FIELD_TOP ? topText : field == FIELD_MIDDLE ? middleText : bottomText, text);
         break;
-      case MIDDLE:
-        middleText = value;
-        Serial.println(value);
-        Serial.println("Middle Line Updated");
+      case FIELD_COLOR:
+        if (fieldLength != 1 || data[0] > Orange) return false;
+        if (apply) currentColor = static_cast<Color>(data[0]);
         break;
-      case BOTTOM:
-        bottomText = value;
-        Serial.println(value);
-        Serial.println("Bottom Line Updated");
+      case FIELD_BRIGHTNESS:
+        if (fieldLength != 1) return false;
+        if (apply) brightness = data[0];
         break;
-      case UNKNOWN:
-        Serial.println("Error: Unknown Position. Valid positions are: top, middle, bottom");
+      case FIELD_MODE:
+        if (fieldLength != 1 || data[0] > BLINK) return false;
+        if (apply) ledStateMode = static_cast<LEDState>(data[0]);
         break;
+      default:
+        return false;
     }
   }
-  else if (command == "color")
-  {
-    if (value == "Red") currentColor = Red;
-    else if (value == "Green") currentColor = Green;
-    else if (value == "Blue") currentColor = Blue;
-    else if (value == "Yellow") currentColor = Yellow;
-    else if (value == "Cyan") currentColor = Cyan;
-    else if (value == "Purple") currentColor = Purple;
-    else if (value == "Orange") currentColor = Orange;
-    else Serial.println("Error: Unknown Color. Valid colors are: Red, Green, Blue, Yellow, Cyan, Purple, Orange");
-    Serial.print("Color Updated to: ");
-    Serial.println(value);
-  }
-  else
+  return !fields.error();
+}
+
+// processSerialFrame
+// *************************************************************************
+void processSerialFrame()
+{
+  uint8_t result = RESULT_OK;
+  switch (frameDecoder.type())
   {
-    Serial.println("Error: Unknown Command. Valid commands are: top, middle, bottom, color");
+    case FRAME_UPDATE:
+      if (applyFrameFields(frameDecoder.payload(), frameDecoder.length(), false))   // All or nothing
+      {
+        applyFrameFields(frameDecoder.payload(), frameDecoder.length(), true);
+      }
+      else
+      {
+        result = RESULT_BAD_FIELD;
+      }
+      break;
+    case FRAME_QUERY:
+      break;
+    default:
+      result = RESULT_BAD_TYPE;
+      break;
   }
+  sendFrameStatus(frameDecoder.seq(), result);
+}
+
+// sendFrameStatus
+// *************************************************************************
+void sendFrameStatus(uint8_t seq, uint8_t result)
+{
+  uint8_t status[4] = {result, (uint8_t) ledStateMode, (uint8_t) currentColor, brightness};
+  frameReply.begin(FRAME_STATUS, seq);
+  frameReply.addRaw(status, sizeof(status));
+  frameReply.finish();
+  Serial.write(frameReply.data(), frameReply.size());
 }
 
 // displayAllText
@@ -265,43 +322,103 @@ void displayAllText()
   display.display();
 }
 
-// serialEvent
+// serialReceive
+// *************************************************************************
+void serialReceive()
+{
+  uint8_t bytes[64];
+  int count;
+  while ((count = Serial.read(bytes, min(Serial.available(), (int) sizeof(bytes)))) > 0)
+  {
+    serialOverruns += count - serialBytes.push(bytes, count);  // Loop has fallen far behind
+  }
+}
+
+// adcTask
 // *************************************************************************
-void serialEvent()
+void adcTask(void *parameter)
 {
-  while (Serial.available())
+  TickType_t wakeTime = xTaskGetTickCount();
+  for (;;)
   {
-    char inChar = (char) Serial.read();
-    if (inChar != '\n' && inChar != '\r')
+    if (!adcSamples.push(ADS.getValue()))  // Loop has fallen behind
     {
-      inputString += inChar;
+      adcOverruns++;
     }
-    if (inChar == '\n')
+    vTaskDelayUntil(&wakeTime, pdMS_TO_TICKS(ADC_PERIOD_MS));
+  }
+}
+
+// processSerialInput
+// *************************************************************************
+void processSerialInput()
+{
+  static uint32_t reportedOverruns = 0;
+  if (serialOverruns != reportedOverruns)
+  {
+    reportedOverruns = serialOverruns;
+    Serial.println("Error: Serial input overrun");
+  }
+
+  uint8_t inByte;
+  while (serialBytes.pop(inByte))   // Handle every line that has arrived, not just one per loop
+  {
+    if (frameDecoder.busy(millis()) || (inByte == FRAME_SYNC && serialReader.empty()))  // Binary frame
+    {
+      switch (frameDecoder.feed(inByte, millis()))
+      {
+        case FRAME_READY:
+          processSerialFrame();
+          break;
+        case FRAME_ERROR:
+          sendFrameStatus(frameDecoder.seq(), RESULT_BAD_CRC);
+          break;
+        case FRAME_PENDING:
+          break;
+      }
+    }
+    else if (serialReader.feed((char) inByte))
     {
-      stringComplete = true;
+      if (serialReader.overflowed())
+      {
+        Serial.println("Error: Command too long");
+      }
+      else
+      {
+        processSerialCommand(serialReader.line());
+      }
     }
   }
 }
 
+// buttonISR
+// *************************************************************************
+void IRAM_ATTR buttonISR()
+{
+  buttonEvents.edge(micros(), digitalRead(BUTTON_PIN) == LOW);  // Active low
+}
+
 // checkButtonState
 // *************************************************************************
 void checkButtonState()
 {
-  static bool lastButtonState = HIGH;
-  bool buttonState = digitalRead(BUTTON_PIN);
-  if (buttonState != lastButtonState && millis() - buttonDebounceTime > DEBOUNCE_DELAY)
+  buttonEvents.update(micros(), digitalRead(BUTTON_PIN) == LOW);
+  ButtonEvent event;
+  while (buttonEvents.read(event))
   {
-    buttonDebounceTime = millis();
-    if (buttonState == LOW)
+    switch (event.type)
     {
-      ledStateMode = static_cast<LEDState>((ledStateMode + 1) % 3);
-      if (ledStateMode == ON) {
-        currentColor = static_cast<Color>((currentColor + 1) % 7); // Cycle through colors
-      }
-      Serial.print("LED State: ");
-      Serial.println(ledStateMode == OFF ? "OFF" : (ledStateMode == ON ? "ON" : "BLINK"));
+      case BUTTON_PRESS:
+        ledStateMode = static_cast<LEDState>((ledStateMode + 1) % 3);
+        if (ledStateMode == ON) {
+          currentColor = static_cast<Color>((currentColor + 1) % 7); // Cycle through colors
+        }
+        break;
+      default:
+        continue;
     }
-    lastButtonState = buttonState;
+    Serial.print("LED State: ");
+    Serial.println(ledStateMode == OFF ? "OFF" : (ledStateMode == ON ? "ON" : "BLINK"));
   }
 }
 
@@ -326,23 +443,10 @@ CRGB getColorFromEnum(Color color)
 // *************************************************************************
 void updateLEDState()
 {
-  static unsigned long previousMillis = 0;
-  unsigned long currentMillis = millis();
-
-  switch (ledStateMode)
+  if (!ledMachine.update(millis(), ledStateMode, currentColor, brightness))
   {
-    case OFF:
-      leds[0] = CRGB::Black;
-      break;
-    case ON:
-      leds[0] = getColorFromEnum(currentColor);
-      break;
-    case BLINK:
-      if (currentMillis - previousMillis >= BLINK_INTERVAL) {
-        previousMillis = currentMillis;
-        leds[0] = leds[0] == CRGB::Black ? getColorFromEnum(currentColor) : CRGB::Black;
-      }
-      break;
+    return;   // Nothing to show until a setting changes or ledMachine.nextWake()
   }
+  leds[0] = ledMachine.lit() ? getColorFromEnum(currentColor) : CRGB::Black;
   FastLED.show();
 }
\ No newline at end of file
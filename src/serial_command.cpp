@@ -0,0 +1,165 @@
+// ****************************************************************************
+// Title		: Serial Command
+// File Name	: 'serial_command.cpp'
+// Target MCU	: Espressif ESP32 (Doit DevKit Version 1)
+// ****************************************************************************
+
+// Include Files
+// ****************************************************************************
+#include <string.h>
+#include "serial_command.h"
+
+// Text View
+// ****************************************************************************
+bool TextView::equals(const char *text) const
+{
+	return strlen(text) == len && memcmp(ptr, text, len) == 0;
+}
+
+TextView TextView::trim(void) const
+{
+	TextView result = *this;
+	while (result.len > 0 && (uint8_t) result.ptr[0] <= ' ')
+	{
+		result.ptr++;
+		result.len--;
+	}
+	while (result.len > 0 && (uint8_t) result.ptr[result.len - 1] <= ' ')
+	{
+		result.len--;
+	}
+	return result;
+}
+
+bool TextView::split(char separator, TextView &head, TextView &tail) const
+{
+	const char *found = (const char *) memchr(ptr, separator, len);
+	if (found == NULL)
+	{
+		return false;
+	}
+	head.ptr = ptr;
+	head.len = found - ptr;
+	tail.ptr = found + 1;
+	tail.len = len - head.len - 1;
+	return true;
+}
+
+// Line Reader
+// ****************************************************************************
+bool SerialLineReader::feed(char inChar)
+{
+	if (_complete) // Start a new line
+	{
+		_length = 0;
+		_overflow = false;
+		_complete = false;
+	}
+
+	if (inChar == '\n')
+	{
+		_complete = true;
+	}
+	else if (inChar != '\r')
+	{
+		if (_length < SERIAL_LINE_SIZE)
+		{
+			_buffer[_length++] = inChar;
+		}
+		else
+		{
+			_overflow = true; // Drop the rest of the line
+		}
+	}
+	return _complete;
+}
+
+TextView SerialLineReader::line(void) const
+{
+	TextView result = {_buffer, _length};
+	return result;
+}
+
+bool SerialLineReader::empty(void) const
+{
+	return _complete || _length == 0;
+}
+
+bool SerialLineReader::overflowed(void) const
+{
+	return _overflow;
+}
+
+// Commands
+// ****************************************************************************
+Position getPositionFromText(TextView posText)
+{
+	switch (hashName(posText))
+	{
+		case NAME_HASH("top"):
+			if (posText.equals("top")) return TOP;
+			break;
+		case NAME_HASH("middle"):
+			if (posText.equals("middle")) return MIDDLE;
+			break;
+		case NAME_HASH("bottom"):
+			if (posText.equals("bottom")) return BOTTOM;
+			break;
+	}
+	return UNKNOWN;
+}
+
+bool getColorFromText(TextView colorText, Color &color)
+{
+	Color found;
+	const char *name;
+	switch (hashName(colorText))
+	{
+		case NAME_HASH("Red"):		found = Red;	name = "Red";		break;
+		case NAME_HASH("Green"):	found = Green;	name = "Green";		break;
+		case NAME_HASH("Blue"):		found = Blue;	name = "Blue";		break;
+		case NAME_HASH("Yellow"):	found = Yellow;	name = "Yellow";	break;
+		case NAME_HASH("Cyan"):		found = Cyan;	name = "Cyan";		break;
+		case NAME_HASH("Purple"):	found = Purple;	name = "Purple";	break;
+		case NAME_HASH("Orange"):	found = Orange;	name = "Orange";	break;
+		default: return false;
+	}
+	if (!colorText.equals(name))	// Some other text with the same hash
+	{
+		return false;
+	}
+	color = found;
+	return true;
+}
+
+SerialCommand parseSerialCommand(TextView line)
+{
+	SerialCommand result = {};
+	TextView command;
+	line = line.trim();
+	if (!line.split(':', command, result.value))
+	{
+		result.type = COMMAND_MISSING_TEXT;
+		return result;
+	}
+
+	switch (hashName(command))
+	{
+		case NAME_HASH("telemetry"):
+			if (!command.equals("telemetry")) break;
+			result.type = COMMAND_TELEMETRY;
+			if (result.value.equals("csv")) result.mode = TELEMETRY_CSV;
+			else if (result.value.equals("binary")) result.mode = TELEMETRY_BINARY;
+			else if (result.value.equals("off")) result.mode = TELEMETRY_OFF;
+			else result.type = COMMAND_BAD_MODE;
+			return result;
+		case NAME_HASH("color"):
+			if (!command.equals("color")) break;
+			result.type = getColorFromText(result.value, result.color) ? COMMAND_COLOR : COMMAND_BAD_COLOR;
+			return result;
+	}
+
+	result.position = getPositionFromText(command);
+	result.type = result.position == UNKNOWN ? COMMAND_UNKNOWN : COMMAND_LINE;
+	return result;
+}
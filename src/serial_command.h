@@ -0,0 +1,112 @@
+// ****************************************************************************
+// Title		: Serial Command
+// File Name	: 'serial_command.h'
+// Target MCU	: Espressif ESP32 (Doit DevKit Version 1)
+//
+// Reads serial commands a line at a time into a fixed buffer and splits
+// them into (pointer, length) views, so that handling a command never
+// touches the heap. Names are matched with a hash that is computed at
+// compile time for the known names, so a command can be dispatched with a
+// switch statement. parseSerialCommand() turns a line into what it asks
+// for, and leaves doing it and replying to the caller.
+// ****************************************************************************
+
+#ifndef serial_command_H
+#define serial_command_H
+#pragma once
+
+// Include Files
+// ****************************************************************************
+#include <stdint.h>
+#include <stddef.h>
+#include "led_state.h"
+#include "telemetry.h"
+
+// Constants
+// ****************************************************************************
+const uint8_t SERIAL_LINE_SIZE = 128;	// Longest command line, in characters
+
+// Text View
+// ****************************************************************************
+// A piece of text that lives in someone else's buffer
+struct TextView
+{
+	const char *ptr;
+	uint8_t len;
+
+	bool equals(const char *text) const;	// Same text as a C string?
+	TextView trim(void) const;				// Without leading and trailing whitespace
+	bool split(char separator, TextView &head, TextView &tail) const;	// At the first separator
+};
+
+// Name Hash
+// ****************************************************************************
+// FNV-1a, usable in constant expressions so that names can be case labels.
+// Two names with the same hash in one switch are a compile error, so a
+// switch over NAME_HASH labels is a perfect hash of its names; the text
+// still has to be compared to reject other input with the same hash.
+constexpr uint32_t hashName(const char *text, size_t length, uint32_t hash = 2166136261UL)
+{
+	return length == 0 ? hash : hashName(text + 1, length - 1, (hash ^ (uint8_t) *text) * 16777619UL);
+}
+
+inline uint32_t hashName(const TextView &text)
+{
+	return hashName(text.ptr, text.len);
+}
+
+#define NAME_HASH(name) hashName(name, sizeof(name) - 1)
+
+// Line Reader
+// ****************************************************************************
+class SerialLineReader
+{
+public:
+	// Add one received character. Returns true when it completes a line,
+	// which is then available from line() until the next character.
+	bool feed(char inChar);
+
+	TextView line(void) const;
+	bool empty(void) const;			// Nothing of the next line has arrived yet
+	bool overflowed(void) const;		// The line was too long and has been cut short
+
+private:
+	char _buffer[SERIAL_LINE_SIZE];
+	uint8_t _length = 0;
+	bool _overflow = false;
+	bool _complete = false;
+};
+
+// Commands
+// ****************************************************************************
+enum Position { TOP, MIDDLE, BOTTOM, UNKNOWN };	// Text position on the OLED display
+
+enum CommandType
+{
+	COMMAND_LINE,			// Set the text of a line
+	COMMAND_COLOR,			// Set the LED colour
+	COMMAND_TELEMETRY,		// Set the telemetry mode
+	COMMAND_MISSING_TEXT,	// No colon between the name and the value
+	COMMAND_UNKNOWN,		// Not a command name
+	COMMAND_BAD_COLOR,		// color: with an unknown colour
+	COMMAND_BAD_MODE		// telemetry: with an unknown mode
+};
+
+// What a line asks for. value is the text after the colon, and points
+// into the line.
+struct SerialCommand
+{
+	CommandType type;
+	TextView value;
+	Position position;		// For COMMAND_LINE
+	Color color;			// For COMMAND_COLOR
+	TelemetryMode mode;		// For COMMAND_TELEMETRY
+};
+
+// Parse "name:value", with whitespace around it ignored
+SerialCommand parseSerialCommand(TextView line);
+
+Position getPositionFromText(TextView posText);			// UNKNOWN if not a position
+bool getColorFromText(TextView colorText, Color &color);	// false if not a colour
+
+#endif // serial_command_H
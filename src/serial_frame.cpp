@@ -0,0 +1,182 @@
+// ****************************************************************************
+// Title		: Serial Frame
+// File Name	: 'serial_frame.cpp'
+// Target MCU	: Espressif ESP32 (Doit DevKit Version 1)
+// ****************************************************************************
+
+// Include Files
+// ****************************************************************************
+#include <string.h>
+#include "serial_frame.h"
+
+// CRC
+// ****************************************************************************
+uint16_t frameCrc(const uint8_t *data, size_t length, uint16_t crc)
+{
+	while (length--)
+	{
+		crc ^= (uint16_t) *data++ << 8;
+		for (uint8_t bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+		}
+	}
+	return crc;
+}
+
+// Decoder
+// ****************************************************************************
+FrameState FrameDecoder::feed(uint8_t inByte, uint32_t now)
+{
+	if (!busy(now))
+	{
+		if (inByte == FRAME_SYNC)
+		{
+			_busy = true;
+			_received = 0;
+		}
+		_lastByte = now;
+		return FRAME_PENDING;
+	}
+	_lastByte = now;
+
+	_frame[_received++] = inByte;
+	uint16_t crcAt = FRAME_HEADER_SIZE - 1 + _frame[0];
+	if (_received < crcAt + 2)
+	{
+		return FRAME_PENDING;
+	}
+
+	_busy = false;
+	uint16_t crc = ((uint16_t) _frame[crcAt] << 8) | _frame[crcAt + 1];
+	return frameCrc(_frame, crcAt) == crc ? FRAME_READY : FRAME_ERROR;
+}
+
+bool FrameDecoder::busy(uint32_t now)
+{
+	if (_busy && now - _lastByte > FRAME_TIMEOUT_MS) // Sender gave up part way
+	{
+		reset();
+	}
+	return _busy;
+}
+
+void FrameDecoder::reset(void)
+{
+	_busy = false;
+	_received = 0;
+}
+
+uint8_t FrameDecoder::type(void) const
+{
+	return _frame[1];
+}
+
+uint8_t FrameDecoder::seq(void) const
+{
+	return _frame[2];
+}
+
+const uint8_t *FrameDecoder::payload(void) const
+{
+	return _frame + FRAME_HEADER_SIZE - 1;
+}
+
+uint8_t FrameDecoder::length(void) const
+{
+	return _frame[0];
+}
+
+// Field Reader
+// ****************************************************************************
+FieldReader::FieldReader(const uint8_t *payload, uint8_t length)
+{
+	_next = payload;
+	_end = payload + length;
+}
+
+bool FieldReader::next(uint8_t &field, const uint8_t *&data, uint8_t &length)
+{
+	if (_error || _next == _end)
+	{
+		return false;
+	}
+	if (_end - _next < 2 || _end - _next - 2 < _next[1]) // Field runs past the payload
+	{
+		_error = true;
+		return false;
+	}
+	field = _next[0];
+	length = _next[1];
+	data = _next + 2;
+	_next += 2 + length;
+	return true;
+}
+
+bool FieldReader::error(void) const
+{
+	return _error;
+}
+
+// Writer
+// ****************************************************************************
+void FrameWriter::begin(uint8_t type, uint8_t seq)
+{
+	_frame[0] = FRAME_SYNC;
+	_frame[1] = 0;
+	_frame[2] = type;
+	_frame[3] = seq;
+	_size = FRAME_HEADER_SIZE;
+}
+
+bool FrameWriter::addField(uint8_t field, const void *data, uint8_t length)
+{
+	if (_frame[1] + 2 + length > 255)
+	{
+		return false;
+	}
+	uint8_t header[2] = {field, length};
+	addRaw(header, 2);
+	addRaw(data, length);
+	return true;
+}
+
+bool FrameWriter::addByte(uint8_t field, uint8_t value)
+{
+	return addField(field, &value, 1);
+}
+
+bool FrameWriter::addText(uint8_t field, const char *text)
+{
+	size_t length = strlen(text);
+	return length <= 255 && addField(field, text, (uint8_t) length);
+}
+
+bool FrameWriter::addRaw(const void *data, uint8_t length)
+{
+	if (_frame[1] + length > 255)
+	{
+		return false;
+	}
+	memcpy(_frame + _size, data, length);
+	_frame[1] += length;
+	_size += length;
+	return true;
+}
+
+void FrameWriter::finish(void)
+{
+	uint16_t crc = frameCrc(_frame + 1, _size - 1);
+	_frame[_size++] = crc >> 8;
+	_frame[_size++] = crc & 0xFF;
+}
+
+const uint8_t *FrameWriter::data(void) const
+{
+	return _frame;
+}
+
+uint16_t FrameWriter::size(void) const
+{
+	return _size;
+}
@@ -0,0 +1,151 @@
+// ****************************************************************************
+// Title		: Serial Frame
+// File Name	: 'serial_frame.h'
+// Target MCU	: Espressif ESP32 (Doit DevKit Version 1)
+//
+// Binary framing for the serial link, used alongside the text commands.
+// A frame is
+//
+//   SYNC  LENGTH  TYPE  SEQ  PAYLOAD[LENGTH]  CRC_HI  CRC_LO
+//
+// where SYNC is FRAME_SYNC, SEQ is echoed in the reply, and the CRC is
+// CRC-16/CCITT (0x1021, start 0xFFFF) over LENGTH through PAYLOAD. The
+// payload of an update frame is a list of fields, each
+//
+//   FIELD  LENGTH  DATA[LENGTH]
+//
+// so that several values can be changed with one frame. FRAME_SYNC is not
+// a printable character, so a frame can be told apart from a text command
+// by its first byte.
+//
+// Nothing here depends on Arduino, so the same code builds on a host to
+// encode commands and decode replies.
+// ****************************************************************************
+
+#ifndef serial_frame_H
+#define serial_frame_H
+#pragma once
+
+// Include Files
+// ****************************************************************************
+#include <stdint.h>
+#include <stddef.h>
+
+// Constants
+// ****************************************************************************
+const uint8_t FRAME_SYNC = 0xA5;			// First byte of every frame
+const uint8_t FRAME_HEADER_SIZE = 4;		// SYNC, LENGTH, TYPE, SEQ
+const uint16_t FRAME_MAX_SIZE = FRAME_HEADER_SIZE + 255 + 2;
+const uint16_t FRAME_TIMEOUT_MS = 250;		// Longest gap between bytes of one frame
+
+enum FrameType
+{
+	FRAME_UPDATE = 0x01,	// Fields to change; replied to with FRAME_STATUS
+	FRAME_QUERY = 0x02,		// No payload; replied to with FRAME_STATUS
+	FRAME_STATUS = 0x81,	// RESULT, MODE, COLOR, BRIGHTNESS
+	FRAME_TELEMETRY = 0x82	// Sent unasked; see telemetry.h
+};
+
+enum FrameField
+{
+	FIELD_TOP = 0x01,		// Text for the top line
+	FIELD_MIDDLE = 0x02,	// Text for the middle line
+	FIELD_BOTTOM = 0x03,	// Text for the bottom line
+	FIELD_COLOR = 0x10,		// One byte, Color
+	FIELD_BRIGHTNESS = 0x11,	// One byte
+	FIELD_MODE = 0x12		// One byte, LEDState
+};
+
+enum FrameResult
+{
+	RESULT_OK = 0,
+	RESULT_BAD_CRC = 1,		// Frame was damaged; nothing was changed
+	RESULT_BAD_TYPE = 2,	// Unknown frame type
+	RESULT_BAD_FIELD = 3	// Unknown or malformed field; nothing was changed
+};
+
+enum FrameState
+{
+	FRAME_PENDING,	// Need more bytes
+	FRAME_READY,	// A whole frame has arrived, see type(), seq() and payload()
+	FRAME_ERROR		// The frame failed its CRC and has been dropped
+};
+
+// CRC-16/CCITT of a block, continuing from crc
+uint16_t frameCrc(const uint8_t *data, size_t length, uint16_t crc = 0xFFFF);
+
+// Decoder
+// ****************************************************************************
+// Assembles a frame one byte at a time, as the bytes come out of the UART.
+// A frame is read in place: payload() points into the decoder until the
+// next byte is fed.
+class FrameDecoder
+{
+public:
+	// Add one received byte, with the time in ms it arrived. Bytes before a
+	// FRAME_SYNC are ignored, and a frame that stalls for FRAME_TIMEOUT_MS is
+	// dropped.
+	FrameState feed(uint8_t inByte, uint32_t now);
+
+	// Part of a frame has arrived, and it has not timed out
+	bool busy(uint32_t now);
+	void reset(void);
+
+	uint8_t type(void) const;
+	uint8_t seq(void) const;
+	const uint8_t *payload(void) const;
+	uint8_t length(void) const;
+
+private:
+	uint8_t _frame[FRAME_MAX_SIZE];	// LENGTH onwards; SYNC is not kept
+	uint16_t _received = 0;
+	uint32_t _lastByte = 0;
+	bool _busy = false;
+};
+
+// Field Reader
+// ****************************************************************************
+// Walks the fields of an update payload
+class FieldReader
+{
+public:
+	FieldReader(const uint8_t *payload, uint8_t length);
+
+	// Get the next field. Returns false at the end of the payload, or if the
+	// payload is malformed, which is then reported by error().
+	bool next(uint8_t &field, const uint8_t *&data, uint8_t &length);
+	bool error(void) const;
+
+private:
+	const uint8_t *_next;
+	const uint8_t *_end;
+	bool _error = false;
+};
+
+// Writer
+// ****************************************************************************
+// Builds one frame in its own buffer
+class FrameWriter
+{
+public:
+	void begin(uint8_t type, uint8_t seq);
+
+	// Add a field or raw payload bytes. Returns false, and adds nothing, if
+	// the payload would be too long.
+	bool addField(uint8_t field, const void *data, uint8_t length);
+	bool addByte(uint8_t field, uint8_t value);
+	bool addText(uint8_t field, const char *text);
+	bool addRaw(const void *data, uint8_t length);
+
+	// Append the CRC. The frame is then data()[0 .. size()-1].
+	void finish(void);
+
+	const uint8_t *data(void) const;
+	uint16_t size(void) const;
+
+private:
+	uint8_t _frame[FRAME_MAX_SIZE];
+	uint16_t _size = 0;
+};
+
+#endif // serial_frame_H
@@ -0,0 +1,125 @@
+// ****************************************************************************
+// Title		: SPSC Queue
+// File Name	: 'spsc_queue.h'
+// Target MCU	: Espressif ESP32 (Doit DevKit Version 1)
+//
+// Lock-free ring buffer for passing data from exactly one producer (an
+// interrupt, a task, or the other core) to exactly one consumer. Each
+// index is only written by one side: the producer publishes items by
+// storing _head with release ordering after writing them, and the consumer
+// frees slots by storing _tail with release ordering after reading them.
+// Each side keeps a cached copy of the other's index and only reloads it
+// when the queue looks full (or empty), so most calls touch no shared
+// cache line.
+//
+// SIZE must be a power of two. Indices run freely and are masked on use,
+// so all SIZE slots can be filled. Queues should be globals or statics;
+// the cache-line alignment is not honoured for objects created with new.
+// ****************************************************************************
+
+#ifndef spsc_queue_H
+#define spsc_queue_H
+#pragma once
+
+// Include Files
+// ****************************************************************************
+#include <stdint.h>
+#include <atomic>
+
+// Constants
+// ****************************************************************************
+#ifndef SPSC_CACHE_LINE
+#define SPSC_CACHE_LINE 64	// Keeps the producer's and consumer's data apart
+#endif
+
+// Class
+// ****************************************************************************
+template <typename T, uint16_t SIZE>
+class SpscQueue
+{
+	static_assert(SIZE >= 2 && (SIZE & (SIZE - 1)) == 0, "SpscQueue SIZE must be a power of two");
+
+public:
+	// Producer side
+	bool push(const T &item)
+	{
+		return push(&item, 1) == 1;
+	}
+
+	// Add up to count items. Returns how many were added; the rest did not fit.
+	uint16_t push(const T *items, uint16_t count)
+	{
+		uint32_t head = _head.load(std::memory_order_relaxed);
+		uint32_t space = SIZE - (head - _tailCache);
+		if (space < count)
+		{
+			_tailCache = _tail.load(std::memory_order_acquire);
+			space = SIZE - (head - _tailCache);
+		}
+		if (count > space)
+		{
+			count = space;
+		}
+		for (uint16_t i = 0; i < count; i++)
+		{
+			_items[(head + i) & (SIZE - 1)] = items[i];
+		}
+		_head.store(head + count, std::memory_order_release);
+		return count;
+	}
+
+	// Consumer side
+	bool pop(T &item)
+	{
+		return pop(&item, 1) == 1;
+	}
+
+	// Take up to count items. Returns how many were taken.
+	uint16_t pop(T *items, uint16_t count)
+	{
+		uint32_t tail = _tail.load(std::memory_order_relaxed);
+		uint32_t ready = _headCache - tail;
+		if (ready < count)
+		{
+			_headCache = _head.load(std::memory_order_acquire);
+			ready = _headCache - tail;
+		}
+		if (count > ready)
+		{
+			count = ready;
+		}
+		for (uint16_t i = 0; i < count; i++)
+		{
+			items[i] = _items[(tail + i) & (SIZE - 1)];
+		}
+		_tail.store(tail + count, std::memory_order_release);
+		return count;
+	}
+
+	// Either side; only a snapshot while the other side is running
+	uint16_t size(void) const
+	{
+		return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+	}
+
+	bool empty(void) const
+	{
+		return size() == 0;
+	}
+
+	static uint16_t capacity(void)
+	{
+		return SIZE;
+	}
+
+private:
+	alignas(SPSC_CACHE_LINE) std::atomic<uint32_t> _head{0};	// Written by the producer
+	uint32_t _tailCache = 0;									// Producer's copy of _tail
+
+	alignas(SPSC_CACHE_LINE) std::atomic<uint32_t> _tail{0};	// Written by the consumer
+	uint32_t _headCache = 0;									// Consumer's copy of _head
+
+	alignas(SPSC_CACHE_LINE) T _items[SIZE];
+};
+
+#endif // spsc_queue_H
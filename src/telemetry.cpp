@@ -0,0 +1,203 @@
+// ****************************************************************************
+// Title		: Telemetry
+// File Name	: 'telemetry.cpp'
+// Target MCU	: Espressif ESP32 (Doit DevKit Version 1)
+// ****************************************************************************
+
+// Include Files
+// ****************************************************************************
+#include "telemetry.h"
+
+// Formatting
+// ****************************************************************************
+static char *formatUnsigned(char *out, uint32_t value)
+{
+	char digits[10];
+	uint8_t count = 0;
+	do
+	{
+		digits[count++] = '0' + value % 10;
+		value /= 10;
+	} while (value);
+	while (count)
+	{
+		*out++ = digits[--count];
+	}
+	return out;
+}
+
+static char *formatSigned(char *out, int32_t value)
+{
+	if (value < 0)
+	{
+		*out++ = '-';
+		return formatUnsigned(out, 0 - (uint32_t) value);
+	}
+	return formatUnsigned(out, value);
+}
+
+static char *formatVolts(char *out, int32_t microvolts) // Volts to 3 decimal places
+{
+	uint32_t magnitude = microvolts < 0 ? 0 - (uint32_t) microvolts : microvolts;
+	uint32_t millivolts = (magnitude + 500) / 1000;
+	if (microvolts < 0 && millivolts)
+	{
+		*out++ = '-';
+	}
+	out = formatUnsigned(out, millivolts / 1000);
+	*out++ = '.';
+	uint16_t fraction = millivolts % 1000;
+	*out++ = '0' + fraction / 100;
+	*out++ = '0' + fraction / 10 % 10;
+	*out++ = '0' + fraction % 10;
+	return out;
+}
+
+static uint8_t *putLittleEndian(uint8_t *out, uint32_t value, uint8_t bytes)
+{
+	while (bytes--)
+	{
+		*out++ = value & 0xFF;
+		value >>= 8;
+	}
+	return out;
+}
+
+// Class
+// ****************************************************************************
+void Telemetry::setMode(TelemetryMode mode)
+{
+	_mode = mode;
+}
+
+void Telemetry::setInterval(uint16_t interval)
+{
+	_interval = interval;
+}
+
+void Telemetry::setScale(int32_t microvoltsPerBit)
+{
+	_microvoltsPerBit = microvoltsPerBit;
+}
+
+void Telemetry::add(int16_t sample)
+{
+	if (_count == UINT16_MAX) // Window is full; keeps _sum within 32 bits
+	{
+		_dropped++;
+		return;
+	}
+	if (_count == 0 || sample < _min)
+	{
+		_min = sample;
+	}
+	if (_count == 0 || sample > _max)
+	{
+		_max = sample;
+	}
+	_sum += sample;
+	_count++;
+}
+
+void Telemetry::addDropped(uint32_t count)
+{
+	_dropped += count;
+}
+
+uint16_t Telemetry::poll(uint32_t now, uint16_t room)
+{
+	if (now - _lastReport < _interval)
+	{
+		return 0;
+	}
+	_lastReport = now;
+	if (_count == 0 || _mode == TELEMETRY_OFF)
+	{
+		_count = 0;
+		_sum = 0;
+		return 0;
+	}
+
+	int16_t mean = _sum / _count;
+	uint16_t length = 0;
+	switch (_mode)
+	{
+		case TELEMETRY_CSV:
+			length = formatCsv(now, mean, (int32_t) mean * _microvoltsPerBit);
+			break;
+		case TELEMETRY_BINARY:
+			length = formatBinary(now, mean, (int32_t) mean * _microvoltsPerBit);
+			break;
+		case TELEMETRY_OFF:
+			break;
+	}
+	if (length > room) // Would have to wait for the UART
+	{
+		_dropped += _count;
+		length = 0;
+	}
+
+	_count = 0;
+	_sum = 0;
+	return length;
+}
+
+const uint8_t *Telemetry::data(void) const
+{
+	return _report;
+}
+
+uint32_t Telemetry::dropped(void) const
+{
+	return _dropped;
+}
+
+// The longest report: "Analog0," (8), ms (10), samples (5), three of -32768
+// (6 each), volts down to -2147.484 (9), dropped (10), six commas and '\n'
+const uint8_t TELEMETRY_CSV_LONGEST = 8 + 10 + 5 + 3 * 6 + 9 + 10 + 6 + 1;
+static_assert(TELEMETRY_CSV_SIZE >= TELEMETRY_CSV_LONGEST, "TELEMETRY_CSV_SIZE is too small for a CSV report");
+
+uint16_t Telemetry::formatCsv(uint32_t now, int16_t mean, int32_t microvolts)
+{
+	// At most TELEMETRY_CSV_LONGEST characters, so no bounds checks are needed
+	char *out = _csv;
+	const char name[] = "Analog0,";
+	for (const char *c = name; *c; c++)
+	{
+		*out++ = *c;
+	}
+	out = formatUnsigned(out, now);
+	*out++ = ',';
+	out = formatUnsigned(out, _count);
+	*out++ = ',';
+	out = formatSigned(out, _min);
+	*out++ = ',';
+	out = formatSigned(out, mean);
+	*out++ = ',';
+	out = formatSigned(out, _max);
+	*out++ = ',';
+	out = formatVolts(out, microvolts);
+	*out++ = ',';
+	out = formatUnsigned(out, _dropped);
+	*out++ = '\n';
+	_report = (const uint8_t *) _csv;
+	return out - _csv;
+}
+
+uint16_t Telemetry::formatBinary(uint32_t now, int16_t mean, int32_t microvolts)
+{
+	uint8_t payload[20];
+	uint8_t *out = payload;
+	out = putLittleEndian(out, now, 4);
+	out = putLittleEndian(out, _count, 2);
+	out = putLittleEndian(out, (uint16_t) _min, 2);
+	out = putLittleEndian(out, (uint16_t) mean, 2);
+	out = putLittleEndian(out, (uint16_t) _max, 2);
+	out = putLittleEndian(out, (uint32_t) microvolts, 4);
+	out = putLittleEndian(out, _dropped, 4);
+	_frame.begin(FRAME_TELEMETRY, _seq++);
+	_frame.addRaw(payload, sizeof(payload));
+	_frame.finish();
+	_report = _frame.data();
+	return _frame.size();
+}
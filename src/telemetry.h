@@ -0,0 +1,85 @@
+// ****************************************************************************
+// Title		: Telemetry
+// File Name	: 'telemetry.h'
+// Target MCU	: Espressif ESP32 (Doit DevKit Version 1)
+//
+// Collects ADC samples and reports the minimum, mean and maximum of each
+// window at a fixed rate, rather than printing every sample. Reports are
+// formatted with integer arithmetic into a buffer that is reused, and are
+// only sent when the UART has room for the whole report, so sending never
+// blocks the loop. A window that cannot be sent is counted as dropped,
+// and so are samples lost on the way in, passed to addDropped().
+//
+// A CSV report is one line:
+//
+//   Analog0,<ms>,<samples>,<min>,<mean>,<max>,<volts>,<dropped>
+//
+// A binary report is a FRAME_TELEMETRY frame (see serial_frame.h) with the
+// same values, little-endian:
+//
+//   ms(4) samples(2) min(2) mean(2) max(2) microvolts(4) dropped(4)
+// ****************************************************************************
+
+#ifndef telemetry_H
+#define telemetry_H
+#pragma once
+
+// Include Files
+// ****************************************************************************
+#include <stdint.h>
+#include "serial_frame.h"
+
+// Constants
+// ****************************************************************************
+const uint16_t TELEMETRY_INTERVAL = 250;	// Default time between reports, in ms
+const uint8_t TELEMETRY_CSV_SIZE = 80;		// Longest CSV report
+
+enum TelemetryMode
+{
+	TELEMETRY_OFF,
+	TELEMETRY_CSV,
+	TELEMETRY_BINARY
+};
+
+// Class
+// ****************************************************************************
+class Telemetry
+{
+public:
+	void setMode(TelemetryMode mode);
+	void setInterval(uint16_t interval);		// Time between reports, in ms
+	void setScale(int32_t microvoltsPerBit);	// For the voltage in the report
+
+	void add(int16_t sample);
+	void addDropped(uint32_t count);	// Samples lost before they got to add()
+
+	// Make a report if one is due at now, in ms. room is how many bytes can
+	// be sent without waiting. Returns the length of the report in data(),
+	// or 0 if there is nothing to send.
+	uint16_t poll(uint32_t now, uint16_t room);
+	const uint8_t *data(void) const;
+
+	uint32_t dropped(void) const;	// Samples that were never reported
+
+private:
+	TelemetryMode _mode = TELEMETRY_CSV;
+	uint16_t _interval = TELEMETRY_INTERVAL;
+	int32_t _microvoltsPerBit = 0;
+	uint32_t _lastReport = 0;
+	uint32_t _dropped = 0;
+	uint8_t _seq = 0;
+
+	uint16_t _count = 0;
+	int16_t _min = 0;
+	int16_t _max = 0;
+	int32_t _sum = 0;
+
+	char _csv[TELEMETRY_CSV_SIZE];
+	FrameWriter _frame;
+	const uint8_t *_report = 0;	// The last report, in _csv or _frame
+
+	uint16_t formatCsv(uint32_t now, int16_t mean, int32_t microvolts);
+	uint16_t formatBinary(uint32_t now, int16_t mean, int32_t microvolts);
+};
+
+#endif // telemetry_H
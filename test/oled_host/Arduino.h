@@ -0,0 +1,148 @@
+// ****************************************************************************
+// Title		: Arduino Core Stand-in
+// File Name	: 'Arduino.h'
+// Target MCU	: Host (pio test -e native)
+//
+// Just enough of the Arduino core to build the OLED library on the host:
+// String, Print, a clock that only moves when told to, and pins whose
+// writes are logged with the SPI bytes, and the thread that made them, so
+// that the order of the two can be checked. Include it first; it defines ARDUINO, which the library
+// headers check before including it themselves.
+// ****************************************************************************
+
+#ifndef Arduino_H
+#define Arduino_H
+#pragma once
+
+#ifndef ARDUINO
+#define ARDUINO 10819
+#endif
+#define NO_GLOBAL_SERIAL	// The library only prints deprecation notices
+
+// Include Files
+// ****************************************************************************
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Constants
+// ****************************************************************************
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *) (addr))
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+
+using std::min;
+using std::max;
+
+const uint8_t HOST_SPI_BYTE = 0xFF;		// Pin number of logged SPI bytes
+
+// Log of pin writes and SPI bytes, in the order they happened
+// ****************************************************************************
+struct HostEvent
+{
+	uint8_t pin;		// HOST_SPI_BYTE for a byte sent over SPI
+	uint8_t value;		// Level written, or the byte
+	std::thread::id thread;
+};
+
+inline std::vector<HostEvent> &hostEvents()
+{
+	static std::vector<HostEvent> events;
+	return events;
+}
+
+inline void hostLogEvent(uint8_t pin, uint8_t value)
+{
+	static std::mutex lock;
+	std::lock_guard<std::mutex> guard(lock);
+	hostEvents().push_back(HostEvent{pin, value, std::this_thread::get_id()});
+}
+
+inline void pinMode(uint8_t pin, uint8_t mode)
+{
+	(void) pin;
+	(void) mode;
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t level)
+{
+	hostLogEvent(pin, level);
+}
+
+// Clock, only moved by delay() and the tests
+// ****************************************************************************
+inline unsigned long &hostMillis()
+{
+	static unsigned long now;
+	return now;
+}
+
+inline unsigned long millis()
+{
+	return hostMillis();
+}
+
+inline void delay(unsigned long ms)
+{
+	hostMillis() += ms;
+}
+
+inline void yield()
+{
+}
+
+// String and Print
+// ****************************************************************************
+class String
+{
+public:
+	String(const char *s = "") : _str(s) {}
+	const char *c_str() const { return _str.c_str(); }
+	unsigned int length() const { return _str.length(); }
+	void toCharArray(char *buf, unsigned int bufsize, unsigned int index = 0) const
+	{
+		if (bufsize == 0)
+		{
+			return;
+		}
+		size_t n = index < _str.length() ? _str.copy(buf, bufsize - 1, index) : 0;
+		buf[n] = 0;
+	}
+
+private:
+	std::string _str;
+};
+
+class Print
+{
+public:
+	virtual ~Print() {}
+	virtual size_t write(uint8_t c) = 0;
+	virtual size_t write(const uint8_t *data, size_t length)
+	{
+		size_t n = 0;
+		while (length--)
+		{
+			n += write(*data++);
+		}
+		return n;
+	}
+	size_t print(const char *s)
+	{
+		return write((const uint8_t *) s, strlen(s));
+	}
+};
+
+#endif
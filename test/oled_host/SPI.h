@@ -0,0 +1,51 @@
+// ****************************************************************************
+// Title		: SPI Stand-in
+// File Name	: 'SPI.h'
+// Target MCU	: Host (pio test -e native)
+//
+// Logs every byte sent in the host event log, see Arduino.h, with the
+// thread that sent it.
+// ****************************************************************************
+
+#ifndef SPI_H
+#define SPI_H
+#pragma once
+
+// Include Files
+// ****************************************************************************
+#include "Arduino.h"
+
+// Constants
+// ****************************************************************************
+#define SPI_CLOCK_DIV2 0x00
+
+// Class
+// ****************************************************************************
+class SPIClass
+{
+public:
+	void begin() {}
+	void setClockDivider(uint32_t divider) { (void) divider; }
+	uint8_t transfer(uint8_t data)
+	{
+		hostLogEvent(HOST_SPI_BYTE, data);
+		return 0;
+	}
+	void writeBytes(const uint8_t *data, uint32_t length)
+	{
+		while (length--)
+		{
+			hostLogEvent(HOST_SPI_BYTE, *data++);
+		}
+	}
+};
+
+inline SPIClass &hostSpi()
+{
+	static SPIClass spi;
+	return spi;
+}
+
+#define SPI hostSpi()
+
+#endif
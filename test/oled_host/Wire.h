@@ -0,0 +1,82 @@
+// ****************************************************************************
+// Title		: Wire Stand-in
+// File Name	: 'Wire.h'
+// Target MCU	: Host (pio test -e native)
+//
+// Keeps every transmission ended with endTransmission(): the address and
+// the bytes written, in order.
+// ****************************************************************************
+
+#ifndef Wire_H
+#define Wire_H
+#pragma once
+
+// Include Files
+// ****************************************************************************
+#include "Arduino.h"
+
+// Types
+// ****************************************************************************
+struct HostTransmission
+{
+	uint8_t address;
+	std::vector<uint8_t> bytes;
+};
+
+// Class
+// ****************************************************************************
+class TwoWire
+{
+public:
+	std::vector<HostTransmission> transmissions;
+	uint32_t clock = 0;
+
+	void begin() {}
+	void begin(int sda, int scl)
+	{
+		(void) sda;
+		(void) scl;
+	}
+	void setClock(uint32_t frequency) { clock = frequency; }
+
+	void beginTransmission(uint8_t address)
+	{
+		_current.address = address;
+		_current.bytes.clear();
+	}
+	size_t write(uint8_t data)
+	{
+		_current.bytes.push_back(data);
+		return 1;
+	}
+	size_t write(const uint8_t *data, size_t length)
+	{
+		_current.bytes.insert(_current.bytes.end(), data, data + length);
+		return length;
+	}
+	uint8_t endTransmission()
+	{
+		transmissions.push_back(_current);
+		return 0;
+	}
+
+private:
+	HostTransmission _current;
+};
+
+inline TwoWire &hostWire()
+{
+	static TwoWire wire;
+	return wire;
+}
+
+inline TwoWire &hostWire1()
+{
+	static TwoWire wire;
+	return wire;
+}
+
+#define Wire hostWire()
+#define Wire1 hostWire1()
+
+#endif
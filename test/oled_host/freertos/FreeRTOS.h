@@ -0,0 +1,90 @@
+// ****************************************************************************
+// Title		: FreeRTOS Stand-in
+// File Name	: 'FreeRTOS.h'
+// Target MCU	: Host (pio test -e native)
+//
+// Tasks as threads, binary semaphores and task notifications, for the
+// OLED drivers' background transfers. Only waiting forever is supported.
+// Tests can hold every task at its next ulTaskNotifyTake() with
+// hostHoldTasks(), to check what happens before a task gets to run.
+// ****************************************************************************
+
+#ifndef FreeRTOS_H
+#define FreeRTOS_H
+#pragma once
+
+// Include Files
+// ****************************************************************************
+#include <stdint.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Constants and Types
+// ****************************************************************************
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void (*TaskFunction_t)(void *);
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS 1
+#define portMAX_DELAY ((TickType_t) 0xFFFFFFFF)
+
+struct HostTask
+{
+	std::thread thread;
+	uint32_t notifications = 0;
+	bool deleted = false;
+};
+
+struct HostSemaphore
+{
+	bool given = false;
+};
+
+typedef HostTask *TaskHandle_t;
+typedef HostSemaphore *SemaphoreHandle_t;
+
+// Shared State
+// ****************************************************************************
+// One lock for everything keeps the stand-in obviously right. They are
+// never destroyed, since a failed test leaves its tasks waiting on them.
+inline std::mutex &hostRtosLock()
+{
+	static std::mutex *lock = new std::mutex;
+	return *lock;
+}
+
+inline std::condition_variable &hostRtosChanged()
+{
+	static std::condition_variable *changed = new std::condition_variable;
+	return *changed;
+}
+
+inline bool &hostTasksHeld()
+{
+	static bool held = false;
+	return held;
+}
+
+inline HostTask *&hostCurrentTask()
+{
+	static thread_local HostTask *task = NULL;
+	return task;
+}
+
+// Thrown out of ulTaskNotifyTake() to end a deleted task's thread
+struct HostTaskDeleted
+{
+};
+
+inline void hostHoldTasks(bool held)
+{
+	std::lock_guard<std::mutex> guard(hostRtosLock());
+	hostTasksHeld() = held;
+	hostRtosChanged().notify_all();
+}
+
+#endif
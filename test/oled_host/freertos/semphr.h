@@ -0,0 +1,48 @@
+// ****************************************************************************
+// Title		: FreeRTOS Semaphore Stand-in
+// File Name	: 'semphr.h'
+// Target MCU	: Host (pio test -e native)
+// ****************************************************************************
+
+#ifndef FreeRTOS_semphr_H
+#define FreeRTOS_semphr_H
+#pragma once
+
+// Include Files
+// ****************************************************************************
+#include "FreeRTOS.h"
+
+// Functions
+// ****************************************************************************
+inline SemaphoreHandle_t xSemaphoreCreateBinary()
+{
+	return new HostSemaphore;
+}
+
+inline void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+	delete semaphore;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+	std::lock_guard<std::mutex> guard(hostRtosLock());
+	if (semaphore->given)
+	{
+		return pdFALSE;
+	}
+	semaphore->given = true;
+	hostRtosChanged().notify_all();
+	return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait)
+{
+	(void) ticksToWait;
+	std::unique_lock<std::mutex> guard(hostRtosLock());
+	hostRtosChanged().wait(guard, [semaphore]() { return semaphore->given; });
+	semaphore->given = false;
+	return pdTRUE;
+}
+
+#endif
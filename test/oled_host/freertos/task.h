@@ -0,0 +1,72 @@
+// ****************************************************************************
+// Title		: FreeRTOS Task Stand-in
+// File Name	: 'task.h'
+// Target MCU	: Host (pio test -e native)
+// ****************************************************************************
+
+#ifndef FreeRTOS_task_H
+#define FreeRTOS_task_H
+#pragma once
+
+// Include Files
+// ****************************************************************************
+#include "FreeRTOS.h"
+
+// Functions
+// ****************************************************************************
+inline BaseType_t xTaskCreate(TaskFunction_t function, const char *name, uint32_t stackDepth, void *parameters, UBaseType_t priority, TaskHandle_t *created)
+{
+	(void) name;
+	(void) stackDepth;
+	(void) priority;
+	HostTask *task = new HostTask;
+	task->thread = std::thread([task, function, parameters]()
+	{
+		hostCurrentTask() = task;
+		try
+		{
+			function(parameters);
+		}
+		catch (HostTaskDeleted &)
+		{
+		}
+	});
+	*created = task;
+	return pdPASS;
+}
+
+// Only deletes other tasks, and only while they wait for a notification
+inline void vTaskDelete(TaskHandle_t task)
+{
+	{
+		std::lock_guard<std::mutex> guard(hostRtosLock());
+		task->deleted = true;
+		hostRtosChanged().notify_all();
+	}
+	task->thread.join();
+	delete task;
+}
+
+inline void xTaskNotifyGive(TaskHandle_t task)
+{
+	std::lock_guard<std::mutex> guard(hostRtosLock());
+	task->notifications++;
+	hostRtosChanged().notify_all();
+}
+
+inline uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait)
+{
+	(void) ticksToWait;
+	HostTask *task = hostCurrentTask();
+	std::unique_lock<std::mutex> guard(hostRtosLock());
+	hostRtosChanged().wait(guard, [task]() { return task->deleted || (task->notifications && !hostTasksHeld()); });
+	if (task->deleted)
+	{
+		throw HostTaskDeleted();
+	}
+	uint32_t count = task->notifications;
+	task->notifications = clearOnExit ? 0 : count - 1;
+	return count;
+}
+
+#endif
@@ -0,0 +1,211 @@
+// ****************************************************************************
+// Title		: Button Events Tests
+// File Name	: 'test_button_events.cpp'
+// Target MCU	: Host (pio test -e native)
+//
+// Plays bouncing edge sequences into ButtonEvents as the pin interrupt
+// would, while a simulated loop calls update() at different rates, and
+// checks which events come out and when.
+// ****************************************************************************
+
+// Include Files
+// ****************************************************************************
+#include <unity.h>
+#include <vector>
+#include "button_events.h"
+
+// Helpers
+// ****************************************************************************
+struct Edge
+{
+	uint32_t time;	// µs
+	bool down;
+};
+
+// Contact bounce: the contact goes to down at the first offset from start,
+// in µs, and flips at each offset after that
+static void bounce(std::vector<Edge> &edges, uint32_t start, bool down, std::initializer_list<uint32_t> offsets)
+{
+	bool level = down;
+	for (uint32_t offset : offsets)
+	{
+		edges.push_back({start + offset, level});
+		level = !level;
+	}
+}
+
+// Run the edges through a ButtonEvents whose update() is called every
+// loopPeriod µs, until end
+static std::vector<ButtonEvent> simulate(const std::vector<Edge> &edges, uint32_t loopPeriod, uint32_t end)
+{
+	ButtonEvents buttons;
+	buttons.begin(0, false);
+	std::vector<ButtonEvent> events;
+	size_t next = 0;
+	bool level = false;
+	for (uint32_t now = loopPeriod; now <= end; now += loopPeriod)
+	{
+		while (next < edges.size() && edges[next].time <= now)
+		{
+			buttons.edge(edges[next].time, edges[next].down);
+			level = edges[next].down;
+			next++;
+		}
+		buttons.update(now, level);
+		ButtonEvent event;
+		while (buttons.read(event))
+		{
+			events.push_back(event);
+		}
+	}
+	return events;
+}
+
+static void assertEvents(const std::vector<ButtonEvent> &expected, const std::vector<ButtonEvent> &events)
+{
+	TEST_ASSERT_EQUAL(expected.size(), events.size());
+	for (size_t i = 0; i < expected.size(); i++)
+	{
+		TEST_ASSERT_EQUAL(expected[i].type, events[i].type);
+		TEST_ASSERT_EQUAL(expected[i].time, events[i].time);
+	}
+}
+
+// The same events, at the same times, whatever the loop rate
+static void assertAtEveryLoopRate(const std::vector<ButtonEvent> &expected, const std::vector<Edge> &edges, uint32_t end)
+{
+	const uint32_t loopPeriods[] = {1000, 7000, 50000, 300000};
+	for (uint32_t period : loopPeriods)
+	{
+		assertEvents(expected, simulate(edges, period, end));
+	}
+}
+
+// Tests
+// ****************************************************************************
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_bouncing_click(void)
+{
+	std::vector<Edge> edges;
+	// Down 300, up 400, down 800, up 500, then down for good at 2000: the
+	// integrator is at 300 by then, so it settles 9700 µs later
+	bounce(edges, 100000, true, {0, 300, 700, 1500, 2000});
+	// Up 200, down 300, which fills the integrator again, then up for good
+	bounce(edges, 300000, false, {0, 200, 500});
+
+	uint32_t pressed = 102000 + BUTTON_SETTLE_US - 300;
+	uint32_t released = 300500 + BUTTON_SETTLE_US;
+	assertAtEveryLoopRate({{BUTTON_PRESS, pressed}, {BUTTON_RELEASE, released}}, edges, 2000000);
+}
+
+void test_short_glitches_are_ignored(void)
+{
+	std::vector<Edge> edges;
+	for (uint32_t start = 100000; start < 200000; start += 20000)
+	{
+		bounce(edges, start, true, {0, BUTTON_SETTLE_US / 2});	// Down for half the settle time
+	}
+	assertAtEveryLoopRate({}, edges, 1000000);
+}
+
+void test_long_press(void)
+{
+	std::vector<Edge> edges;
+	bounce(edges, 100000, true, {0, 100, 200});
+	bounce(edges, 1500000, false, {0});
+
+	uint32_t pressed = 100200 + BUTTON_SETTLE_US;	// Down 100 then up 100 cancel out
+	assertAtEveryLoopRate({
+		{BUTTON_PRESS, pressed},
+		{BUTTON_LONG_PRESS, pressed + BUTTON_LONG_PRESS_US},
+		{BUTTON_RELEASE, 1500000 + BUTTON_SETTLE_US}
+	}, edges, 3000000);
+}
+
+void test_long_press_found_on_release(void)
+{
+	// Released just after the limit, before the slow loop looked again
+	std::vector<Edge> edges;
+	bounce(edges, 100000, true, {0});
+	uint32_t pressed = 100000 + BUTTON_SETTLE_US;
+	bounce(edges, pressed + BUTTON_LONG_PRESS_US - BUTTON_SETTLE_US + 1000, false, {0});
+	assertEvents({
+		{BUTTON_PRESS, pressed},
+		{BUTTON_LONG_PRESS, pressed + BUTTON_LONG_PRESS_US},
+		{BUTTON_RELEASE, pressed + BUTTON_LONG_PRESS_US + 1000}
+	}, simulate(edges, 2000000, 4000000));
+}
+
+void test_double_click(void)
+{
+	std::vector<Edge> edges;
+	bounce(edges, 100000, true, {0, 50, 120});
+	bounce(edges, 200000, false, {0});
+	bounce(edges, 450000, true, {0});	// 240 ms after the first release
+	bounce(edges, 550000, false, {0});
+	bounce(edges, 700000, true, {0});	// A third click starts over
+	bounce(edges, 800000, false, {0});
+
+	uint32_t firstPress = 100120 + BUTTON_SETTLE_US;
+	uint32_t secondPress = 450000 + BUTTON_SETTLE_US;
+	assertAtEveryLoopRate({
+		{BUTTON_PRESS, firstPress},
+		{BUTTON_RELEASE, 200000 + BUTTON_SETTLE_US},
+		{BUTTON_PRESS, secondPress},
+		{BUTTON_DOUBLE_CLICK, secondPress},
+		{BUTTON_RELEASE, 550000 + BUTTON_SETTLE_US},
+		{BUTTON_PRESS, 700000 + BUTTON_SETTLE_US},
+		{BUTTON_RELEASE, 800000 + BUTTON_SETTLE_US}
+	}, edges, 2000000);
+}
+
+void test_slow_second_click_is_not_double(void)
+{
+	std::vector<Edge> edges;
+	bounce(edges, 100000, true, {0});
+	bounce(edges, 200000, false, {0});
+	bounce(edges, 200000 + BUTTON_DOUBLE_CLICK_US + 1000, true, {0});
+	bounce(edges, 800000, false, {0});
+
+	std::vector<ButtonEvent> events = simulate(edges, 10000, 2000000);
+	TEST_ASSERT_EQUAL(4, events.size());
+	for (const ButtonEvent &event : events)
+	{
+		TEST_ASSERT_TRUE(event.type != BUTTON_DOUBLE_CLICK);
+	}
+}
+
+void test_edge_queue_overflow(void)
+{
+	// More bounces than the queue holds before the loop looks: the level
+	// read in update() still puts the button in the right state
+	std::vector<Edge> edges;
+	for (uint32_t i = 0; i < 200; i++)
+	{
+		edges.push_back({100000 + i * 10, (i & 1) == 0});
+	}
+	edges.push_back({102000, true});
+	std::vector<ButtonEvent> events = simulate(edges, 500000, 2000000);
+	TEST_ASSERT_TRUE(events.size() >= 1);
+	TEST_ASSERT_EQUAL(BUTTON_PRESS, events[0].type);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_bouncing_click);
+	RUN_TEST(test_short_glitches_are_ignored);
+	RUN_TEST(test_long_press);
+	RUN_TEST(test_long_press_found_on_release);
+	RUN_TEST(test_double_click);
+	RUN_TEST(test_slow_second_click_is_not_double);
+	RUN_TEST(test_edge_queue_overflow);
+	return UNITY_END();
+}
@@ -0,0 +1,169 @@
+// ****************************************************************************
+// Title		: LED State Tests
+// File Name	: 'test_led_state.cpp'
+// Target MCU	: Host (pio test -e native)
+//
+// Drives LedStateMachine through a scripted minute of mode, colour and
+// brightness changes, counting the refreshes (calls to FastLED.show() in
+// main.cpp) and checking when the LED is lit.
+// ****************************************************************************
+
+// Include Files
+// ****************************************************************************
+#include <unity.h>
+#include <stdio.h>
+#include <vector>
+#include "led_state.h"
+
+// Constants
+// ****************************************************************************
+const uint16_t BLINK_INTERVAL = 1000;	// As in main.cpp
+const uint32_t MINUTE = 60000;
+
+struct Refresh
+{
+	uint32_t time;
+	bool lit;
+};
+
+// Helpers
+// ****************************************************************************
+// What the loop asks for at time now, in ms
+static void script(uint32_t now, LEDState &mode, uint8_t &color, uint8_t &brightness)
+{
+	mode = now < 10000 ? ON : now < 40000 ? BLINK : now < 50000 ? OFF : ON;
+	color = now < 55000 ? 1 : 2;
+	brightness = now < 45000 ? 128 : 200;	// Changed while off: nothing to show
+}
+
+// Run the script with the loop coming round every loopPeriod ms
+static std::vector<Refresh> simulateMinute(uint32_t loopPeriod)
+{
+	LedStateMachine machine(BLINK_INTERVAL);
+	std::vector<Refresh> refreshes;
+	for (uint32_t now = 0; now < MINUTE; now += loopPeriod)
+	{
+		LEDState mode;
+		uint8_t color, brightness;
+		script(now, mode, color, brightness);
+		if (machine.update(now, mode, color, brightness))
+		{
+			refreshes.push_back({now, machine.lit()});
+		}
+	}
+	return refreshes;
+}
+
+// Tests
+// ****************************************************************************
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_refreshes_per_minute(void)
+{
+	std::vector<Refresh> refreshes = simulateMinute(1);
+
+	// On, blinking from 10 s with an edge every second until 39 s, off, on
+	// again, and the colour change at 55 s
+	std::vector<Refresh> expected;
+	expected.push_back({0, true});
+	for (uint32_t edge = 10000; edge < 40000; edge += BLINK_INTERVAL)
+	{
+		expected.push_back({edge, (edge / BLINK_INTERVAL) % 2 == 0});
+	}
+	expected.push_back({40000, false});
+	expected.push_back({50000, true});
+	expected.push_back({55000, true});
+
+	TEST_ASSERT_EQUAL(expected.size(), refreshes.size());
+	for (size_t i = 0; i < expected.size(); i++)
+	{
+		TEST_ASSERT_EQUAL(expected[i].time, refreshes[i].time);
+		TEST_ASSERT_EQUAL(expected[i].lit, refreshes[i].lit);
+	}
+
+	char message[80];
+	snprintf(message, sizeof(message), "%u show() calls in a simulated minute, against %u with a 1 ms loop",
+		(unsigned) refreshes.size(), (unsigned) MINUTE);
+	TEST_MESSAGE(message);
+}
+
+void test_same_refreshes_at_any_loop_rate(void)
+{
+	// Blink edges come from the schedule, so a slower loop only shows them
+	// late, never more or fewer of them
+	const uint32_t loopPeriods[] = {5, 20, 125, 200};
+	size_t expected = simulateMinute(1).size();
+	for (uint32_t period : loopPeriods)
+	{
+		std::vector<Refresh> refreshes = simulateMinute(period);
+		TEST_ASSERT_EQUAL(expected, refreshes.size());
+		for (const Refresh &refresh : refreshes)
+		{
+			if (refresh.time >= 10000 && refresh.time < 40000)
+			{
+				TEST_ASSERT_TRUE(refresh.time % BLINK_INTERVAL < period);
+			}
+		}
+	}
+}
+
+void test_next_wake(void)
+{
+	LedStateMachine machine(BLINK_INTERVAL);
+	TEST_ASSERT_TRUE(machine.update(0, ON, 0, 128));
+	TEST_ASSERT_FALSE(machine.hasWake());
+
+	TEST_ASSERT_TRUE(machine.update(500, BLINK, 0, 128));
+	TEST_ASSERT_TRUE(machine.hasWake());
+	TEST_ASSERT_EQUAL(1500, machine.nextWake());
+	TEST_ASSERT_FALSE(machine.update(1499, BLINK, 0, 128));
+	TEST_ASSERT_TRUE(machine.update(1500, BLINK, 0, 128));
+	TEST_ASSERT_FALSE(machine.lit());
+	TEST_ASSERT_EQUAL(2500, machine.nextWake());
+}
+
+void test_missed_edges_keep_the_phase(void)
+{
+	LedStateMachine machine(BLINK_INTERVAL);
+	machine.update(0, BLINK, 0, 128);
+	TEST_ASSERT_TRUE(machine.lit());
+
+	// Edges at 1000 and 2000 were missed: they cancel out, nothing to show
+	TEST_ASSERT_FALSE(machine.update(2100, BLINK, 0, 128));
+	TEST_ASSERT_TRUE(machine.lit());
+	TEST_ASSERT_EQUAL(3000, machine.nextWake());
+
+	// Three missed edges leave it dark
+	TEST_ASSERT_TRUE(machine.update(5500, BLINK, 0, 128));
+	TEST_ASSERT_FALSE(machine.lit());
+	TEST_ASSERT_EQUAL(6000, machine.nextWake());
+}
+
+void test_changes_while_dark(void)
+{
+	LedStateMachine machine(BLINK_INTERVAL);
+	machine.update(0, BLINK, 0, 128);
+	machine.update(1000, BLINK, 0, 128);
+	TEST_ASSERT_FALSE(machine.lit());
+	TEST_ASSERT_FALSE(machine.update(1100, BLINK, 3, 128));	// Picked up when it lights
+	TEST_ASSERT_TRUE(machine.update(2000, BLINK, 3, 128));
+	TEST_ASSERT_TRUE(machine.lit());
+	TEST_ASSERT_TRUE(machine.update(2100, BLINK, 3, 50));	// Lit: shows at once
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_refreshes_per_minute);
+	RUN_TEST(test_same_refreshes_at_any_loop_rate);
+	RUN_TEST(test_next_wake);
+	RUN_TEST(test_missed_edges_keep_the_phase);
+	RUN_TEST(test_changes_while_dark);
+	return UNITY_END();
+}
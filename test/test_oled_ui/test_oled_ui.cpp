@@ -0,0 +1,358 @@
+// ****************************************************************************
+// Title		: OLED UI Tests
+// File Name	: 'test_oled_ui.cpp'
+// Target MCU	: Host (pio test -e native)
+//
+// Runs two OLEDDisplayUi instances side by side on host displays, one
+// sliding transition snapshots and one calling the frame functions on
+// every tick, and checks that they leave the same pixels in the display
+// buffer on every tick of a transition, from a shift of 0 and 1 pixels to
+// one short of the full width or height. It also checks that change-driven
+// redraw only sends a frame when something has changed.
+// ****************************************************************************
+
+// Include Files
+// ****************************************************************************
+#include "Arduino.h"		// Host stand-in, must come first
+#include <unity.h>
+#include <stdio.h>
+#include "OLEDDisplayUi.h"
+
+// The native environment doesn't build libraries made for other
+// platforms, so the library sources are compiled in here
+#include "OLEDDisplay.cpp"
+#include "OLEDDisplayUi.cpp"
+
+// Constants
+// ****************************************************************************
+const uint16_t UPDATE_INTERVAL = 33;	// OLEDDisplayUi's default, 30 FPS
+const uint8_t FRAME_COUNT = 3;
+const uint8_t HIDDEN_INDICATOR_FRAME = 2;
+
+// Host Display
+// ****************************************************************************
+// Keeps what is drawn in its buffer and counts the calls to display()
+class HostDisplay : public OLEDDisplay
+{
+public:
+	HostDisplay(OLEDDISPLAY_GEOMETRY g = GEOMETRY_128_64) { setGeometry(g); }
+
+	uint32_t sent = 0;
+	void display(void) { sent++; }
+	uint16_t bufferSize() const { return displayBufferSize; }
+
+private:
+	int getBufferOffset(void) { return 0; }
+	bool connect() { return true; }
+};
+
+// Frames and Overlays
+// ****************************************************************************
+// Every frame covers its whole area with its own scatter of pixels and a
+// border, so that any pixel moved to the wrong place shows. The frame
+// calls are counted in the UI state's user data.
+static void drawPattern(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t x, int16_t y, uint8_t frame)
+{
+	(*(uint32_t *) state->userData)++;
+	for (int16_t py = 0; py < display->height(); py++)
+	{
+		for (int16_t px = 0; px < display->width(); px++)
+		{
+			uint32_t hash = (frame * 73856093UL) ^ (px * 19349663UL) ^ (py * 83492791UL);
+			if (((hash >> 7) & 3) == 0)
+			{
+				display->setPixel(x + px, y + py);
+			}
+		}
+	}
+	display->drawRect(x, y, display->width(), display->height());
+	if (frame == HIDDEN_INDICATOR_FRAME)
+	{
+		state->isIndicatorDrawn = false;
+	}
+}
+
+static void drawFrame0(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t x, int16_t y) { drawPattern(display, state, x, y, 0); }
+static void drawFrame1(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t x, int16_t y) { drawPattern(display, state, x, y, 1); }
+static void drawFrame2(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t x, int16_t y) { drawPattern(display, state, x, y, 2); }
+
+static FrameCallback frames[FRAME_COUNT] = { drawFrame0, drawFrame1, drawFrame2 };
+
+static void drawOverlay(OLEDDisplay *display, OLEDDisplayUiState *state)
+{
+	(void) state;
+	display->setColor(INVERSE);
+	display->fillRect(display->width() - 12, 2, 10, 10);
+	display->setColor(WHITE);
+}
+
+static OverlayCallback overlays[] = { drawOverlay };
+
+// What the changed callbacks report, and how often they were asked
+static bool frameChanged = false;
+static bool overlayChanged = false;
+static uint32_t changedCalls = 0;
+
+static bool isFrameChanged(OLEDDisplayUiState *state)
+{
+	(void) state;
+	changedCalls++;
+	return frameChanged;
+}
+
+static bool isOverlayChanged(OLEDDisplayUiState *state)
+{
+	(void) state;
+	changedCalls++;
+	return overlayChanged;
+}
+
+static ChangedCallback frameChangedCallbacks[FRAME_COUNT] = { isFrameChanged, isFrameChanged, NULL };
+static ChangedCallback overlayChangedCallbacks[] = { isOverlayChanged };
+
+// Helpers
+// ****************************************************************************
+static void setUpUi(OLEDDisplayUi &ui, AnimationDirection direction, int16_t travel, uint32_t *frameCalls)
+{
+	// Two ticks per pixel, so the shift starts at 0 on the first tick
+	ui.setTimePerTransition(2 * travel * UPDATE_INTERVAL);
+	ui.setFrameAnimation(direction);
+	ui.setFrames(frames, FRAME_COUNT);
+	ui.setOverlays(overlays, 1);
+	ui.disableAutoTransition();
+	ui.init();
+	ui.getUiState()->userData = frameCalls;
+}
+
+static void tick(OLEDDisplayUi &first, OLEDDisplayUi &second)
+{
+	hostMillis() += UPDATE_INTERVAL;
+	first.update();
+	second.update();
+}
+
+static void tick(OLEDDisplayUi &ui)
+{
+	hostMillis() += UPDATE_INTERVAL;
+	ui.update();
+}
+
+// Sets up a change-driven UI on frame 0 and draws it once
+static void setUpChangeDriven(OLEDDisplayUi &ui, uint32_t *frameCalls)
+{
+	hostMillis() = 0;
+	frameChanged = false;
+	overlayChanged = false;
+	changedCalls = 0;
+	setUpUi(ui, SLIDE_LEFT, 128, frameCalls);
+	ui.setFrameChangedCallbacks(frameChangedCallbacks);
+	ui.setOverlayChangedCallbacks(overlayChangedCallbacks);
+	ui.enableChangeDrivenRedraw();
+	tick(ui);
+}
+
+// Ticks the UI and checks whether it drew and sent a frame
+static void assertTick(OLEDDisplayUi &ui, HostDisplay &display, uint32_t *frameCalls, bool drawn)
+{
+	uint32_t sent = display.sent, calls = *frameCalls, skipped = ui.getSkippedFrames();
+	tick(ui);
+	TEST_ASSERT_EQUAL(sent + drawn, display.sent);
+	TEST_ASSERT_EQUAL(skipped + !drawn, ui.getSkippedFrames());
+	TEST_ASSERT_EQUAL(drawn, *frameCalls != calls);
+}
+
+static void compareTransition(OLEDDISPLAY_GEOMETRY geometry, AnimationDirection direction, uint8_t startFrame, bool backwards)
+{
+	HostDisplay callbackDisplay(geometry), snapshotDisplay(geometry);
+	OLEDDisplayUi callbackUi(&callbackDisplay), snapshotUi(&snapshotDisplay);
+	uint32_t callbackCalls = 0, snapshotCalls = 0;
+	bool sideways = direction == SLIDE_LEFT || direction == SLIDE_RIGHT;
+	int16_t travel = sideways ? callbackDisplay.width() : callbackDisplay.height();
+
+	hostMillis() = 0;
+	setUpUi(callbackUi, direction, travel, &callbackCalls);
+	setUpUi(snapshotUi, direction, travel, &snapshotCalls);
+	snapshotUi.enableTransitionSnapshots();
+	callbackUi.switchToFrame(startFrame);
+	snapshotUi.switchToFrame(startFrame);
+	tick(callbackUi, snapshotUi);
+
+	if (backwards)
+	{
+		callbackUi.previousFrame();
+		snapshotUi.previousFrame();
+	}
+	else
+	{
+		callbackUi.nextFrame();
+		snapshotUi.nextFrame();
+	}
+	callbackCalls = 0;
+	snapshotCalls = 0;
+
+	// Tick t shifts the frames by t / 2 pixels, 0 to travel - 1
+	char message[80];
+	for (int16_t t = 1; t < 2 * travel; t++)
+	{
+		tick(callbackUi, snapshotUi);
+		TEST_ASSERT_EQUAL(IN_TRANSITION, snapshotUi.getUiState()->frameState);
+		snprintf(message, sizeof(message), "direction %d, frame %u %s, shift %d", direction, startFrame, backwards ? "back" : "on", t / 2);
+		TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(callbackDisplay.buffer, snapshotDisplay.buffer, callbackDisplay.bufferSize(), message);
+		TEST_ASSERT_EQUAL_MESSAGE(callbackUi.getUiState()->isIndicatorDrawn, snapshotUi.getUiState()->isIndicatorDrawn, message);
+	}
+
+	// Both frames were drawn once for the snapshots, and on every tick otherwise
+	TEST_ASSERT_EQUAL(2, snapshotCalls);
+	TEST_ASSERT_EQUAL(2 * (2 * travel - 1), callbackCalls);
+}
+
+static void compareAllTransitions(OLEDDISPLAY_GEOMETRY geometry)
+{
+	const AnimationDirection directions[] = { SLIDE_UP, SLIDE_DOWN, SLIDE_LEFT, SLIDE_RIGHT };
+	for (AnimationDirection direction : directions)
+	{
+		compareTransition(geometry, direction, 0, false);		// indicator in both frames
+		compareTransition(geometry, direction, 0, true);		// slides the indicator out
+		compareTransition(geometry, direction, HIDDEN_INDICATOR_FRAME, false);	// and in
+	}
+}
+
+// Tests
+// ****************************************************************************
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_snapshots_match_callbacks_128x64(void)
+{
+	compareAllTransitions(GEOMETRY_128_64);
+}
+
+void test_snapshots_match_callbacks_64x48(void)
+{
+	// A narrower panel with 6 pages instead of 8
+	compareAllTransitions(GEOMETRY_64_48);
+}
+
+void test_unchanged_frames_are_skipped(void)
+{
+	HostDisplay display;
+	OLEDDisplayUi ui(&display);
+	uint32_t frameCalls = 0;
+	setUpChangeDriven(ui, &frameCalls);
+	TEST_ASSERT_EQUAL(0, ui.getSkippedFrames());
+
+	for (int i = 0; i < 10; i++)
+	{
+		assertTick(ui, display, &frameCalls, false);
+	}
+	TEST_ASSERT_EQUAL(10, ui.getSkippedFrames());
+	TEST_ASSERT_EQUAL(20, changedCalls);		// The frame's and the overlay's on every tick
+
+	// The screen is left as it was last drawn
+	HostDisplay expected;
+	OLEDDisplayUi expectedUi(&expected);
+	uint32_t expectedCalls = 0;
+	setUpUi(expectedUi, SLIDE_LEFT, 128, &expectedCalls);
+	tick(expectedUi);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expected.buffer, display.buffer, display.bufferSize());
+}
+
+void test_invalidate_redraws_once(void)
+{
+	HostDisplay display;
+	OLEDDisplayUi ui(&display);
+	uint32_t frameCalls = 0;
+	setUpChangeDriven(ui, &frameCalls);
+
+	ui.invalidate();
+	assertTick(ui, display, &frameCalls, true);
+	assertTick(ui, display, &frameCalls, false);
+}
+
+void test_changed_callbacks_redraw(void)
+{
+	HostDisplay display;
+	OLEDDisplayUi ui(&display);
+	uint32_t frameCalls = 0;
+	setUpChangeDriven(ui, &frameCalls);
+
+	frameChanged = true;
+	assertTick(ui, display, &frameCalls, true);
+	assertTick(ui, display, &frameCalls, true);
+	frameChanged = false;
+	assertTick(ui, display, &frameCalls, false);
+
+	overlayChanged = true;
+	assertTick(ui, display, &frameCalls, true);
+	overlayChanged = false;
+	assertTick(ui, display, &frameCalls, false);
+
+	// Frame 2 has no changed callback, so only the overlay's counts
+	ui.switchToFrame(2);
+	assertTick(ui, display, &frameCalls, true);
+	frameChanged = true;
+	assertTick(ui, display, &frameCalls, false);
+}
+
+void test_overlay_and_frame_changes_redraw(void)
+{
+	HostDisplay display;
+	OLEDDisplayUi ui(&display);
+	uint32_t frameCalls = 0;
+	setUpChangeDriven(ui, &frameCalls);
+
+	ui.setOverlays(overlays, 0);
+	assertTick(ui, display, &frameCalls, true);
+	assertTick(ui, display, &frameCalls, false);
+	ui.setOverlays(overlays, 1);
+	assertTick(ui, display, &frameCalls, true);
+	assertTick(ui, display, &frameCalls, false);
+
+	ui.switchToFrame(1);
+	assertTick(ui, display, &frameCalls, true);
+	assertTick(ui, display, &frameCalls, false);
+
+	// Transitions draw every tick, and the frame they end on is drawn once
+	ui.nextFrame();
+	for (int t = 1; t < 2 * 128; t++)
+	{
+		assertTick(ui, display, &frameCalls, true);
+	}
+	assertTick(ui, display, &frameCalls, true);
+	TEST_ASSERT_EQUAL(FIXED, ui.getUiState()->frameState);
+	TEST_ASSERT_EQUAL(2, ui.getUiState()->currentFrame);
+	assertTick(ui, display, &frameCalls, false);
+}
+
+void test_disabled_redraws_every_tick(void)
+{
+	HostDisplay display;
+	OLEDDisplayUi ui(&display);
+	uint32_t frameCalls = 0;
+	setUpChangeDriven(ui, &frameCalls);
+
+	assertTick(ui, display, &frameCalls, false);
+	ui.disableChangeDrivenRedraw();
+	for (int i = 0; i < 5; i++)
+	{
+		assertTick(ui, display, &frameCalls, true);
+	}
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_snapshots_match_callbacks_128x64);
+	RUN_TEST(test_snapshots_match_callbacks_64x48);
+	RUN_TEST(test_unchanged_frames_are_skipped);
+	RUN_TEST(test_invalidate_redraws_once);
+	RUN_TEST(test_changed_callbacks_redraw);
+	RUN_TEST(test_overlay_and_frame_changes_redraw);
+	RUN_TEST(test_disabled_redraws_every_tick);
+	return UNITY_END();
+}
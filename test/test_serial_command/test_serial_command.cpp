@@ -0,0 +1,279 @@
+// ****************************************************************************
+// Title		: Serial Command Tests
+// File Name	: 'test_serial_command.cpp'
+// Target MCU	: Host (pio test -e native)
+//
+// Checks the line reader, the text views and the command parser, and runs
+// a burst of commands through them the way processSerialInput() in main.cpp
+// does, counting heap allocations and timing each command.
+// ****************************************************************************
+
+// Include Files
+// ****************************************************************************
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include "serial_command.h"
+
+// Allocation Counting
+// ****************************************************************************
+static bool countAllocations = false;
+static uint32_t allocations = 0;
+
+#if defined(__GLIBC__)
+// Every heap allocation, including operator new, goes through malloc
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *malloc(size_t size)
+{
+	if (countAllocations)
+	{
+		allocations++;
+	}
+	return __libc_malloc(size);
+}
+#else
+// Elsewhere only operator new can be counted
+void *operator new(size_t size)
+{
+	if (countAllocations)
+	{
+		allocations++;
+	}
+	return malloc(size ? size : 1);
+}
+
+void operator delete(void *ptr) noexcept
+{
+	free(ptr);
+}
+#endif
+
+// Tests
+// ****************************************************************************
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+	countAllocations = false;
+}
+
+static bool feedText(SerialLineReader &reader, const char *text)
+{
+	bool complete = false;
+	while (*text)
+	{
+		complete = reader.feed(*text++);
+	}
+	return complete;
+}
+
+void test_trim_and_split(void)
+{
+	const char text[] = " \t top:Hello: there \r";
+	TextView line = {text, (uint8_t) strlen(text)};
+	TextView command, value;
+	TEST_ASSERT_TRUE(line.trim().split(':', command, value));
+	TEST_ASSERT_TRUE(command.equals("top"));
+	TEST_ASSERT_TRUE(value.equals("Hello: there"));
+	TEST_ASSERT_FALSE(command.equals("to"));
+	TEST_ASSERT_FALSE(command.equals("topper"));
+
+	// A view is compared by its length, not up to a NUL inside it
+	const char nul[] = "top\0x";
+	TextView withNul = {nul, 5};
+	TEST_ASSERT_FALSE(withNul.equals("top"));
+	TextView shorter = {nul, 3};
+	TEST_ASSERT_TRUE(shorter.equals("top"));
+	TextView none = {nul, 0};
+	TEST_ASSERT_TRUE(none.equals(""));
+	TEST_ASSERT_FALSE(none.equals("t"));
+
+	TextView empty = {text, 0};
+	TEST_ASSERT_FALSE(empty.split(':', command, value));
+	TEST_ASSERT_EQUAL(0, empty.trim().len);
+}
+
+void test_name_hash_matches_runtime(void)
+{
+	const char text[] = "Purple";
+	TextView view = {text, 6};
+	TEST_ASSERT_EQUAL_UINT32(NAME_HASH("Purple"), hashName(view));
+	static_assert(NAME_HASH("Red") != NAME_HASH("Green"), "distinct names hash apart");
+}
+
+void test_line_reader(void)
+{
+	SerialLineReader reader;
+	TEST_ASSERT_TRUE(reader.empty());
+	TEST_ASSERT_FALSE(feedText(reader, "color:Red\r"));
+	TEST_ASSERT_FALSE(reader.empty());
+	TEST_ASSERT_TRUE(reader.feed('\n'));
+	TEST_ASSERT_TRUE(reader.line().equals("color:Red"));
+	TEST_ASSERT_TRUE(reader.empty());
+	TEST_ASSERT_FALSE(reader.overflowed());
+
+	TEST_ASSERT_TRUE(feedText(reader, "top:\n"));	// The next line replaces it
+	TEST_ASSERT_TRUE(reader.line().equals("top:"));
+}
+
+void test_line_reader_overflow(void)
+{
+	SerialLineReader reader;
+	for (uint16_t i = 0; i < SERIAL_LINE_SIZE + 50; i++)
+	{
+		reader.feed('x');
+	}
+	TEST_ASSERT_TRUE(reader.feed('\n'));
+	TEST_ASSERT_TRUE(reader.overflowed());
+	TEST_ASSERT_EQUAL(SERIAL_LINE_SIZE, reader.line().len);
+
+	TEST_ASSERT_TRUE(feedText(reader, "bottom:ok\n"));	// Recovers on the next line
+	TEST_ASSERT_FALSE(reader.overflowed());
+	TEST_ASSERT_TRUE(reader.line().equals("bottom:ok"));
+}
+
+static SerialCommand parse(const char *text)
+{
+	TextView line = {text, (uint8_t) strlen(text)};
+	return parseSerialCommand(line);
+}
+
+void test_parse_lines(void)
+{
+	SerialCommand command = parse("  middle: Lab 03 ");
+	TEST_ASSERT_EQUAL(COMMAND_LINE, command.type);
+	TEST_ASSERT_EQUAL(MIDDLE, command.position);
+	TEST_ASSERT_TRUE(command.value.equals(" Lab 03"));	// Only the line is trimmed
+
+	TEST_ASSERT_EQUAL(TOP, parse("top:").position);
+	TEST_ASSERT_EQUAL(0, parse("top:").value.len);
+	TEST_ASSERT_EQUAL(BOTTOM, parse("bottom:a:b").position);
+	TEST_ASSERT_TRUE(parse("bottom:a:b").value.equals("a:b"));
+
+	TEST_ASSERT_EQUAL(COMMAND_UNKNOWN, parse("left:x").type);
+	TEST_ASSERT_EQUAL(COMMAND_UNKNOWN, parse("Top:x").type);
+	TEST_ASSERT_EQUAL(COMMAND_UNKNOWN, parse(":x").type);
+	TEST_ASSERT_EQUAL(COMMAND_MISSING_TEXT, parse("top Hello").type);
+	TEST_ASSERT_EQUAL(COMMAND_MISSING_TEXT, parse("").type);
+}
+
+void test_parse_colors(void)
+{
+	static const char *const names[] = { "Red", "Green", "Blue", "Yellow", "Cyan", "Purple", "Orange" };
+	char text[32];
+	for (uint8_t color = Red; color <= Orange; color++)
+	{
+		snprintf(text, sizeof(text), "color:%s", names[color]);
+		SerialCommand command = parse(text);
+		TEST_ASSERT_EQUAL(COMMAND_COLOR, command.type);
+		TEST_ASSERT_EQUAL(color, command.color);
+		TEST_ASSERT_TRUE(command.value.equals(names[color]));
+	}
+	TEST_ASSERT_EQUAL(COMMAND_BAD_COLOR, parse("color:Magenta").type);
+	TEST_ASSERT_EQUAL(COMMAND_BAD_COLOR, parse("color:red").type);
+	TEST_ASSERT_EQUAL(COMMAND_BAD_COLOR, parse("color:").type);
+	TEST_ASSERT_EQUAL(COMMAND_UNKNOWN, parse("colour:Red").type);
+
+	Color color = Blue;
+	TextView bad = {"Reddish", 7};
+	TEST_ASSERT_FALSE(getColorFromText(bad, color));
+	TEST_ASSERT_EQUAL(Blue, color);		// Left alone
+}
+
+void test_parse_telemetry(void)
+{
+	TEST_ASSERT_EQUAL(COMMAND_TELEMETRY, parse("telemetry:csv").type);
+	TEST_ASSERT_EQUAL(TELEMETRY_CSV, parse("telemetry:csv").mode);
+	TEST_ASSERT_EQUAL(TELEMETRY_BINARY, parse("telemetry:binary").mode);
+	TEST_ASSERT_EQUAL(TELEMETRY_OFF, parse(" telemetry:off \r").mode);
+	TEST_ASSERT_EQUAL(COMMAND_BAD_MODE, parse("telemetry:json").type);
+	TEST_ASSERT_EQUAL(COMMAND_BAD_MODE, parse("telemetry:").type);
+	TEST_ASSERT_EQUAL(COMMAND_UNKNOWN, parse("telemetr:csv").type);
+}
+
+void test_command_burst_without_allocations(void)
+{
+	static const char *const commands[] =
+	{
+		"top:Hello\n",
+		"  middle: Lab 03 \r\n",
+		"bottom:Bottom Line\n",
+		"color:Green\n",
+		"color:Orange\r\n",
+		"color:Magenta\n",
+		"colour:Red\n",
+		"telemetry:off\n",
+		"left:Nothing\n",
+		"no colon here\n",
+		"top:A line that is quite a lot longer than the others, to give the reader some work\n"
+	};
+	const uint8_t expected[] =
+	{
+		COMMAND_LINE, COMMAND_LINE, COMMAND_LINE, COMMAND_COLOR, COMMAND_COLOR,
+		COMMAND_BAD_COLOR, COMMAND_UNKNOWN, COMMAND_TELEMETRY, COMMAND_UNKNOWN, COMMAND_MISSING_TEXT,
+		COMMAND_LINE
+	};
+	const uint8_t COMMAND_KINDS = sizeof(commands) / sizeof(commands[0]);
+	const uint32_t COMMAND_COUNT = 22000;	// A whole number of rounds of the commands
+
+	SerialLineReader reader;
+	uint32_t lines = 0;
+	uint32_t errors = 0;
+	std::chrono::steady_clock::duration worst(0);
+
+	countAllocations = true;
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < COMMAND_COUNT; i++)
+	{
+		auto commandStart = std::chrono::steady_clock::now();
+		const char *text = commands[i % COMMAND_KINDS];
+		while (*text)
+		{
+			if (reader.feed(*text++))
+			{
+				SerialCommand command = parseSerialCommand(reader.line());
+				lines += command.type == COMMAND_LINE;
+				if (command.type != expected[i % COMMAND_KINDS])
+				{
+					errors++;
+				}
+			}
+		}
+		auto took = std::chrono::steady_clock::now() - commandStart;
+		if (took > worst)
+		{
+			worst = took;
+		}
+	}
+	double total = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	countAllocations = false;
+
+	char message[100];
+	snprintf(message, sizeof(message), "%u commands: %.3f us mean, %.1f us worst, %u allocations",
+		(unsigned) COMMAND_COUNT, total / COMMAND_COUNT,
+		std::chrono::duration<double, std::micro>(worst).count(), (unsigned) allocations);
+	TEST_MESSAGE(message);
+
+	TEST_ASSERT_EQUAL(0, allocations);
+	TEST_ASSERT_EQUAL(0, errors);
+	TEST_ASSERT_EQUAL(COMMAND_COUNT / COMMAND_KINDS * 4, lines);
+	TEST_ASSERT_LESS_OR_EQUAL(10.0, total / COMMAND_COUNT);	// Mean, in µs; a line is a few hundred instructions
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_trim_and_split);
+	RUN_TEST(test_name_hash_matches_runtime);
+	RUN_TEST(test_line_reader);
+	RUN_TEST(test_line_reader_overflow);
+	RUN_TEST(test_parse_lines);
+	RUN_TEST(test_parse_colors);
+	RUN_TEST(test_parse_telemetry);
+	RUN_TEST(test_command_burst_without_allocations);
+	return UNITY_END();
+}
@@ -0,0 +1,250 @@
+// ****************************************************************************
+// Title		: Serial Frame Tests
+// File Name	: 'test_serial_frame.cpp'
+// Target MCU	: Host (pio test -e native)
+//
+// Round trips random frames from FrameWriter through FrameDecoder, damages
+// them one bit at a time, walks random payloads with FieldReader, and
+// checks that the decoder drops stalled frames and finds the next one.
+// ****************************************************************************
+
+// Include Files
+// ****************************************************************************
+#include <unity.h>
+#include <string.h>
+#include <vector>
+#include "serial_frame.h"
+
+// Constants
+// ****************************************************************************
+const uint32_t ROUND_TRIPS = 20000;
+const uint32_t FIELD_PAYLOADS = 100000;
+
+// Helpers
+// ****************************************************************************
+static uint32_t randomState = 1;
+
+static uint32_t randomNumber(void)
+{
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 17;
+	randomState ^= randomState << 5;
+	return randomState;
+}
+
+// Write a frame of random fields; the fields are also kept in payload
+static void randomFrame(FrameWriter &writer, std::vector<uint8_t> &payload)
+{
+	writer.begin(FRAME_UPDATE, randomNumber());
+	payload.clear();
+	uint8_t fields = randomNumber() % 8;
+	for (uint8_t i = 0; i < fields; i++)
+	{
+		uint8_t data[64];
+		uint8_t length = randomNumber() % sizeof(data);
+		for (uint8_t j = 0; j < length; j++)
+		{
+			data[j] = randomNumber();
+		}
+		uint8_t field = randomNumber();
+		if (writer.addField(field, data, length))
+		{
+			payload.push_back(field);
+			payload.push_back(length);
+			payload.insert(payload.end(), data, data + length);
+		}
+	}
+	writer.finish();
+}
+
+// Feed a whole frame; returns the state after the last byte
+static FrameState feedAll(FrameDecoder &decoder, const uint8_t *data, uint16_t size, uint32_t now)
+{
+	FrameState state = FRAME_PENDING;
+	for (uint16_t i = 0; i < size; i++)
+	{
+		FrameState byteState = decoder.feed(data[i], now);
+		if (byteState != FRAME_PENDING && i != size - 1)
+		{
+			return FRAME_ERROR;	// Ended early
+		}
+		state = byteState;
+	}
+	return state;
+}
+
+// Tests
+// ****************************************************************************
+void setUp(void)
+{
+	randomState = 1;
+}
+
+void tearDown(void)
+{
+}
+
+void test_crc_check_value(void)
+{
+	const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+	TEST_ASSERT_EQUAL_HEX16(0x29B1, frameCrc(check, sizeof(check)));	// CRC-16/CCITT-FALSE
+}
+
+void test_round_trip(void)
+{
+	FrameWriter writer;
+	FrameDecoder decoder;
+	std::vector<uint8_t> payload;
+	for (uint32_t i = 0; i < ROUND_TRIPS; i++)
+	{
+		randomFrame(writer, payload);
+		TEST_ASSERT_EQUAL(FRAME_HEADER_SIZE + payload.size() + 2, writer.size());
+		TEST_ASSERT_EQUAL(FRAME_READY, feedAll(decoder, writer.data(), writer.size(), i));
+		TEST_ASSERT_EQUAL(FRAME_UPDATE, decoder.type());
+		TEST_ASSERT_EQUAL(writer.data()[3], decoder.seq());
+		TEST_ASSERT_EQUAL(payload.size(), decoder.length());
+		TEST_ASSERT_TRUE(payload.empty() || memcmp(payload.data(), decoder.payload(), payload.size()) == 0);
+	}
+}
+
+void test_writer_refuses_long_payload(void)
+{
+	FrameWriter writer;
+	uint8_t data[200] = {0};
+	writer.begin(FRAME_UPDATE, 0);
+	TEST_ASSERT_TRUE(writer.addField(FIELD_TOP, data, 200));
+	TEST_ASSERT_FALSE(writer.addField(FIELD_MIDDLE, data, 60));	// 202 + 62 > 255
+	TEST_ASSERT_TRUE(writer.addField(FIELD_MIDDLE, data, 51));	// Exactly 255
+	TEST_ASSERT_FALSE(writer.addRaw(data, 1));
+	writer.finish();
+
+	FrameDecoder decoder;
+	TEST_ASSERT_EQUAL(FRAME_READY, feedAll(decoder, writer.data(), writer.size(), 0));
+	TEST_ASSERT_EQUAL(255, decoder.length());
+}
+
+// Every single-bit error in TYPE, SEQ, the payload or the CRC is caught.
+// LENGTH is left alone: a damaged LENGTH moves where the CRC is read from,
+// which a CRC can only catch with odds of 65535 in 65536.
+void test_single_bit_errors_are_detected(void)
+{
+	FrameWriter writer;
+	FrameDecoder decoder;
+	std::vector<uint8_t> payload;
+	uint32_t now = 0;
+	uint32_t flips = 0;
+	for (uint32_t i = 0; i < 500; i++)
+	{
+		randomFrame(writer, payload);
+		uint8_t frame[FRAME_MAX_SIZE];
+		uint16_t size = writer.size();
+		for (uint16_t byte = 2; byte < size; byte++)
+		{
+			for (uint8_t bit = 0; bit < 8; bit++)
+			{
+				memcpy(frame, writer.data(), size);
+				frame[byte] ^= 1 << bit;
+				TEST_ASSERT_EQUAL(FRAME_ERROR, feedAll(decoder, frame, size, now++));
+				flips++;
+			}
+		}
+	}
+	TEST_ASSERT_GREATER_OR_EQUAL(100000, flips);
+}
+
+void test_field_reader_stays_in_payload(void)
+{
+	for (uint32_t i = 0; i < FIELD_PAYLOADS; i++)
+	{
+		// Exactly the payload's size, so a sanitizer also sees any overrun
+		uint8_t length = randomNumber();
+		std::vector<uint8_t> payload(length);
+		for (uint8_t j = 0; j < length; j++)
+		{
+			payload[j] = randomNumber() % 16;	// Small lengths, so many fields fit
+		}
+		const uint8_t *start = payload.data();
+		FieldReader reader(start, length);
+		uint8_t field, fieldLength;
+		const uint8_t *data;
+		const uint8_t *expected = start;
+		while (reader.next(field, data, fieldLength))
+		{
+			TEST_ASSERT_TRUE(data == expected + 2);
+			TEST_ASSERT_TRUE(data + fieldLength <= start + length);
+			expected = data + fieldLength;
+		}
+		// Either every byte was a field, or the rest was reported as malformed
+		TEST_ASSERT_TRUE(reader.error() == (expected != start + length));
+		TEST_ASSERT_FALSE(reader.next(field, data, fieldLength));
+	}
+}
+
+void test_field_reader_truncated_header(void)
+{
+	const uint8_t payload[] = {FIELD_COLOR, 1, 3, FIELD_MODE};
+	FieldReader reader(payload, sizeof(payload));
+	uint8_t field, length;
+	const uint8_t *data;
+	TEST_ASSERT_TRUE(reader.next(field, data, length));
+	TEST_ASSERT_EQUAL(FIELD_COLOR, field);
+	TEST_ASSERT_EQUAL(3, data[0]);
+	TEST_ASSERT_FALSE(reader.next(field, data, length));
+	TEST_ASSERT_TRUE(reader.error());
+}
+
+void test_timeout_and_resync(void)
+{
+	FrameWriter writer;
+	writer.begin(FRAME_QUERY, 42);
+	writer.finish();
+	FrameDecoder decoder;
+
+	// Noise before the sync byte is skipped
+	const uint8_t noise[] = {'t', 'o', 'p', 0x00, 0xFF};
+	TEST_ASSERT_EQUAL(FRAME_PENDING, feedAll(decoder, noise, sizeof(noise), 0));
+	TEST_ASSERT_FALSE(decoder.busy(0));
+
+	// A frame that stalls part way is still waited for up to the timeout...
+	TEST_ASSERT_EQUAL(FRAME_PENDING, feedAll(decoder, writer.data(), 3, 1000));
+	TEST_ASSERT_TRUE(decoder.busy(1000 + FRAME_TIMEOUT_MS));
+
+	// ...and then dropped, so the next frame is read from its own sync byte
+	uint32_t later = 1000 + FRAME_TIMEOUT_MS + 1;
+	TEST_ASSERT_EQUAL(FRAME_READY, feedAll(decoder, writer.data(), writer.size(), later));
+	TEST_ASSERT_EQUAL(42, decoder.seq());
+
+	// Without the gap the stalled bytes would have swallowed the next frame
+	feedAll(decoder, writer.data(), 3, 2000);
+	FrameState state = FRAME_PENDING;
+	for (uint16_t i = 0; i < writer.size(); i++)
+	{
+		state = decoder.feed(writer.data()[i], 2000);
+		if (state != FRAME_PENDING)
+		{
+			break;
+		}
+	}
+	TEST_ASSERT_EQUAL(FRAME_ERROR, state);
+
+	// After a damaged frame the decoder looks for a sync byte again
+	decoder.reset();
+	uint8_t damaged[FRAME_MAX_SIZE];
+	memcpy(damaged, writer.data(), writer.size());
+	damaged[writer.size() - 1] ^= 0x01;
+	TEST_ASSERT_EQUAL(FRAME_ERROR, feedAll(decoder, damaged, writer.size(), 3000));
+	TEST_ASSERT_EQUAL(FRAME_READY, feedAll(decoder, writer.data(), writer.size(), 3000));
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_crc_check_value);
+	RUN_TEST(test_round_trip);
+	RUN_TEST(test_writer_refuses_long_payload);
+	RUN_TEST(test_single_bit_errors_are_detected);
+	RUN_TEST(test_field_reader_stays_in_payload);
+	RUN_TEST(test_field_reader_truncated_header);
+	RUN_TEST(test_timeout_and_resync);
+	return UNITY_END();
+}
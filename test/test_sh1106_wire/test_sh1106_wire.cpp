@@ -0,0 +1,268 @@
+// ****************************************************************************
+// Title		: SH1106 Wire Tests
+// File Name	: 'test_sh1106_wire.cpp'
+// Target MCU	: Host (pio test -e native)
+//
+// Drives SH1106Wire through the Wire stand-in. The transmissions are
+// checked exactly for a few known changes, and for random frames they are
+// played into a model of the SH1106's 132 column RAM, which must then hold
+// the display buffer just as the whole-screen refresh would leave it.
+// Panels taller than the controller's 8 pages only send those 8.
+// ****************************************************************************
+
+// Include Files
+// ****************************************************************************
+#include "Arduino.h"		// Host stand-in, must come first
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "SH1106Wire.h"
+
+// The native environment doesn't build libraries made for other
+// platforms, so the library sources are compiled in here
+#include "OLEDDisplay.cpp"
+
+// Constants
+// ****************************************************************************
+const uint8_t ADDRESS = 0x3c;
+const uint8_t WIDTH = 128;
+const uint8_t RAM_COLUMNS = 132;
+const uint8_t COLUMN_OFFSET = 2;	// The panel sits in the middle of the RAM
+const int RANDOM_FRAMES = 200;
+
+// Helpers
+// ****************************************************************************
+// A panel taller than the controller, to check the page bound
+class TallSH1106Wire : public SH1106Wire
+{
+public:
+	TallSH1106Wire() : SH1106Wire(ADDRESS)
+	{
+		setGeometry(GEOMETRY_RAWMODE, WIDTH, 96);
+	}
+};
+
+// The SH1106's RAM in page addressing mode, fed the transmissions. Each
+// starts with a control byte: 0x80 for one command, 0x00 for a stream of
+// commands, 0x40 for a stream of data.
+struct RamModel
+{
+	uint8_t ram[RAM_COLUMNS * SH1106_PAGES];
+	uint8_t page;
+	uint8_t column;
+
+	RamModel() : page(0), column(0)
+	{
+		memset(ram, 0, sizeof(ram));	// As init() leaves the panel's columns
+	}
+
+	void play(const std::vector<HostTransmission> &transmissions)
+	{
+		for (const HostTransmission &transmission : transmissions)
+		{
+			TEST_ASSERT_EQUAL_HEX8(ADDRESS, transmission.address);
+			TEST_ASSERT_TRUE(transmission.bytes.size() >= 2);
+			uint8_t control = transmission.bytes[0];
+			if (control == 0x40)
+			{
+				TEST_ASSERT_LESS_OR_EQUAL(1 + I2C_OLED_TRANSFER_BYTE, transmission.bytes.size());
+				for (size_t i = 1; i < transmission.bytes.size(); i++)
+				{
+					TEST_ASSERT_TRUE_MESSAGE(column < RAM_COLUMNS, "data past the last column");
+					ram[column++ + page * RAM_COLUMNS] = transmission.bytes[i];
+				}
+			}
+			else
+			{
+				TEST_ASSERT_TRUE(control == 0x00 || (control == 0x80 && transmission.bytes.size() == 2));
+				for (size_t i = 1; i < transmission.bytes.size(); i++)
+				{
+					command(transmission.bytes[i]);
+				}
+			}
+		}
+	}
+
+	void command(uint8_t c)
+	{
+		if (c >= 0xB0 && c < 0xB0 + SH1106_PAGES)
+		{
+			page = c - 0xB0;
+		}
+		else if (c < 0x10)
+		{
+			column = (column & 0xF0) | c;
+		}
+		else if (c < 0x20)
+		{
+			column = (column & 0x0F) | ((c & 0x0F) << 4);
+		}
+	}
+
+	void assertPanel(const OLEDDisplay &display, uint8_t pages)
+	{
+		for (uint8_t y = 0; y < pages; y++)
+		{
+			TEST_ASSERT_EQUAL_UINT8_ARRAY(display.buffer + y * WIDTH, ram + COLUMN_OFFSET + y * RAM_COLUMNS, WIDTH);
+		}
+	}
+};
+
+// Expected transmissions for columns firstX..lastX of page y
+static void expectPage(std::vector<HostTransmission> &expected, const OLEDDisplay &display, uint8_t y, uint8_t firstX, uint8_t lastX)
+{
+	uint8_t column = firstX + COLUMN_OFFSET;
+	expected.push_back(HostTransmission{ADDRESS, {0x00, (uint8_t) (0xB0 + y), (uint8_t) (column & 0x0F), (uint8_t) (0x10 | (column >> 4))}});
+	for (uint16_t x = firstX; x <= lastX; x += I2C_OLED_TRANSFER_BYTE)
+	{
+		uint16_t end = x + I2C_OLED_TRANSFER_BYTE - 1 < lastX ? x + I2C_OLED_TRANSFER_BYTE - 1 : lastX;
+		HostTransmission data{ADDRESS, {0x40}};
+		data.bytes.insert(data.bytes.end(), display.buffer + y * WIDTH + x, display.buffer + y * WIDTH + end + 1);
+		expected.push_back(data);
+	}
+}
+
+static void assertTransmissions(const std::vector<HostTransmission> &expected)
+{
+	const std::vector<HostTransmission> &actual = Wire.transmissions;
+	TEST_ASSERT_EQUAL(expected.size(), actual.size());
+	char message[48];
+	for (size_t i = 0; i < expected.size(); i++)
+	{
+		snprintf(message, sizeof(message), "transmission %u", (unsigned) i);
+		TEST_ASSERT_EQUAL_MESSAGE(expected[i].address, actual[i].address, message);
+		TEST_ASSERT_EQUAL_MESSAGE(expected[i].bytes.size(), actual[i].bytes.size(), message);
+		TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(expected[i].bytes.data(), actual[i].bytes.data(), expected[i].bytes.size(), message);
+	}
+}
+
+// Draws a few random boxes and pixels, sometimes clearing first
+static void drawRandom(OLEDDisplay &display)
+{
+	if (rand() % 8 == 0)
+	{
+		display.clear();
+	}
+	int boxes = rand() % 4;
+	for (int i = 0; i < boxes; i++)
+	{
+		display.setColor((OLEDDISPLAY_COLOR) (rand() % 3));
+		display.fillRect(rand() % WIDTH, rand() % display.height(), 1 + rand() % 40, 1 + rand() % 24);
+	}
+	int pixels = rand() % 6;
+	display.setColor(INVERSE);
+	for (int i = 0; i < pixels; i++)
+	{
+		display.setPixel(rand() % WIDTH, rand() % display.height());
+	}
+	display.setColor(WHITE);
+}
+
+static void startDisplay(OLEDDisplay &display)
+{
+	TEST_ASSERT_TRUE(display.init());
+	Wire.transmissions.clear();
+}
+
+// Tests
+// ****************************************************************************
+void setUp(void)
+{
+	srand(1);
+	Wire.transmissions.clear();
+}
+
+void tearDown(void)
+{
+}
+
+void test_unchanged_frame_sends_nothing(void)
+{
+	SH1106Wire display(ADDRESS);
+	startDisplay(display);
+	display.display();
+	TEST_ASSERT_EQUAL(0, Wire.transmissions.size());
+}
+
+void test_changed_columns_are_sent_per_page(void)
+{
+	SH1106Wire display(ADDRESS);
+	startDisplay(display);
+
+	// 31 columns go as a command and two data transmissions; the last
+	// column needs the high column nibble
+	display.fillRect(10, 8, 31, 3);		// page 1, columns 10-40
+	display.setPixel(WIDTH - 1, 50);	// page 6, column 127
+	display.display();
+
+	std::vector<HostTransmission> expected;
+	expectPage(expected, display, 1, 10, 40);
+	expectPage(expected, display, 6, WIDTH - 1, WIDTH - 1);
+	assertTransmissions(expected);
+}
+
+void test_first_frame_refreshes_everything(void)
+{
+	// init() sends every page whole, as the whole-screen refresh did
+	SH1106Wire display(ADDRESS);
+	TEST_ASSERT_TRUE(display.init());
+	std::vector<HostTransmission> sent = Wire.transmissions;
+
+	Wire.transmissions.clear();
+	std::vector<HostTransmission> expected;
+	for (uint8_t y = 0; y < SH1106_PAGES; y++)
+	{
+		expectPage(expected, display, y, 0, WIDTH - 1);
+	}
+	TEST_ASSERT_TRUE(sent.size() >= expected.size());
+	Wire.transmissions.assign(sent.end() - expected.size(), sent.end());
+	assertTransmissions(expected);
+}
+
+void test_random_frames_reach_the_ram(void)
+{
+	SH1106Wire display(ADDRESS);
+	startDisplay(display);
+	RamModel model;
+
+	for (int frame = 0; frame < RANDOM_FRAMES; frame++)
+	{
+		drawRandom(display);
+		display.display();
+		model.play(Wire.transmissions);
+		Wire.transmissions.clear();
+		model.assertPanel(display, SH1106_PAGES);
+	}
+}
+
+void test_taller_panel_sends_only_the_controller_pages(void)
+{
+	TallSH1106Wire display;
+	startDisplay(display);
+	RamModel model;
+
+	// Below the controller's pages nothing is sent
+	display.fillRect(0, 8 * SH1106_PAGES, WIDTH, 16);
+	display.display();
+	TEST_ASSERT_EQUAL(0, Wire.transmissions.size());
+
+	for (int frame = 0; frame < RANDOM_FRAMES; frame++)
+	{
+		drawRandom(display);
+		display.display();
+		model.play(Wire.transmissions);
+		Wire.transmissions.clear();
+		model.assertPanel(display, SH1106_PAGES);
+	}
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_unchanged_frame_sends_nothing);
+	RUN_TEST(test_changed_columns_are_sent_per_page);
+	RUN_TEST(test_first_frame_refreshes_everything);
+	RUN_TEST(test_random_frames_reach_the_ram);
+	RUN_TEST(test_taller_panel_sends_only_the_controller_pages);
+	return UNITY_END();
+}
@@ -0,0 +1,235 @@
+// ****************************************************************************
+// Title		: SPSC Queue Tests
+// File Name	: 'test_spsc_queue.cpp'
+// Target MCU	: Host (pio test -e native)
+//
+// A producer and a consumer thread pass numbered items through one queue,
+// one at a time and in random batches, and the consumer checks that every
+// item arrives once and in order. The benchmark reports items per second.
+// Either side yields when the queue is full or empty, so the tests also
+// finish on a single core.
+// ****************************************************************************
+
+// Include Files
+// ****************************************************************************
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+#include <thread>
+#include "spsc_queue.h"
+
+// Constants
+// ****************************************************************************
+const uint32_t STRESS_ITEMS = 2000000;
+const uint32_t BENCHMARK_ITEMS = 10000000;
+const uint16_t MAX_BATCH = 64;
+
+struct Item
+{
+	uint32_t seq;
+	uint32_t check;		// Derived from seq, to catch torn items
+};
+
+static SpscQueue<Item, 256> itemQueue;
+static SpscQueue<uint32_t, 1024> wordQueue;
+
+// Helpers
+// ****************************************************************************
+static uint32_t checkOf(uint32_t seq)
+{
+	return seq * 2654435761UL;
+}
+
+static uint16_t randomBatch(uint32_t &state)
+{
+	state = state * 1103515245UL + 12345;
+	return 1 + (state >> 16) % MAX_BATCH;
+}
+
+// Tests
+// ****************************************************************************
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_capacity_is_all_slots(void)
+{
+	SpscQueue<uint8_t, 8> queue;
+	TEST_ASSERT_TRUE(queue.empty());
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		TEST_ASSERT_TRUE(queue.push(i));
+	}
+	TEST_ASSERT_FALSE(queue.push(8));
+	TEST_ASSERT_EQUAL(8, queue.size());
+
+	uint8_t items[16];
+	TEST_ASSERT_EQUAL(8, queue.pop(items, 16));
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		TEST_ASSERT_EQUAL(i, items[i]);
+	}
+	TEST_ASSERT_FALSE(queue.pop(items[0]));
+}
+
+void test_partial_batch_push(void)
+{
+	SpscQueue<uint8_t, 4> queue;
+	uint8_t items[6] = {1, 2, 3, 4, 5, 6};
+	TEST_ASSERT_EQUAL(4, queue.push(items, 6));
+	TEST_ASSERT_EQUAL(0, queue.push(items, 1));
+	uint8_t item;
+	TEST_ASSERT_TRUE(queue.pop(item));
+	TEST_ASSERT_EQUAL(1, item);
+	TEST_ASSERT_EQUAL(1, queue.push(items + 4, 2));	// Wraps around
+	uint8_t rest[4];
+	TEST_ASSERT_EQUAL(4, queue.pop(rest, 4));
+	TEST_ASSERT_EQUAL(2, rest[0]);
+	TEST_ASSERT_EQUAL(5, rest[3]);
+}
+
+void test_two_threads_single_items(void)
+{
+	std::thread producer([]
+	{
+		for (uint32_t seq = 0; seq < STRESS_ITEMS;)
+		{
+			Item item = {seq, checkOf(seq)};
+			if (itemQueue.push(item))
+			{
+				seq++;
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	uint32_t errors = 0;
+	for (uint32_t next = 0; next < STRESS_ITEMS;)
+	{
+		Item item;
+		if (!itemQueue.pop(item))
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		if (item.seq != next || item.check != checkOf(next))
+		{
+			errors++;
+		}
+		next++;
+	}
+	producer.join();
+
+	TEST_ASSERT_EQUAL(0, errors);
+	TEST_ASSERT_TRUE(itemQueue.empty());
+}
+
+void test_two_threads_random_batches(void)
+{
+	std::thread producer([]
+	{
+		uint32_t items[MAX_BATCH];
+		uint32_t state = 1;
+		for (uint32_t seq = 0; seq < STRESS_ITEMS;)
+		{
+			uint16_t count = randomBatch(state);
+			if (count > STRESS_ITEMS - seq)
+			{
+				count = STRESS_ITEMS - seq;
+			}
+			for (uint16_t i = 0; i < count; i++)
+			{
+				items[i] = seq + i;
+			}
+			uint16_t pushed = wordQueue.push(items, count);
+			seq += pushed;
+			if (pushed < count)
+			{
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	uint32_t errors = 0;
+	uint32_t items[MAX_BATCH];
+	uint32_t state = 7;
+	for (uint32_t next = 0; next < STRESS_ITEMS;)
+	{
+		uint16_t count = wordQueue.pop(items, randomBatch(state));
+		if (count == 0)
+		{
+			std::this_thread::yield();
+		}
+		for (uint16_t i = 0; i < count; i++, next++)
+		{
+			if (items[i] != next)
+			{
+				errors++;
+			}
+		}
+	}
+	producer.join();
+
+	TEST_ASSERT_EQUAL(0, errors);
+	TEST_ASSERT_TRUE(wordQueue.empty());
+}
+
+void test_benchmark_throughput(void)
+{
+	uint32_t received = 0;
+	auto start = std::chrono::steady_clock::now();
+	std::thread producer([]
+	{
+		uint32_t items[MAX_BATCH];
+		for (uint32_t seq = 0; seq < BENCHMARK_ITEMS;)
+		{
+			uint16_t count = BENCHMARK_ITEMS - seq < MAX_BATCH ? BENCHMARK_ITEMS - seq : MAX_BATCH;
+			for (uint16_t i = 0; i < count; i++)
+			{
+				items[i] = seq + i;
+			}
+			uint16_t pushed = wordQueue.push(items, count);
+			seq += pushed;
+			if (pushed < count)
+			{
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	uint32_t items[MAX_BATCH];
+	while (received < BENCHMARK_ITEMS)
+	{
+		uint16_t count = wordQueue.pop(items, MAX_BATCH);
+		if (count == 0)
+		{
+			std::this_thread::yield();
+		}
+		received += count;
+	}
+	producer.join();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	char message[80];
+	snprintf(message, sizeof(message), "SpscQueue: %.1f M items/s in batches of %u", BENCHMARK_ITEMS / seconds / 1e6, MAX_BATCH);
+	TEST_MESSAGE(message);
+	TEST_ASSERT_EQUAL(BENCHMARK_ITEMS, received);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_capacity_is_all_slots);
+	RUN_TEST(test_partial_batch_push);
+	RUN_TEST(test_two_threads_single_items);
+	RUN_TEST(test_two_threads_random_batches);
+	RUN_TEST(test_benchmark_throughput);
+	return UNITY_END();
+}
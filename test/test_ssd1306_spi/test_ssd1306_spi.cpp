@@ -0,0 +1,379 @@
+// ****************************************************************************
+// Title		: SSD1306 SPI Tests
+// File Name	: 'test_ssd1306_spi.cpp'
+// Target MCU	: Host (pio test -e native)
+//
+// Drives SSD1306Spi through the SPI and GPIO stand-ins, built as for the
+// ESP32 so that the queued transfer is in. The logged pin writes and bytes
+// are checked exactly for a few known changes, and for random frames they
+// are played into a model of the controller's RAM, which must then match
+// the display buffer. The queued transfer must send the same, from its
+// task, and only once display() has returned.
+// ****************************************************************************
+
+// Include Files
+// ****************************************************************************
+#define ARDUINO_ARCH_ESP32	// Bulk writes and the queued transfer
+#include "Arduino.h"		// Host stand-in, must come first
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <thread>
+#include "SSD1306Spi.h"
+
+// The native environment doesn't build libraries made for other
+// platforms, so the library sources are compiled in here
+#include "OLEDDisplay.cpp"
+
+// Constants
+// ****************************************************************************
+const uint8_t PIN_RST = 4;
+const uint8_t PIN_DC = 5;
+const uint8_t PIN_CS = 6;
+const uint8_t NO_CS = (uint8_t) -1;
+const uint8_t WIDTH = 128;
+const uint8_t PAGES = 8;
+const int RANDOM_FRAMES = 200;
+
+// Helpers
+// ****************************************************************************
+// Expected events; writes to the CS pin are left out without one
+static void expectPin(std::vector<HostEvent> &expected, uint8_t pin, uint8_t level)
+{
+	if (pin != NO_CS)
+	{
+		expected.push_back(HostEvent{pin, level, std::thread::id()});
+	}
+}
+
+static void expectByte(std::vector<HostEvent> &expected, uint8_t b)
+{
+	expected.push_back(HostEvent{HOST_SPI_BYTE, b, std::thread::id()});
+}
+
+// A run of bytes with DC at the given level, the way writeCommands() and
+// sendRegion() frame them
+static void expectStart(std::vector<HostEvent> &expected, uint8_t cs, uint8_t dc)
+{
+	expectPin(expected, cs, HIGH);
+	expectPin(expected, PIN_DC, dc);
+	expectPin(expected, cs, LOW);
+}
+
+// The address window and the data of one region, as sendRegion() sends them
+static void expectRegion(std::vector<HostEvent> &expected, const SSD1306Spi &display, uint8_t cs, uint8_t firstX, uint8_t lastX, uint8_t firstY, uint8_t lastY)
+{
+	const uint8_t window[] = { COLUMNADDR, firstX, lastX, PAGEADDR, firstY, lastY };
+	expectStart(expected, cs, LOW);
+	for (uint8_t b : window)
+	{
+		expectByte(expected, b);
+	}
+	expectPin(expected, cs, HIGH);
+
+	expectStart(expected, cs, HIGH);
+	for (uint8_t y = firstY; y <= lastY; y++)
+	{
+		for (uint8_t x = firstX; x <= lastX; x++)
+		{
+			expectByte(expected, display.buffer[x + y * WIDTH]);
+		}
+	}
+	expectPin(expected, cs, HIGH);
+}
+
+static void assertEvents(const std::vector<HostEvent> &expected, const std::vector<HostEvent> &actual)
+{
+	TEST_ASSERT_EQUAL(expected.size(), actual.size());
+	char message[48];
+	for (size_t i = 0; i < expected.size(); i++)
+	{
+		snprintf(message, sizeof(message), "event %u", (unsigned) i);
+		TEST_ASSERT_EQUAL_MESSAGE(expected[i].pin, actual[i].pin, message);
+		TEST_ASSERT_EQUAL_MESSAGE(expected[i].value, actual[i].value, message);
+	}
+}
+
+// The controller's RAM in horizontal addressing mode, fed the logged
+// events. Bytes only count while CS is low, and DC must not change then.
+struct RamModel
+{
+	uint8_t ram[WIDTH * PAGES];
+	bool cs;			// Level of CS, low for good without a CS pin
+	bool dc;
+	uint8_t command[3];
+	uint8_t commandLength;
+	uint8_t firstX, lastX, firstY, lastY, x, y;
+
+	RamModel(bool hasCs) : cs(hasCs), dc(LOW), commandLength(0), firstX(0), lastX(WIDTH - 1), firstY(0), lastY(PAGES - 1), x(0), y(0)
+	{
+		memset(ram, 0, sizeof(ram));	// As init() leaves it
+	}
+
+	void play(const std::vector<HostEvent> &events)
+	{
+		for (const HostEvent &event : events)
+		{
+			if (event.pin == PIN_CS)
+			{
+				cs = event.value;
+			}
+			else if (event.pin == PIN_DC)
+			{
+				TEST_ASSERT_TRUE_MESSAGE(cs, "DC changed while CS was low");
+				dc = event.value;
+			}
+			else if (event.pin == HOST_SPI_BYTE)
+			{
+				TEST_ASSERT_FALSE_MESSAGE(cs, "byte sent while CS was high");
+				if (dc)
+				{
+					data(event.value);
+				}
+				else
+				{
+					commandByte(event.value);
+				}
+			}
+		}
+	}
+
+	void commandByte(uint8_t b)
+	{
+		command[commandLength++] = b;
+		if (command[0] != COLUMNADDR && command[0] != PAGEADDR)
+		{
+			commandLength = 0;		// Nothing else changes the address
+		}
+		else if (commandLength == 3)
+		{
+			if (command[0] == COLUMNADDR)
+			{
+				firstX = x = command[1];
+				lastX = command[2];
+			}
+			else
+			{
+				firstY = y = command[1];
+				lastY = command[2];
+			}
+			commandLength = 0;
+		}
+	}
+
+	void data(uint8_t b)
+	{
+		TEST_ASSERT_EQUAL_MESSAGE(0, commandLength, "data before the end of a command");
+		ram[x + y * WIDTH] = b;
+		if (x++ == lastX)
+		{
+			x = firstX;
+			y = (y == lastY) ? firstY : y + 1;
+		}
+	}
+};
+
+// Draws a few random boxes and pixels, sometimes clearing first
+static void drawRandom(SSD1306Spi &display)
+{
+	if (rand() % 8 == 0)
+	{
+		display.clear();
+	}
+	int boxes = rand() % 4;
+	for (int i = 0; i < boxes; i++)
+	{
+		display.setColor((OLEDDISPLAY_COLOR) (rand() % 3));
+		display.fillRect(rand() % WIDTH, rand() % 64, 1 + rand() % 40, 1 + rand() % 24);
+	}
+	int pixels = rand() % 6;
+	display.setColor(INVERSE);
+	for (int i = 0; i < pixels; i++)
+	{
+		display.setPixel(rand() % WIDTH, rand() % 64);
+	}
+	display.setColor(WHITE);
+}
+
+static void startDisplay(SSD1306Spi &display)
+{
+	TEST_ASSERT_TRUE(display.init());
+	hostEvents().clear();
+}
+
+// Tests
+// ****************************************************************************
+void setUp(void)
+{
+	srand(1);
+	hostHoldTasks(false);
+	hostEvents().clear();
+}
+
+void tearDown(void)
+{
+}
+
+void test_unchanged_frame_sends_nothing(void)
+{
+	SSD1306Spi display(PIN_RST, PIN_DC, PIN_CS);
+	startDisplay(display);
+	display.display();
+	TEST_ASSERT_EQUAL(0, hostEvents().size());
+}
+
+void test_changed_columns_are_sent_as_regions(void)
+{
+	SSD1306Spi display(PIN_RST, PIN_DC, PIN_CS);
+	startDisplay(display);
+
+	// Pages 1 and 2 are adjacent, so they go as one region covering the
+	// columns changed in either; page 5 goes on its own
+	display.fillRect(10, 8, 11, 2);		// page 1, columns 10-20
+	display.fillRect(15, 20, 16, 1);	// page 2, columns 15-30
+	display.setPixel(100, 47);			// page 5, column 100
+	display.display();
+
+	std::vector<HostEvent> expected;
+	expectRegion(expected, display, PIN_CS, 10, 30, 1, 2);
+	expectRegion(expected, display, PIN_CS, 100, 100, 5, 5);
+	assertEvents(expected, hostEvents());
+}
+
+void test_whole_pages_are_sent_in_one_run(void)
+{
+	SSD1306Spi display(PIN_RST, PIN_DC, PIN_CS);
+	startDisplay(display);
+
+	display.setPixel(0, 24);			// page 3, first column
+	display.setPixel(WIDTH - 1, 39);	// page 4, last column
+	display.display();
+
+	std::vector<HostEvent> expected;
+	expectRegion(expected, display, PIN_CS, 0, WIDTH - 1, 3, 4);
+	assertEvents(expected, hostEvents());
+}
+
+void test_without_cs_pin(void)
+{
+	SSD1306Spi display(PIN_RST, PIN_DC, NO_CS);
+	startDisplay(display);
+
+	display.fillRect(60, 0, 8, 8);
+	display.fillRect(0, 56, 4, 8);
+	display.display();
+
+	std::vector<HostEvent> expected;
+	expectRegion(expected, display, NO_CS, 60, 67, 0, 0);
+	expectRegion(expected, display, NO_CS, 0, 3, 7, 7);
+	assertEvents(expected, hostEvents());
+}
+
+void test_random_frames_reach_the_ram(void)
+{
+	SSD1306Spi display(PIN_RST, PIN_DC, PIN_CS);
+	startDisplay(display);
+	RamModel model(true);
+
+	for (int frame = 0; frame < RANDOM_FRAMES; frame++)
+	{
+		drawRandom(display);
+		display.display();
+		model.play(hostEvents());
+		hostEvents().clear();
+		TEST_ASSERT_EQUAL_UINT8_ARRAY(display.buffer, model.ram, sizeof(model.ram));
+	}
+}
+
+void test_queued_transfer_sends_the_same_from_its_task(void)
+{
+	SSD1306Spi direct(PIN_RST, PIN_DC, PIN_CS), queued(PIN_RST, PIN_DC, PIN_CS);
+	startDisplay(direct);
+	startDisplay(queued);
+	queued.setQueuedTransfer(true);
+	RamModel model(true);
+
+	for (int frame = 0; frame < RANDOM_FRAMES; frame++)
+	{
+		drawRandom(direct);
+		memcpy(queued.buffer, direct.buffer, WIDTH * PAGES);
+		direct.display();
+		std::vector<HostEvent> expected = hostEvents();
+		hostEvents().clear();
+
+		// Nothing is sent before display() returns
+		hostHoldTasks(true);
+		queued.display();
+		TEST_ASSERT_EQUAL(0, hostEvents().size());
+		hostHoldTasks(false);
+		queued.waitForTransfer();
+
+		assertEvents(expected, hostEvents());
+		for (const HostEvent &event : hostEvents())
+		{
+			TEST_ASSERT_TRUE(event.thread != std::this_thread::get_id());
+		}
+		model.play(hostEvents());
+		hostEvents().clear();
+		TEST_ASSERT_EQUAL_UINT8_ARRAY(queued.buffer, model.ram, sizeof(model.ram));
+	}
+}
+
+void test_command_waits_for_queued_transfer(void)
+{
+	SSD1306Spi display(PIN_RST, PIN_DC, PIN_CS);
+	startDisplay(display);
+	display.setQueuedTransfer(true);
+
+	display.fillRect(0, 0, WIDTH, 64);
+	hostHoldTasks(true);
+	display.display();
+	std::thread release([]()
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		hostHoldTasks(false);
+	});
+	display.displayOff();		// Blocks until the frame has been sent
+	release.join();
+
+	std::vector<HostEvent> expected;
+	expectRegion(expected, display, PIN_CS, 0, WIDTH - 1, 0, PAGES - 1);
+	expectStart(expected, PIN_CS, LOW);
+	expectByte(expected, DISPLAYOFF);
+	expectPin(expected, PIN_CS, HIGH);
+	assertEvents(expected, hostEvents());
+	TEST_ASSERT_TRUE(hostEvents().back().thread == std::this_thread::get_id());
+}
+
+void test_back_to_direct_transfer(void)
+{
+	SSD1306Spi display(PIN_RST, PIN_DC, PIN_CS);
+	startDisplay(display);
+	display.setQueuedTransfer(true);
+	display.setQueuedTransfer(false);
+
+	// The task is still there, but display() sends before returning
+	hostHoldTasks(true);
+	display.setPixel(5, 5);
+	display.display();
+	std::vector<HostEvent> expected;
+	expectRegion(expected, display, PIN_CS, 5, 5, 0, 0);
+	assertEvents(expected, hostEvents());
+	TEST_ASSERT_TRUE(hostEvents().back().thread == std::this_thread::get_id());
+	hostHoldTasks(false);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_unchanged_frame_sends_nothing);
+	RUN_TEST(test_changed_columns_are_sent_as_regions);
+	RUN_TEST(test_whole_pages_are_sent_in_one_run);
+	RUN_TEST(test_without_cs_pin);
+	RUN_TEST(test_random_frames_reach_the_ram);
+	RUN_TEST(test_queued_transfer_sends_the_same_from_its_task);
+	RUN_TEST(test_command_waits_for_queued_transfer);
+	RUN_TEST(test_back_to_direct_transfer);
+	return UNITY_END();
+}
@@ -0,0 +1,214 @@
+// ****************************************************************************
+// Title		: Telemetry Tests
+// File Name	: 'test_telemetry.cpp'
+// Target MCU	: Host (pio test -e native)
+//
+// Checks the CSV and binary reports, the rate limit and the dropped count,
+// and measures what add() and a report cost per call.
+// ****************************************************************************
+
+// Include Files
+// ****************************************************************************
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "telemetry.h"
+
+// Constants
+// ****************************************************************************
+const int32_t ADS1115_MICROVOLTS = 188;	// Per bit at the default gain, rounded
+
+// Helpers
+// ****************************************************************************
+static void assertReport(const char *expected, Telemetry &telemetry, uint16_t length)
+{
+	TEST_ASSERT_EQUAL(strlen(expected), length);
+	TEST_ASSERT_EQUAL_STRING_LEN(expected, (const char *) telemetry.data(), length);
+}
+
+static uint32_t readLittleEndian(const uint8_t *data, uint8_t bytes)
+{
+	uint32_t value = 0;
+	while (bytes--)
+	{
+		value = (value << 8) | data[bytes];
+	}
+	return value;
+}
+
+// Tests
+// ****************************************************************************
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_csv_report(void)
+{
+	Telemetry telemetry;
+	telemetry.setScale(ADS1115_MICROVOLTS);
+	telemetry.add(100);
+	telemetry.add(-20);
+	telemetry.add(250);
+	TEST_ASSERT_EQUAL(0, telemetry.poll(TELEMETRY_INTERVAL - 1, 100));	// Not due yet
+
+	// mean 110, 110 * 188 uV = 0.020680 V
+	assertReport("Analog0,250,3,-20,110,250,0.021,0\n", telemetry, telemetry.poll(TELEMETRY_INTERVAL, 100));
+	TEST_ASSERT_EQUAL(0, telemetry.poll(TELEMETRY_INTERVAL * 2, 100));	// Empty window
+}
+
+void test_csv_volts_rounding_and_sign(void)
+{
+	Telemetry telemetry;
+	telemetry.setScale(1000);
+	telemetry.add(-2);	// -2 mV
+	assertReport("Analog0,250,1,-2,-2,-2,-0.002,0\n", telemetry, telemetry.poll(250, 100));
+
+	telemetry.setScale(1);
+	telemetry.add(-400);	// -0.4 mV rounds to zero, without a sign
+	assertReport("Analog0,500,1,-400,-400,-400,0.000,0\n", telemetry, telemetry.poll(500, 100));
+
+	telemetry.setScale(1000000);
+	telemetry.add(12);
+	assertReport("Analog0,750,1,12,12,12,12.000,0\n", telemetry, telemetry.poll(750, 100));
+}
+
+void test_csv_longest_report(void)
+{
+	Telemetry telemetry;
+	telemetry.setScale(65536);	// -32768 * 65536 uV is INT32_MIN
+	telemetry.add(-32768);
+	telemetry.poll(250, 0);	// No room: one sample dropped
+	for (uint16_t i = 0; i < UINT16_MAX; i++)
+	{
+		telemetry.add(-32768);
+	}
+	uint32_t now = UINT32_MAX;
+	uint16_t length = telemetry.poll(now, TELEMETRY_CSV_SIZE);
+	assertReport("Analog0,4294967295,65535,-32768,-32768,-32768,-2147.484,1\n", telemetry, length);
+	TEST_ASSERT_LESS_OR_EQUAL(TELEMETRY_CSV_SIZE, length);
+}
+
+void test_binary_report(void)
+{
+	Telemetry telemetry;
+	telemetry.setMode(TELEMETRY_BINARY);
+	telemetry.setScale(ADS1115_MICROVOLTS);
+	telemetry.add(-5);
+	telemetry.add(15);
+	uint16_t length = telemetry.poll(1000, 100);
+	TEST_ASSERT_EQUAL(FRAME_HEADER_SIZE + 20 + 2, length);
+
+	FrameDecoder decoder;
+	FrameState state = FRAME_PENDING;
+	for (uint16_t i = 0; i < length; i++)
+	{
+		state = decoder.feed(telemetry.data()[i], 0);
+	}
+	TEST_ASSERT_EQUAL(FRAME_READY, state);
+	TEST_ASSERT_EQUAL(FRAME_TELEMETRY, decoder.type());
+	TEST_ASSERT_EQUAL(20, decoder.length());
+
+	const uint8_t *payload = decoder.payload();
+	TEST_ASSERT_EQUAL(1000, readLittleEndian(payload, 4));
+	TEST_ASSERT_EQUAL(2, readLittleEndian(payload + 4, 2));
+	TEST_ASSERT_EQUAL(-5, (int16_t) readLittleEndian(payload + 6, 2));
+	TEST_ASSERT_EQUAL(5, (int16_t) readLittleEndian(payload + 8, 2));
+	TEST_ASSERT_EQUAL(15, (int16_t) readLittleEndian(payload + 10, 2));
+	TEST_ASSERT_EQUAL(5 * ADS1115_MICROVOLTS, (int32_t) readLittleEndian(payload + 12, 4));
+	TEST_ASSERT_EQUAL(0, readLittleEndian(payload + 16, 4));
+}
+
+void test_dropped_when_no_room(void)
+{
+	Telemetry telemetry;
+	for (uint8_t i = 0; i < 10; i++)
+	{
+		telemetry.add(i);
+	}
+	TEST_ASSERT_EQUAL(0, telemetry.poll(250, 10));	// The UART only has room for 10 bytes
+	TEST_ASSERT_EQUAL(10, telemetry.dropped());
+
+	telemetry.add(1);
+	assertReport("Analog0,500,1,1,1,1,0.000,10\n", telemetry, telemetry.poll(500, 100));
+
+	telemetry.setMode(TELEMETRY_OFF);	// Not reporting is not dropping
+	telemetry.add(1);
+	TEST_ASSERT_EQUAL(0, telemetry.poll(750, 100));
+	TEST_ASSERT_EQUAL(10, telemetry.dropped());
+}
+
+void test_dropped_before_add(void)
+{
+	Telemetry telemetry;
+	telemetry.addDropped(3);	// e.g. a full sample queue
+	telemetry.addDropped(0);
+	telemetry.add(7);
+	assertReport("Analog0,250,1,7,7,7,0.000,3\n", telemetry, telemetry.poll(250, 100));
+	TEST_ASSERT_EQUAL(3, telemetry.dropped());
+}
+
+void test_interval(void)
+{
+	Telemetry telemetry;
+	telemetry.setInterval(1000);
+	telemetry.add(1);
+	TEST_ASSERT_EQUAL(0, telemetry.poll(999, 100));
+	TEST_ASSERT_TRUE(telemetry.poll(1000, 100) > 0);
+	telemetry.add(1);
+	TEST_ASSERT_EQUAL(0, telemetry.poll(1999, 100));
+	TEST_ASSERT_TRUE(telemetry.poll(2000, 100) > 0);
+}
+
+void test_cost_per_call(void)
+{
+	const uint32_t SAMPLES = 10000000;
+	const uint32_t REPORTS = 1000000;
+	Telemetry telemetry;
+	telemetry.setScale(ADS1115_MICROVOLTS);
+	volatile uint32_t sink = 0;	// Keeps the reports from being optimised away
+
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < SAMPLES; i++)
+	{
+		telemetry.add((int16_t) (i * 7919));
+	}
+	double addNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / SAMPLES;
+
+	double reportNs[2];
+	for (uint8_t mode = 0; mode < 2; mode++)
+	{
+		telemetry.setMode(mode == 0 ? TELEMETRY_CSV : TELEMETRY_BINARY);
+		start = std::chrono::steady_clock::now();
+		for (uint32_t i = 1; i <= REPORTS; i++)
+		{
+			telemetry.add((int16_t) i);
+			sink += telemetry.poll(i * TELEMETRY_INTERVAL, 100);
+		}
+		reportNs[mode] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / REPORTS;
+	}
+
+	char message[100];
+	snprintf(message, sizeof(message), "Telemetry: add() %.1f ns, CSV report %.1f ns, binary report %.1f ns",
+		addNs, reportNs[0], reportNs[1]);
+	TEST_MESSAGE(message);
+	TEST_ASSERT_TRUE(sink > 0);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_csv_report);
+	RUN_TEST(test_csv_volts_rounding_and_sign);
+	RUN_TEST(test_csv_longest_report);
+	RUN_TEST(test_binary_report);
+	RUN_TEST(test_dropped_when_no_room);
+	RUN_TEST(test_dropped_before_add);
+	RUN_TEST(test_interval);
+	RUN_TEST(test_cost_per_call);
+	return UNITY_END();
+}